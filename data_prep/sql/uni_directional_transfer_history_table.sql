@@ -22,7 +22,8 @@ native_eth AS (
     SELECT
         address,
         counterparty,
-        sum(abs(amount) * b.price) AS eth_transfer_usd
+        sum(abs(amount) * b.price) AS eth_transfer_usd,
+        min(date(a.block_timestamp)) AS first_seen
     FROM
         native_eth_transfer a
         LEFT JOIN `circle-ds-pipelines.kyc_paper.cgc_daily_eth_close` b ON date(a.block_timestamp) = date(b.snapped_at)
@@ -36,7 +37,8 @@ wrapped_eth AS (
     SELECT
         address,
         counterparty,
-        sum(abs(amount) * b.price) AS weth_transfer_usd
+        sum(abs(amount) * b.price) AS weth_transfer_usd,
+        min(date(a.block_timestamp)) AS first_seen
     FROM
         `circle-ds-pipelines.ethereum.fct_token_transfers` a
         LEFT JOIN `circle-ds-pipelines.kyc_paper.cgc_daily_eth_close` b ON date(a.block_timestamp) = date(b.snapped_at)
@@ -52,7 +54,8 @@ stables AS (
     SELECT
         address,
         counterparty,
-        sum(abs(amount)) AS stables_transfer_usd
+        sum(abs(amount)) AS stables_transfer_usd,
+        min(date(a.block_timestamp)) AS first_seen
     FROM
         `circle-ds-pipelines.ethereum.fct_token_transfers` a
     WHERE
@@ -78,7 +81,15 @@ gnosis AS (
 SELECT
     coalesce(a.address, b.address, c.address) AS address,
     coalesce(a.counterparty, b.counterparty, c.counterparty) AS counterparty,
-    coalesce(a.eth_transfer_usd, 0) + coalesce(b.weth_transfer_usd, 0) + coalesce(c.stables_transfer_usd, 0) AS total_transfer_usd
+    coalesce(a.eth_transfer_usd, 0) + coalesce(b.weth_transfer_usd, 0) + coalesce(c.stables_transfer_usd, 0) AS total_transfer_usd,
+    -- Date of the pair's first transfer. total_transfer_usd covers the whole history, so "uni_graph windows"
+    -- counts a pair from this date even if it only passed the 10 USD dust filter later, and its weight is
+    -- the final total at every cutoff. Exact cutoffs need one row per pair and period instead.
+    least(
+        coalesce(a.first_seen, DATE '9999-12-31'),
+        coalesce(b.first_seen, DATE '9999-12-31'),
+        coalesce(c.first_seen, DATE '9999-12-31')
+    ) AS first_seen
 FROM
     native_eth a FULL
     OUTER JOIN wrapped_eth b ON a.address = b.address
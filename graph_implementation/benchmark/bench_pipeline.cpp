@@ -0,0 +1,570 @@
+#include "benchmark/benchmark.h"
+#include "chunk_loader.hpp"
+#include "compressed_graph.hpp"
+#include "graph_snapshot.hpp"
+#include "hop_output.hpp"
+#include "incremental_bfs.hpp"
+#include "multi_source_bfs.hpp"
+#include "neighborhood_sketch.hpp"
+#include "rmat_generator.hpp"
+#include "risk_propagation.hpp"
+#include "semi_external_bfs.hpp"
+#include "vertex_order.hpp"
+#include <random>
+#include <sys/stat.h>
+
+/*
+Benchmarks of every pipeline phase on a synthetic R-MAT transfer graph.
+EAI_BENCH_SCALE sets the graph size (2^scale vertices, 8 transfers per vertex, default 16;
+24 is about the real data) and EAI_BENCH_DIR where the chunks are generated (default /tmp).
+The data is generated once per process and shared by all benchmarks.
+*/
+
+namespace
+{
+    // Discards the progress logging of the pipeline while a benchmark runs
+    class MutedOutput
+    {
+    public:
+        MutedOutput() : saved_(std::cout.rdbuf(nullptr)) {}
+        ~MutedOutput()
+        {
+            std::cout.rdbuf(saved_);
+            std::cout.clear();
+        }
+
+    private:
+        std::streambuf *saved_;
+    };
+
+    std::string environment_or(const char *name, const std::string &fallback)
+    {
+        const char *value = getenv(name);
+        return value && *value ? std::string(value) : fallback;
+    }
+
+    // Synthetic data set and the graph loaded from it
+    struct BenchData
+    {
+        RMATParams params;
+        std::string directory;
+        std::vector<std::string> chunk_files;
+        std::string kyc_filename;
+        size_t chunk_bytes = 0;
+        size_t chunk_lines = 0;
+        size_t kyc_lines = 0;
+        AddressInterner interner;
+        CSRGraph graph, reverse;
+        std::vector<VertexId> seeds;
+
+        BenchData()
+        {
+            params.scale = static_cast<uint32_t>(std::stoul(environment_or("EAI_BENCH_SCALE", "16")));
+            directory = environment_or("EAI_BENCH_DIR", "/tmp") + "/eai_bench_" + std::to_string(params.scale) + "_";
+            MutedOutput muted;
+            chunk_files = write_rmat_chunks(directory + "transfers_", params);
+            kyc_filename = directory + "kyc.csv";
+            kyc_lines = write_rmat_kyc(kyc_filename, params, 64);
+            for (const std::string &chunk_filename : chunk_files)
+            {
+                struct stat file_stat;
+                if (stat(chunk_filename.c_str(), &file_stat) == 0)
+                {
+                    chunk_bytes += static_cast<size_t>(file_stat.st_size);
+                }
+            }
+            chunk_lines = (size_t(1) << params.scale) * params.edge_factor;
+            build_graph_from_chunks(chunk_files, graph, reverse, interner);
+            seeds = read_kyc_addr(kyc_filename, interner);
+        }
+
+        ~BenchData()
+        {
+            for (const std::string &chunk_filename : chunk_files)
+            {
+                std::remove(chunk_filename.c_str());
+            }
+            std::remove(kyc_filename.c_str());
+        }
+    };
+
+    BenchData &bench_data()
+    {
+        static BenchData data;
+        return data;
+    }
+
+    // Transfers per second and input MB/s of a parsing benchmark
+    void set_line_counters(benchmark::State &state, size_t lines, size_t bytes)
+    {
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * lines));
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+        state.counters["lines_per_second"] = benchmark::Counter(static_cast<double>(state.iterations() * lines), benchmark::Counter::kIsRate);
+    }
+
+    // Whole-traversal and per-level edges traversed per second (TEPS) of the last run
+    void set_bfs_counters(benchmark::State &state, const std::vector<BFSLevelStats> &stats, size_t total_edges)
+    {
+        state.counters["edges_per_second"] = benchmark::Counter(static_cast<double>(state.iterations() * total_edges), benchmark::Counter::kIsRate);
+        for (const BFSLevelStats &level : stats)
+        {
+            const std::string prefix = "L" + std::to_string(level.level) + (level.bottom_up ? "_bu" : "_td");
+            state.counters[prefix + "_frontier"] = static_cast<double>(level.frontier_size);
+            state.counters[prefix + "_MTEPS"] = level.seconds > 0 ? level.edges_scanned / level.seconds / 1e6 : 0.0;
+            // Slowest thread over the average one; close to 1 when the edges are evenly shared
+            if (level.mean_busy_seconds > 0)
+            {
+                state.counters[prefix + "_busy_imbalance"] = level.max_busy_seconds / level.mean_busy_seconds;
+            }
+        }
+    }
+
+    /*
+    A frontier dominated by hub wallets: `hubs` vertices with hub_degree out-edges each, then
+    2^20 ordinary vertices with 4 out-edges, all to random targets. The seeds are the hubs and
+    every 64th ordinary vertex.
+    */
+    struct HubGraph
+    {
+        CSRGraph graph, reverse;
+        std::vector<VertexId> seeds;
+
+        HubGraph(size_t hubs, uint64_t hub_degree)
+        {
+            const size_t ordinary = size_t(1) << 20;
+            const size_t n = hubs + ordinary;
+            graph.offsets.resize(n + 1);
+            graph.offsets[0] = 0;
+            for (size_t v = 0; v < n; ++v)
+            {
+                graph.offsets[v + 1] = graph.offsets[v] + (v < hubs ? hub_degree : 4);
+            }
+            graph.neighbors.resize(graph.offsets[n]);
+            std::mt19937_64 random(1);
+            for (VertexId &neighbor : graph.neighbors)
+            {
+                neighbor = static_cast<VertexId>(random() % n);
+            }
+            reverse = transpose_csr_graph(graph);
+            for (size_t v = 0; v < n; v += v < hubs ? 1 : 64)
+            {
+                seeds.push_back(static_cast<VertexId>(v));
+            }
+        }
+    };
+}
+
+static void BM_LoadTransferChunks(benchmark::State &state)
+{
+    BenchData &data = bench_data();
+    MutedOutput muted;
+    for (auto _ : state)
+    {
+        AddressInterner interner;
+        std::vector<TransferEdge> edges;
+        load_transfer_chunks(data.chunk_files, interner, edges);
+        benchmark::DoNotOptimize(edges.data());
+    }
+    set_line_counters(state, data.chunk_lines, data.chunk_bytes);
+}
+BENCHMARK(BM_LoadTransferChunks)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_BuildGraphFromChunks(benchmark::State &state)
+{
+    BenchData &data = bench_data();
+    MutedOutput muted;
+    for (auto _ : state)
+    {
+        AddressInterner interner;
+        CSRGraph graph, reverse;
+        build_graph_from_chunks(data.chunk_files, graph, reverse, interner);
+        benchmark::DoNotOptimize(graph.neighbors.data());
+    }
+    set_line_counters(state, data.chunk_lines, data.chunk_bytes);
+}
+BENCHMARK(BM_BuildGraphFromChunks)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_GraphSnapshotLoad(benchmark::State &state)
+{
+    BenchData &data = bench_data();
+    MutedOutput muted;
+    const std::string snapshot_filename = data.directory + "graph.snapshot";
+    const std::vector<ChunkFingerprint> chunks = fingerprint_chunks(data.chunk_files);
+    write_graph_snapshot(snapshot_filename, data.graph, data.interner, chunks);
+    for (auto _ : state)
+    {
+        AddressInterner interner;
+        CSRGraph graph;
+        if (!read_graph_snapshot(snapshot_filename, chunks, graph, interner))
+        {
+            state.SkipWithError("snapshot did not load");
+            break;
+        }
+        benchmark::DoNotOptimize(graph.neighbors.data());
+    }
+    set_line_counters(state, data.chunk_lines, data.chunk_bytes);
+    std::remove(snapshot_filename.c_str());
+}
+BENCHMARK(BM_GraphSnapshotLoad)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_ReadKycAddr(benchmark::State &state)
+{
+    BenchData &data = bench_data();
+    MutedOutput muted;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(read_kyc_addr(data.kyc_filename, data.interner));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.kyc_lines));
+    state.counters["lines_per_second"] = benchmark::Counter(static_cast<double>(state.iterations() * data.kyc_lines), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ReadKycAddr)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Arguments: alpha and beta of the direction switch. (1, 18) never goes bottom-up, (2^30, 2^30) always does.
+static void BM_DirectionOptimizingBFS(benchmark::State &state)
+{
+    BenchData &data = bench_data();
+    MutedOutput muted;
+    std::vector<uint8_t> hops;
+    std::vector<BFSLevelStats> stats;
+    size_t total_edges = 0;
+    for (auto _ : state)
+    {
+        stats = bfs_direction_optimizing(data.graph, data.reverse, data.seeds, 5, hops, static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+        total_edges = 0;
+        for (const BFSLevelStats &level : stats)
+        {
+            total_edges += level.edges_scanned;
+        }
+    }
+    set_bfs_counters(state, stats, total_edges);
+}
+BENCHMARK(BM_DirectionOptimizingBFS)->Args({15, 18})->Args({1, 18})->Args({1 << 30, 1 << 30})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// BFS on the byte-compressed lists; compare with BM_DirectionOptimizingBFS/15/18
+static void BM_CompressedBFS(benchmark::State &state)
+{
+    BenchData &data = bench_data();
+    MutedOutput muted;
+    const CompressedGraph graph = compress_csr_graph(data.graph);
+    const CompressedGraph reverse = compress_csr_graph(data.reverse);
+    std::vector<uint8_t> hops;
+    std::vector<BFSLevelStats> stats;
+    size_t total_edges = 0;
+    for (auto _ : state)
+    {
+        stats = bfs_compressed(graph, reverse, data.seeds, 5, hops);
+        total_edges = 0;
+        for (const BFSLevelStats &level : stats)
+        {
+            total_edges += level.edges_scanned;
+        }
+    }
+    set_bfs_counters(state, stats, total_edges);
+    const size_t csr_bytes = memory_bytes(data.graph) + memory_bytes(data.reverse) - weight_memory_bytes(data.graph) - weight_memory_bytes(data.reverse);
+    state.counters["csr_bytes_per_edge"] = static_cast<double>(csr_bytes) / (2 * num_edges(data.graph));
+    state.counters["bytes_per_edge"] = static_cast<double>(memory_bytes(graph) + memory_bytes(reverse)) / (2 * num_edges(graph));
+}
+BENCHMARK(BM_CompressedBFS)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Argument: the share of transfers (per mille) that arrive after the previous run. Times only the
+// distance update on the grown graph; compare with a full BM_DirectionOptimizingBFS/15/18.
+static void BM_IncrementalUpdate(benchmark::State &state)
+{
+    BenchData &data = bench_data();
+    MutedOutput muted;
+    AddressInterner interner;
+    std::vector<TransferEdge> edges;
+    load_transfer_chunks(data.chunk_files, interner, edges);
+    const size_t split = edges.size() - edges.size() * state.range(0) / 1000;
+    const std::vector<TransferEdge> new_edges(edges.begin() + split, edges.end());
+    edges.resize(split);
+    const CSRGraph old_graph = build_csr_graph(interner.size(), edges);
+    std::vector<uint8_t> old_hops;
+    bfs_direction_optimizing(old_graph, transpose_csr_graph(old_graph), data.seeds, 5, old_hops);
+    const CSRGraph graph = add_edges_to_csr_graph(old_graph, interner.size(), new_edges);
+    std::vector<uint8_t> hops;
+    size_t lowered = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        hops = old_hops;
+        state.ResumeTiming();
+        lowered = 0;
+        for (const BFSLevelStats &level : update_distances_after_insertions(graph, data.seeds, new_edges, 5, hops))
+        {
+            lowered += level.frontier_size;
+        }
+    }
+    state.counters["new_edges"] = static_cast<double>(new_edges.size());
+    state.counters["lowered"] = static_cast<double>(lowered);
+}
+BENCHMARK(BM_IncrementalUpdate)->Arg(1)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Argument: seeds changed, half of them KYC addresses removed at random and half random new ones.
+// The result is checked against a full BFS from the changed seed list, whose time is reported too.
+static void BM_SeedDelta(benchmark::State &state)
+{
+    BenchData &data = bench_data();
+    MutedOutput muted;
+    std::vector<VertexId> new_seeds(data.seeds);
+    std::mt19937_64 rng(7);
+    std::shuffle(new_seeds.begin(), new_seeds.end(), rng);
+    const size_t num_removed = std::min<size_t>(state.range(0) / 2, new_seeds.size());
+    const std::vector<VertexId> removed(new_seeds.begin(), new_seeds.begin() + num_removed);
+    new_seeds.erase(new_seeds.begin(), new_seeds.begin() + num_removed);
+    std::vector<VertexId> added;
+    while (added.size() < static_cast<size_t>(state.range(0)) - num_removed)
+    {
+        added.push_back(static_cast<VertexId>(rng() % num_vertices(data.graph)));
+    }
+    new_seeds.insert(new_seeds.end(), added.begin(), added.end());
+    std::vector<uint8_t> baseline, expected;
+    bfs_direction_optimizing(data.graph, data.reverse, data.seeds, 5, baseline);
+    auto start = std::chrono::steady_clock::now();
+    bfs_direction_optimizing(data.graph, data.reverse, new_seeds, 5, expected);
+    const double full_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<uint8_t> hops;
+    size_t changed = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        hops = baseline;
+        state.ResumeTiming();
+        changed = apply_seed_delta(data.graph, data.reverse, added, removed, 5, hops).size();
+    }
+    if (hops != expected)
+    {
+        state.SkipWithError("seed delta differs from a full BFS");
+    }
+    state.counters["changed"] = static_cast<double>(changed);
+    state.counters["full_bfs_ms"] = full_seconds * 1e3;
+}
+BENCHMARK(BM_SeedDelta)->Arg(2)->Arg(64)->Arg(4096)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Personalized PageRank from the KYC seeds to a 1e-9 residual. Argument: OpenMP threads (0 for
+// all), to check the kernel scales with cores.
+static void BM_PersonalizedPageRank(benchmark::State &state)
+{
+    BenchData &data = bench_data();
+    const int max_threads = omp_get_max_threads();
+    omp_set_num_threads(state.range(0) > 0 ? static_cast<int>(state.range(0)) : max_threads);
+    std::vector<double> scores;
+    std::vector<PageRankIterationStats> stats;
+    for (auto _ : state)
+    {
+        stats = personalized_pagerank(data.graph, data.reverse, data.seeds, scores);
+    }
+    omp_set_num_threads(max_threads);
+    state.counters["iterations"] = static_cast<double>(stats.size());
+    state.counters["residual"] = stats.empty() ? 0.0 : stats.back().residual;
+    // Edges gathered per second over all iterations
+    state.counters["edges_per_second"] = benchmark::Counter(static_cast<double>(state.iterations() * stats.size() * num_edges(data.graph)), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_PersonalizedPageRank)->Arg(1)->Arg(2)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 5-hop reach estimates for every vertex. Argument: sketch precision (2^precision registers each).
+static void BM_NeighborhoodSketch(benchmark::State &state)
+{
+    BenchData &data = bench_data();
+    const int precision = static_cast<int>(state.range(0));
+    std::vector<float> reach;
+    std::vector<SketchIterationStats> stats;
+    for (auto _ : state)
+    {
+        stats = neighborhood_sizes(data.graph, 5, precision, reach);
+    }
+    for (const SketchIterationStats &iteration : stats)
+    {
+        state.counters["changed_" + std::to_string(iteration.hops)] = static_cast<double>(iteration.changed);
+    }
+    state.counters["register_mb"] = sketch_memory_bytes(num_vertices(data.graph), precision) / (1024.0 * 1024.0);
+}
+BENCHMARK(BM_NeighborhoodSketch)->Arg(4)->Arg(6)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Distances at 12 monthly cutoffs over a year of synthetic first-seen dates. Argument 1 runs
+// bfs_by_cutoff_dates on one date-ordered graph, 0 rebuilds the graph and reruns the BFS per date.
+static void BM_CutoffDates(benchmark::State &state)
+{
+    BenchData &data = bench_data();
+    MutedOutput muted;
+    AddressInterner interner;
+    std::vector<TransferEdge> edges;
+    load_transfer_chunks(data.chunk_files, interner, edges);
+    const std::vector<VertexId> seeds = read_kyc_addr(data.kyc_filename, interner);
+    std::mt19937_64 rng(11);
+    const uint32_t first_day = 19358; // 2023-01-01
+    for (TransferEdge &edge : edges)
+    {
+        edge.first_seen = first_day + static_cast<uint32_t>(rng() % 365);
+    }
+    std::vector<uint32_t> cutoffs;
+    for (uint32_t month = 1; month <= 12; ++month)
+    {
+        cutoffs.push_back(first_day + month * 365 / 12 - 1);
+    }
+
+    std::vector<uint32_t> first_seen;
+    const CSRGraph graph = build_dated_csr_graph(interner.size(), edges, first_seen);
+    std::vector<uint8_t> hops;
+    for (auto _ : state)
+    {
+        if (state.range(0) == 1)
+        {
+            bfs_by_cutoff_dates(graph, first_seen, seeds, cutoffs, 5, hops);
+        }
+        else
+        {
+            for (const uint32_t cutoff : cutoffs)
+            {
+                std::vector<TransferEdge> window;
+                std::copy_if(edges.begin(), edges.end(), std::back_inserter(window), [cutoff](const TransferEdge &edge)
+                             { return edge.first_seen <= cutoff; });
+                const CSRGraph window_graph = build_csr_graph(interner.size(), window);
+                bfs_direction_optimizing(window_graph, build_reverse_csr_graph(interner.size(), window), seeds, 5, hops);
+            }
+        }
+    }
+    state.counters["cutoffs"] = static_cast<double>(cutoffs.size());
+}
+BENCHMARK(BM_CutoffDates)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Argument: memory budget in percent of the partitioned adjacency. The partitions are 1/64 of it
+// each, so 25 keeps about a quarter resident and streams the rest from the file on every level.
+static void BM_SemiExternalBFS(benchmark::State &state)
+{
+    BenchData &data = bench_data();
+    MutedOutput muted;
+    const std::string partitions_filename = data.directory + "graph.partitions";
+    const std::vector<ChunkFingerprint> chunks = fingerprint_chunks(data.chunk_files);
+    const uint64_t adjacency_bytes = (num_vertices(data.graph) + 1) * sizeof(uint64_t) + num_edges(data.graph) * sizeof(VertexId);
+    write_edge_partitions(partitions_filename, data.graph, data.interner, chunks, adjacency_bytes / 64);
+    AddressInterner interner;
+    PartitionedGraph graph;
+    if (!graph.open(partitions_filename, chunks, adjacency_bytes * state.range(0) / 100, interner))
+    {
+        state.SkipWithError("partitions did not load");
+        return;
+    }
+    const uint64_t resident_bytes = graph.bytes_read();
+    std::vector<uint8_t> hops;
+    std::vector<BFSLevelStats> stats;
+    size_t total_edges = 0;
+    uint64_t bytes_streamed = 0;
+    for (auto _ : state)
+    {
+        const uint64_t before = graph.bytes_read();
+        stats = bfs_semi_external(graph, data.seeds, 5, hops);
+        bytes_streamed = graph.bytes_read() - before;
+        total_edges = 0;
+        for (const BFSLevelStats &level : stats)
+        {
+            total_edges += level.edges_scanned;
+        }
+    }
+    set_bfs_counters(state, stats, total_edges);
+    state.counters["resident_fraction"] = static_cast<double>(resident_bytes) / adjacency_bytes;
+    state.counters["streamed_MB"] = bytes_streamed / (1024.0 * 1024.0);
+    std::remove(partitions_filename.c_str());
+}
+BENCHMARK(BM_SemiExternalBFS)->Arg(0)->Arg(25)->Arg(100)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Argument: VertexOrdering. Reports the relabeling time next to the BFS time on the relabeled graph.
+static void BM_ReorderedBFS(benchmark::State &state)
+{
+    BenchData &data = bench_data();
+    MutedOutput muted;
+    const VertexOrdering ordering = static_cast<VertexOrdering>(state.range(0));
+    auto start = std::chrono::steady_clock::now();
+    const std::vector<VertexId> new_id = compute_vertex_order(data.graph, data.reverse, data.seeds, ordering);
+    const CSRGraph graph = relabel_csr_graph(data.graph, new_id);
+    const CSRGraph reverse = relabel_csr_graph(data.reverse, new_id);
+    const std::vector<VertexId> seeds = relabel_vertices(data.seeds, new_id);
+    const double reorder_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::vector<uint8_t> hops;
+    std::vector<BFSLevelStats> stats;
+    size_t total_edges = 0;
+    for (auto _ : state)
+    {
+        stats = bfs_direction_optimizing(graph, reverse, seeds, 5, hops);
+        total_edges = 0;
+        for (const BFSLevelStats &level : stats)
+        {
+            total_edges += level.edges_scanned;
+        }
+    }
+    set_bfs_counters(state, stats, total_edges);
+    state.counters["reorder_ms"] = reorder_seconds * 1e3;
+    state.SetLabel(vertex_ordering_name(ordering));
+}
+BENCHMARK(BM_ReorderedBFS)->DenseRange(0, 3)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Arguments: number of hubs and their out-degree. Top-down only, so every level goes through the
+// edge-balanced scheduler; ideal per-level time is the level's edges over the thread count.
+static void BM_HubFrontierBFS(benchmark::State &state)
+{
+    HubGraph data(static_cast<size_t>(state.range(0)), static_cast<uint64_t>(state.range(1)));
+    MutedOutput muted;
+    std::vector<uint8_t> hops;
+    std::vector<BFSLevelStats> stats;
+    size_t total_edges = 0;
+    for (auto _ : state)
+    {
+        stats = bfs_direction_optimizing(data.graph, data.reverse, data.seeds, 3, hops, 1, 18);
+        total_edges = 0;
+        for (const BFSLevelStats &level : stats)
+        {
+            total_edges += level.edges_scanned;
+        }
+    }
+    set_bfs_counters(state, stats, total_edges);
+}
+BENCHMARK(BM_HubFrontierBFS)->Args({4, 1 << 22})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_MultiSourceBFS(benchmark::State &state)
+{
+    BenchData &data = bench_data();
+    MutedOutput muted;
+    // The KYC set split into state.range(0) groups
+    std::vector<SeedGroup> groups(state.range(0));
+    for (size_t i = 0; i < data.seeds.size(); ++i)
+    {
+        groups[i % groups.size()].seeds.push_back(data.seeds[i]);
+    }
+    std::vector<uint8_t> hops;
+    std::vector<BFSLevelStats> stats;
+    size_t total_edges = 0;
+    for (auto _ : state)
+    {
+        stats = multi_source_bfs(data.graph, data.reverse, groups, 5, hops);
+        total_edges = 0;
+        for (const BFSLevelStats &level : stats)
+        {
+            total_edges += level.edges_scanned;
+        }
+    }
+    set_bfs_counters(state, stats, total_edges);
+}
+BENCHMARK(BM_MultiSourceBFS)->Arg(8)->Arg(64)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Argument: 0 for the text writer, 1 for the binary writer
+static void BM_WriteHops(benchmark::State &state)
+{
+    BenchData &data = bench_data();
+    MutedOutput muted;
+    std::vector<uint8_t> hops;
+    bfs_direction_optimizing(data.graph, data.reverse, data.seeds, 5, hops);
+    const std::string output_filename = data.directory + "hops_output";
+    size_t bytes = 0;
+    for (auto _ : state)
+    {
+        bytes = state.range(0) == 0 ? write_hops_text(output_filename, hops, data.interner, 6) : write_hops_binary(output_filename, hops, data.interner, 6);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.interner.size()));
+    std::remove(output_filename.c_str());
+}
+BENCHMARK(BM_WriteHops)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,45 @@
+#include "rmat_generator.hpp"
+
+using namespace std;
+
+// Writes a synthetic transfer history (and a KYC file) in the layout of the real exports
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        cerr << "Usage: generate_transfers <output base filename> <scale> [edge factor] [hot wallets] [seed]" << endl;
+        cerr << "Writes <base>uni_transfer_history_<12 digits> chunks and <base>agg_eai_no_dusting.csv" << endl;
+        return 1;
+    }
+    try
+    {
+        const std::string base_filename = argv[1];
+        RMATParams params;
+        params.scale = static_cast<uint32_t>(std::stoul(argv[2]));
+        if (argc > 3)
+        {
+            params.edge_factor = static_cast<uint32_t>(std::stoul(argv[3]));
+        }
+        if (argc > 4)
+        {
+            params.hot_wallets = static_cast<uint32_t>(std::stoul(argv[4]));
+        }
+        if (argc > 5)
+        {
+            params.seed = std::stoull(argv[5]);
+        }
+
+        auto start = chrono::high_resolution_clock::now();
+        std::vector<std::string> chunk_files = write_rmat_chunks(base_filename + "uni_transfer_history_", params);
+        size_t kyc_count = write_rmat_kyc(base_filename + "agg_eai_no_dusting.csv", params, 64);
+        chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+        std::cout << "Wrote " << ((uint64_t(1) << params.scale) * params.edge_factor) << " transfers in " << chunk_files.size() << " chunks and "
+                  << kyc_count << " KYC addresses in " << elapsed.count() << " seconds" << std::endl;
+        return 0;
+    }
+    catch (std::exception const &e)
+    {
+        cerr << "Exception thrown: " << e.what() << "\n";
+        return 1;
+    }
+}
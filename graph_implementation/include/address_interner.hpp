@@ -0,0 +1,91 @@
+#ifndef ADDRESS_INTERNER_H
+#define ADDRESS_INTERNER_H
+
+#include "csr_graph.hpp"
+#include "binary_io.hpp"
+#include <cstring>
+
+// Binary form of a 20-byte Ethereum address
+struct AddressKey
+{
+    uint8_t bytes[20];
+
+    bool operator==(const AddressKey &other) const { return std::memcmp(bytes, other.bytes, sizeof(bytes)) == 0; }
+    bool operator!=(const AddressKey &other) const { return !(*this == other); }
+};
+
+// Decodes "0x" followed by 40 lowercase hex digits. Returns false for anything else.
+bool parse_address_key(const char *text, size_t length, AddressKey &key);
+
+// Encodes a key back to its "0x..." lowercase hex text
+std::string format_address_key(const AddressKey &key);
+
+// Writes the 42 characters of the hex text to out, without allocating
+void format_address_key(const AddressKey &key, char *out);
+
+/*
+Maps addresses to dense 32-bit vertex ids and back.
+Well-formed hex addresses are stored as 20-byte keys: key -> id goes through a flat
+open-addressing table, id -> key is a plain array lookup. Any other text (test fixtures such
+as "address1", checksummed or truncated addresses) takes a string-keyed fallback path and
+still gets an id from the same dense sequence, so it round-trips exactly.
+*/
+class AddressInterner
+{
+public:
+    explicit AddressInterner(size_t expected_addresses = 0);
+
+    // Returns the id of the address, assigning the next id if it has not been seen before
+    VertexId intern(const char *text, size_t length);
+    VertexId intern(const std::string &address) { return intern(address.data(), address.size()); }
+
+    // Same as intern() for an address that is already decoded
+    VertexId intern_key(const AddressKey &key);
+
+    // Looks up an address without inserting it. Returns false if it is unknown.
+    bool find(const char *text, size_t length, VertexId &id) const;
+    bool find(const std::string &address, VertexId &id) const { return find(address.data(), address.size(), id); }
+
+    // Text of the address with the given id
+    std::string address(VertexId id) const;
+
+    // True if the id came through the binary key path
+    bool has_key(VertexId id) const { return fallback_addresses_.empty() || fallback_addresses_.find(id) == fallback_addresses_.end(); }
+
+    const AddressKey &key(VertexId id) const { return keys_[id]; }
+
+    size_t size() const { return keys_.size(); }
+
+    void reserve(size_t expected_addresses);
+
+    size_t memory_bytes() const;
+
+    // Binary form used by the graph snapshot: the key array, the slot table and the fallback strings
+    void write_to(std::ostream &out) const;
+
+    // Restores a table written by write_to(). Returns false if the section is truncated or inconsistent.
+    bool read_from(BinaryReader &reader);
+
+private:
+    // A table slot caches the upper hash bits so most probes never touch keys_
+    struct Slot
+    {
+        VertexId id;
+        uint32_t tag;
+    };
+
+    static constexpr VertexId EMPTY_SLOT = std::numeric_limits<VertexId>::max();
+
+    VertexId find_key(const AddressKey &key, uint64_t hash) const;
+    void insert_slot(VertexId id, uint64_t hash);
+    void grow(size_t min_capacity);
+
+    std::vector<AddressKey> keys_; // id -> key (zeroed for fallback ids)
+    std::vector<Slot> slots_;      // open-addressing table, capacity is a power of two
+    uint64_t mask_;
+    size_t num_keyed_;
+    std::unordered_map<std::string, VertexId> fallback_ids_;
+    std::unordered_map<VertexId, std::string> fallback_addresses_;
+};
+
+#endif // ADDRESS_INTERNER_H
@@ -0,0 +1,189 @@
+#ifndef BFS_LEVELS_H
+#define BFS_LEVELS_H
+
+#include "parallel_bfs.hpp"
+#include "metrics.hpp"
+
+// Claims v for the level being discovered (test first, so visited vertices cost no atomic);
+// true for exactly one thread
+inline bool claim_vertex(VertexId v, uint8_t next_hops, Bitmap &visited, std::vector<uint8_t> &hops)
+{
+    if (visited.test(v) || !visited.set_atomic(v))
+    {
+        return false;
+    }
+    hops[v] = next_hops;
+    return true;
+}
+
+/*
+The level loop of the direction-optimizing BFS, shared by every adjacency layout. Adjacency
+provides:
+
+    size_t vertex_count() const
+    size_t edge_count() const
+    uint64_t degree(VertexId v) const                   out-edges of v the BFS follows
+    void for_each_in_neighbor(VertexId v, Visit visit) const
+                                                        visit(u) for the in-neighbors of v until it returns true
+    uint64_t plan_top_down(const std::vector<VertexId> &queue)
+                                                        called before a top-down level; returns the edges it will scan
+    void for_each_frontier_edge(const std::vector<VertexId> &queue, Visit visit)
+                                                        called by every thread of a parallel region; visit(u, v)
+                                                        once for every out-edge u -> v of the frontier
+    void record_top_down(BFSLevelStats &level) const    fills the busy-time fields of a top-down level
+
+parents, when given, receives one predecessor per reached vertex. quiet skips the per-level log line.
+*/
+template <typename Adjacency>
+std::vector<BFSLevelStats> bfs_levels(Adjacency &adjacency, const std::vector<VertexId> &seeds, int max_hops, std::vector<uint8_t> &hops, int alpha, int beta, VertexId *parents, bool quiet)
+{
+    const size_t n = adjacency.vertex_count();
+    hops.assign(n, UNVISITED_HOPS);
+    Bitmap visited(n), front(n), next(n);
+    std::vector<VertexId> queue;
+    queue.reserve(seeds.size());
+    std::vector<BFSLevelStats> stats;
+
+    // Level 0: the seeds themselves
+    int64_t scout_count = 0;
+    for (const VertexId seed : seeds)
+    {
+        if (seed < n && visited.set_atomic(seed))
+        {
+            hops[seed] = 0;
+            if (parents)
+            {
+                parents[seed] = seed;
+            }
+            queue.push_back(seed);
+            scout_count += adjacency.degree(seed);
+        }
+    }
+
+    int64_t edges_to_check = static_cast<int64_t>(adjacency.edge_count());
+    size_t frontier_size = queue.size();
+    size_t previous_frontier_size = 0;
+    bool bottom_up = false;
+
+    for (int current_level = 0; current_level < max_hops && frontier_size > 0; ++current_level)
+    {
+        auto start = chrono::high_resolution_clock::now();
+        const uint8_t next_hops = static_cast<uint8_t>(current_level + 1);
+
+        // Pick the direction for this level
+        if (!bottom_up && scout_count > edges_to_check / alpha)
+        {
+            queue_to_bitmap(queue, front);
+            bottom_up = true;
+        }
+        else if (bottom_up && frontier_size < previous_frontier_size && frontier_size < n / beta)
+        {
+            bitmap_to_queue(front, queue);
+            bottom_up = false;
+        }
+        edges_to_check -= scout_count;
+
+        size_t edges_scanned = 0;
+        size_t discovered = 0;
+        int64_t next_scout_count = 0;
+
+        if (bottom_up)
+        {
+            // Every unvisited vertex looks for a parent in the frontier. Each thread owns whole
+            // bitmap words, so the visited and next words can be written without atomics.
+            next.reset();
+#pragma omp parallel for schedule(dynamic, 256) reduction(+ : edges_scanned, discovered, next_scout_count)
+            for (size_t w = 0; w < visited.num_words(); ++w)
+            {
+                uint64_t unvisited = ~visited.word(w);
+                if (w == visited.num_words() - 1 && n % 64 != 0)
+                {
+                    unvisited &= (uint64_t(1) << (n % 64)) - 1;
+                }
+                uint64_t found = 0;
+                while (unvisited)
+                {
+                    const int bit = __builtin_ctzll(unvisited);
+                    unvisited &= unvisited - 1;
+                    const VertexId v = static_cast<VertexId>(w * 64 + bit);
+                    adjacency.for_each_in_neighbor(v, [&](VertexId u)
+                                                   {
+                        EAI_METRIC(++edges_scanned);
+                        if (!front.test(u))
+                        {
+                            return false;
+                        }
+                        found |= uint64_t(1) << bit;
+                        hops[v] = next_hops;
+                        // Only the thread owning v's bitmap word writes its predecessor
+                        if (parents)
+                        {
+                            parents[v] = u;
+                        }
+                        ++discovered;
+                        next_scout_count += adjacency.degree(v);
+                        return true; });
+                }
+                if (found)
+                {
+                    next.set_word(w, found);
+                    visited.set_word(w, visited.word(w) | found);
+                }
+            }
+            front.swap(next);
+        }
+        else
+        {
+            // Every frontier vertex claims its unvisited neighbors with an atomic fetch_or
+            std::vector<VertexId> next_queue;
+            edges_scanned = adjacency.plan_top_down(queue);
+#pragma omp parallel reduction(+ : discovered, next_scout_count)
+            {
+                std::vector<VertexId> local_queue;
+                adjacency.for_each_frontier_edge(queue, [&](VertexId u, VertexId v)
+                                                 {
+                    if (claim_vertex(v, next_hops, visited, hops))
+                    {
+                        // The thread that claimed v is the only one writing its predecessor
+                        if (parents)
+                        {
+                            parents[v] = u;
+                        }
+                        local_queue.push_back(v);
+                        ++discovered;
+                        next_scout_count += adjacency.degree(v);
+                    } });
+#pragma omp critical
+                {
+                    next_queue.insert(next_queue.end(), local_queue.begin(), local_queue.end());
+                }
+            }
+            queue = std::move(next_queue);
+        }
+
+        chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+        stats.push_back({current_level, bottom_up, frontier_size, edges_scanned, discovered, elapsed.count()});
+        if (!bottom_up)
+        {
+            adjacency.record_top_down(stats.back());
+        }
+        if (!quiet)
+        {
+            std::cout << "Level " << current_level << (bottom_up ? " (bottom-up)" : " (top-down)")
+                      << ": frontier " << frontier_size << ", edges scanned " << edges_scanned
+                      << ", discovered " << discovered << ", time " << elapsed.count() << " seconds";
+            if (!bottom_up && stats.back().mean_busy_seconds > 0)
+            {
+                std::cout << ", busy max/mean " << stats.back().max_busy_seconds / stats.back().mean_busy_seconds;
+            }
+            std::cout << std::endl;
+        }
+
+        previous_frontier_size = frontier_size;
+        frontier_size = discovered;
+        scout_count = next_scout_count;
+    }
+    return stats;
+}
+
+#endif // BFS_LEVELS_H
@@ -0,0 +1,111 @@
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <vector>
+
+// Helpers for the little binary formats (graph snapshot, distance files).
+// Arrays are padded to 8 bytes so every section of a mapped file stays aligned.
+
+template <typename T>
+void write_pod(std::ostream &out, const T &value)
+{
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+void write_array(std::ostream &out, const T *values, size_t count)
+{
+    static const char padding[8] = {0};
+    const size_t bytes = count * sizeof(T);
+    out.write(reinterpret_cast<const char *>(values), bytes);
+    out.write(padding, (8 - bytes % 8) % 8);
+}
+
+// Bounds-checked cursor over a mapped file. Any read past the end puts it in a failed state.
+class BinaryReader
+{
+public:
+    BinaryReader(const char *data, size_t size) : pos_(data), end_(data + size), failed_(false) {}
+
+    template <typename T>
+    bool read_pod(T &value)
+    {
+        if (failed_ || static_cast<size_t>(end_ - pos_) < sizeof(T))
+        {
+            failed_ = true;
+            return false;
+        }
+        std::memcpy(&value, pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    // Returns a pointer to count elements in place, or nullptr if they run past the end
+    template <typename T>
+    const T *read_array(size_t count)
+    {
+        const size_t remaining = static_cast<size_t>(end_ - pos_);
+        if (failed_ || count > remaining / sizeof(T))
+        {
+            failed_ = true;
+            return nullptr;
+        }
+        const size_t bytes = count * sizeof(T);
+        const size_t padded = bytes + (8 - bytes % 8) % 8;
+        if (padded > remaining)
+        {
+            failed_ = true;
+            return nullptr;
+        }
+        const T *values = reinterpret_cast<const T *>(pos_);
+        pos_ += padded;
+        return values;
+    }
+
+    // Returns a pointer to count packed bytes (no padding), or nullptr if they run past the end
+    const char *read_bytes(size_t count)
+    {
+        if (failed_ || count > static_cast<size_t>(end_ - pos_))
+        {
+            failed_ = true;
+            return nullptr;
+        }
+        const char *bytes = pos_;
+        pos_ += count;
+        return bytes;
+    }
+
+    // Copies count elements into a vector, splitting the copy across threads
+    template <typename T>
+    bool read_vector(size_t count, std::vector<T> &values)
+    {
+        const T *source = read_array<T>(count);
+        if (!source)
+        {
+            return false;
+        }
+        values.resize(count);
+        const size_t block = 1 << 20;
+#pragma omp parallel for schedule(static)
+        for (size_t start = 0; start < count; start += block)
+        {
+            std::memcpy(values.data() + start, source + start, std::min(block, count - start) * sizeof(T));
+        }
+        return true;
+    }
+
+    const char *position() const { return pos_; }
+
+    bool failed() const { return failed_; }
+
+private:
+    const char *pos_;
+    const char *end_;
+    bool failed_;
+};
+
+#endif // BINARY_IO_H
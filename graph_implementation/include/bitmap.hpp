@@ -0,0 +1,83 @@
+#ifndef BITMAP_H
+#define BITMAP_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+// Fixed-size bitmap whose bits can be set concurrently by several OpenMP threads.
+// Plain reads and clears are relaxed; set_atomic() tells the caller whether it won the race.
+class Bitmap
+{
+public:
+    Bitmap() : num_bits_(0), num_words_(0) {}
+
+    explicit Bitmap(size_t num_bits)
+        : num_bits_(num_bits), num_words_((num_bits + 63) / 64), words_(new std::atomic<uint64_t>[num_words_])
+    {
+        reset();
+    }
+
+    size_t size() const { return num_bits_; }
+
+    size_t num_words() const { return num_words_; }
+
+    void reset()
+    {
+#pragma omp parallel for schedule(static)
+        for (size_t w = 0; w < num_words_; ++w)
+        {
+            words_[w].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    bool test(size_t bit) const
+    {
+        return (words_[bit >> 6].load(std::memory_order_relaxed) >> (bit & 63)) & 1;
+    }
+
+    // Sets the bit when only one thread can touch this word
+    void set(size_t bit)
+    {
+        words_[bit >> 6].store(words_[bit >> 6].load(std::memory_order_relaxed) | (uint64_t(1) << (bit & 63)), std::memory_order_relaxed);
+    }
+
+    // Returns true if this call changed the bit from 0 to 1
+    bool set_atomic(size_t bit)
+    {
+        const uint64_t mask = uint64_t(1) << (bit & 63);
+        return !(words_[bit >> 6].fetch_or(mask, std::memory_order_relaxed) & mask);
+    }
+
+    uint64_t word(size_t w) const { return words_[w].load(std::memory_order_relaxed); }
+
+    void set_word(size_t w, uint64_t value) { words_[w].store(value, std::memory_order_relaxed); }
+
+    size_t count() const
+    {
+        size_t total = 0;
+#pragma omp parallel for schedule(static) reduction(+ : total)
+        for (size_t w = 0; w < num_words_; ++w)
+        {
+            total += __builtin_popcountll(words_[w].load(std::memory_order_relaxed));
+        }
+        return total;
+    }
+
+    void swap(Bitmap &other)
+    {
+        std::swap(num_bits_, other.num_bits_);
+        std::swap(num_words_, other.num_words_);
+        words_.swap(other.words_);
+    }
+
+    size_t memory_bytes() const { return num_words_ * sizeof(uint64_t); }
+
+private:
+    size_t num_bits_;
+    size_t num_words_;
+    std::unique_ptr<std::atomic<uint64_t>[]> words_;
+};
+
+#endif // BITMAP_H
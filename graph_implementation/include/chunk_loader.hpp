@@ -0,0 +1,113 @@
+#ifndef CHUNK_LOADER_H
+#define CHUNK_LOADER_H
+
+#include "csr_graph.hpp"
+#include "address_interner.hpp"
+
+// first_seen of a row without a date: the transfer counts as present at every cutoff date. It
+// is day 0 (1970-01-01), which parse_date never returns, so no real date can be taken for it.
+const uint32_t UNDATED = 0;
+
+// One parsed transfer row after address interning
+struct TransferEdge
+{
+    VertexId src;
+    VertexId dst;
+    float total_transfer_usd;
+    uint32_t first_seen = UNDATED; // Days since 1970-01-01 of the pair's first transfer
+};
+
+// Fields of one CSV row, pointing into the mapped chunk (no copies)
+struct TransferFields
+{
+    const char *address1;
+    size_t address1_length;
+    const char *address2;
+    size_t address2_length;
+    float total_transfer_usd;
+    uint32_t first_seen;
+};
+
+// Parse and wall-time figures of one chunk
+struct ChunkLoadStats
+{
+    std::string filename;
+    int thread;
+    size_t bytes;
+    size_t lines;
+    size_t malformed_lines;
+    double seconds;
+};
+
+// Splits "address1,address2,total_transfer_usd[,first_seen]" into its fields, first_seen being a
+// YYYY-MM-DD date (UNDATED if the column is absent or empty). Returns false for malformed rows.
+bool parse_transfer_line(const char *begin, const char *end, TransferFields &fields);
+
+// Parses a YYYY-MM-DD date into days since 1970-01-01. Returns false if it is not a valid date or
+// not after 1970-01-01, whose day count is the UNDATED sentinel.
+bool parse_date(const char *begin, const char *end, uint32_t &days);
+
+// The YYYY-MM-DD text of a day count from parse_date
+std::string format_date(uint32_t days);
+
+// Chunk files named base_filename followed by 12 digits, in numeric order
+std::vector<std::string> find_chunk_files(const std::string &base_filename);
+
+// The first num_chunks chunk names, whether or not the files exist
+std::vector<std::string> numbered_chunk_files(const std::string &base_filename, int num_chunks);
+
+/*
+Memory-maps and parses the chunks on all cores. Vertex ids are assigned in order of first
+appearance across the chunks in the given order, exactly as a sequential load would number them,
+and edges come out in file order. Like the original loader it skips the header, drops self-loops
+and transfers under min_transfer_usd (their addresses still become vertices), and logs and skips
+malformed lines and missing files.
+*/
+std::vector<ChunkLoadStats> load_transfer_chunks(const std::vector<std::string> &chunk_files, AddressInterner &interner, std::vector<TransferEdge> &edges, float min_transfer_usd = 10.0f);
+
+// Builds a weighted CSR graph from an edge list; every neighbor list comes out sorted by
+// descending transfer value, ties by vertex id. Repeated transfers between the same pair become
+// one edge whose value is their sum.
+CSRGraph build_csr_graph(size_t num_vertices, const std::vector<TransferEdge> &edges);
+
+/*
+The graph with edges added, grown to num_vertices. Lists without new edges are copied as they
+are; the others are merged with the new transfers (repeated pairs summed) and re-sorted, so the
+result has the layout build_csr_graph gives for the old and new edges together.
+*/
+CSRGraph add_edges_to_csr_graph(const CSRGraph &graph, size_t num_vertices, const std::vector<TransferEdge> &edges);
+
+// Same layout as transpose_csr_graph(build_csr_graph(num_vertices, edges)), built straight from the edges
+CSRGraph build_reverse_csr_graph(size_t num_vertices, const std::vector<TransferEdge> &edges);
+
+/*
+A weighted CSR graph whose lists are in date order: ascending first-seen date, ties by vertex id,
+first_seen getting the date of every edge. The edges seen by a cutoff date are then a prefix of
+each list (see dated_end).
+
+The rows of a pair become one edge, dated at the row whose running sum in date order reaches
+min_transfer_usd; pairs that never reach it are dropped. The dust filter then holds at every
+cutoff as long as each row carries only the value of its own period. A row summed over the whole
+history, as in the one-row-per-pair export, dates the pair at its first transfer even if that
+transfer alone was dust. The weight is the sum of all the pair's rows, so it overstates the value
+at cutoffs before its last row.
+*/
+CSRGraph build_dated_csr_graph(size_t num_vertices, const std::vector<TransferEdge> &edges, std::vector<uint32_t> &first_seen, float min_transfer_usd = 10.0f);
+
+// End of the prefix of v's date-ordered list first seen on or before cutoff (days since 1970-01-01)
+inline uint64_t dated_end(VertexId v, const CSRGraph &graph, const std::vector<uint32_t> &first_seen, uint32_t cutoff)
+{
+    const auto dates_begin = first_seen.begin();
+    return std::upper_bound(dates_begin + graph.offsets[v], dates_begin + graph.offsets[v + 1], cutoff) - dates_begin;
+}
+
+void build_graph_from_chunks(const std::vector<std::string> &chunk_files, CSRGraph &graph, AddressInterner &interner);
+
+// Builds the forward graph and its in-neighbor index from one pass over the chunks
+void build_graph_from_chunks(const std::vector<std::string> &chunk_files, CSRGraph &graph, CSRGraph &reverse_graph, AddressInterner &interner);
+
+// Builds the date-ordered graph of build_dated_csr_graph, for distances at several cutoff dates.
+// The 10 USD dust filter is applied to each pair's running sum there rather than to single rows.
+void build_graph_from_chunks(const std::vector<std::string> &chunk_files, CSRGraph &graph, std::vector<uint32_t> &first_seen, AddressInterner &interner);
+
+#endif // CHUNK_LOADER_H
@@ -0,0 +1,96 @@
+#ifndef COMPRESSED_GRAPH_H
+#define COMPRESSED_GRAPH_H
+
+#include "parallel_bfs.hpp"
+
+/*
+Byte-compressed adjacency lists for the unweighted BFS. Every list is sorted by neighbor id and
+stored as LEB128 varints: the degree, the first neighbor, then the gap to each following neighbor.
+Gaps of a sorted list are small, so most take one or two bytes instead of the four of a
+CSRGraph entry. Weights are not kept; a dust threshold is applied when compressing.
+*/
+struct CompressedGraph
+{
+    std::vector<uint64_t> offsets; // num_vertices + 1 byte offsets into data
+    std::vector<uint8_t> data;
+    size_t num_edges = 0;
+};
+
+// Reads one varint and advances p past it
+inline uint64_t read_varint(const uint8_t *&p)
+{
+    uint64_t value = *p++;
+    if (value < 0x80)
+    {
+        return value;
+    }
+    value &= 0x7f;
+    unsigned shift = 7;
+    uint8_t byte;
+    do
+    {
+        byte = *p++;
+        value |= uint64_t(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+// Decodes the neighbors of one vertex in ascending order: for (NeighborDecoder it(graph, v); it.next(w);)
+class NeighborDecoder
+{
+public:
+    NeighborDecoder(const CompressedGraph &graph, VertexId v)
+        : p_(graph.data.data() + graph.offsets[v]), remaining_(read_varint(p_)), degree_(remaining_), neighbor_(0), first_(true)
+    {
+    }
+
+    uint64_t degree() const { return degree_; }
+
+    bool next(VertexId &neighbor)
+    {
+        if (remaining_ == 0)
+        {
+            return false;
+        }
+        --remaining_;
+        neighbor_ = first_ ? static_cast<VertexId>(read_varint(p_)) : neighbor_ + static_cast<VertexId>(read_varint(p_));
+        first_ = false;
+        neighbor = neighbor_;
+        return true;
+    }
+
+private:
+    const uint8_t *p_;
+    uint64_t remaining_;
+    uint64_t degree_;
+    VertexId neighbor_;
+    bool first_;
+};
+
+inline uint64_t out_degree(VertexId v, const CompressedGraph &graph)
+{
+    const uint8_t *p = graph.data.data() + graph.offsets[v];
+    return read_varint(p);
+}
+
+/*
+Encodes the edges of graph weighing at least min_weight, on all cores. Repeated neighbors are
+stored once, so the result also deduplicates graphs built without merging (e.g. from a Graph).
+*/
+CompressedGraph compress_csr_graph(const CSRGraph &graph, float min_weight = 0.0f);
+
+size_t num_vertices(const CompressedGraph &graph);
+
+size_t num_edges(const CompressedGraph &graph);
+
+size_t memory_bytes(const CompressedGraph &graph);
+
+/*
+bfs_direction_optimizing on compressed lists, with the same results and the same direction switch.
+Top-down levels hand out frontier vertices dynamically (a list cannot be entered mid-way);
+bottom-up levels decode each in-list only until a frontier parent turns up.
+*/
+std::vector<BFSLevelStats> bfs_compressed(const CompressedGraph &graph, const CompressedGraph &reverse_graph, const std::vector<VertexId> &seeds, int max_hops, std::vector<uint8_t> &hops, int alpha = 15, int beta = 18);
+
+#endif // COMPRESSED_GRAPH_H
@@ -0,0 +1,56 @@
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include "uni_graph.hpp"
+#include <cstdint>
+#include <stdexcept>
+
+// Read-only compressed sparse row graph.
+// The out-neighbors of vertex v are neighbors[offsets[v]] .. neighbors[offsets[v + 1] - 1].
+// A weighted graph keeps every list sorted by descending weight, so the edges at or above any
+// threshold are a prefix of the list.
+struct CSRGraph
+{
+    std::vector<uint64_t> offsets;   // num_vertices + 1 entries
+    std::vector<VertexId> neighbors; // num_edges entries
+    std::vector<float> weights;      // num_edges entries (transfer USD), or empty if unweighted
+};
+
+CSRGraph build_csr_graph(const Graph &graph);
+
+size_t num_vertices(const CSRGraph &graph);
+
+size_t num_edges(const CSRGraph &graph);
+
+size_t memory_bytes(const CSRGraph &graph);
+
+// Share of memory_bytes taken by the edge weights
+size_t weight_memory_bytes(const CSRGraph &graph);
+
+// Builds the transpose graph: the neighbors of v are the vertices with an edge into v.
+// Weights carry over, each in-list sorted by descending weight and then by source.
+CSRGraph transpose_csr_graph(const CSRGraph &graph);
+
+// Orders every list of a weighted graph by descending weight, ties by ascending neighbor id
+void sort_by_descending_weight(CSRGraph &graph);
+
+inline uint64_t out_degree(VertexId v, const CSRGraph &graph)
+{
+    return graph.offsets[v + 1] - graph.offsets[v];
+}
+
+// End of the prefix of v's list whose weights are at least min_weight (the whole list if unweighted)
+inline uint64_t weighted_end(VertexId v, const CSRGraph &graph, float min_weight)
+{
+    const uint64_t end = graph.offsets[v + 1];
+    if (graph.weights.empty() || min_weight <= 0.0f)
+    {
+        return end;
+    }
+    const auto weights_begin = graph.weights.begin();
+    return std::partition_point(weights_begin + graph.offsets[v], weights_begin + end, [min_weight](float weight)
+                                { return weight >= min_weight; }) -
+           weights_begin;
+}
+
+#endif // CSR_GRAPH_H
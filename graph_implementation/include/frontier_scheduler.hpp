@@ -0,0 +1,183 @@
+#ifndef FRONTIER_SCHEDULER_H
+#define FRONTIER_SCHEDULER_H
+
+#include "csr_graph.hpp"
+#include <memory>
+
+/*
+Edge-balanced work distribution for the top-down BFS levels.
+plan() lays the scanned out-edges of a frontier end to end and cuts them into chunks of
+chunk_edges adjacency entries, so a hub wallet with millions of transfers is spread over many
+chunks while thousands of low-degree vertices share one. run(), called by every thread of an
+OpenMP parallel region, hands each thread a contiguous range of chunks; a thread that finishes its
+own range steals single chunks from the back of the others', so nobody waits on one long list.
+*/
+class FrontierScheduler
+{
+public:
+    static const uint64_t DEFAULT_CHUNK_EDGES = 4096;
+
+    explicit FrontierScheduler(uint64_t chunk_edges = DEFAULT_CHUNK_EDGES)
+        : chunk_edges_(std::max<uint64_t>(1, chunk_edges)), planned_chunk_edges_(chunk_edges_), queue_(nullptr), num_ranges_(0), steals_(0)
+    {
+    }
+
+    FrontierScheduler(const FrontierScheduler &) = delete;
+    FrontierScheduler &operator=(const FrontierScheduler &) = delete;
+
+    // Prepares the chunks of queue. edge_end(u) is the end of the part of u's list to scan.
+    // queue must stay unchanged until run() returns.
+    template <typename EdgeEnd>
+    void plan(const std::vector<VertexId> &queue, const CSRGraph &graph, EdgeEnd edge_end)
+    {
+        const size_t size = queue.size();
+        queue_ = queue.data();
+        starts_.resize(size);
+        prefix_.resize(size + 1);
+        prefix_[0] = 0;
+#pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < size; ++i)
+        {
+            starts_[i] = graph.offsets[queue[i]];
+            prefix_[i + 1] = edge_end(queue[i]) - starts_[i];
+        }
+        for (size_t i = 0; i < size; ++i)
+        {
+            prefix_[i + 1] += prefix_[i];
+        }
+        // Chunk indexes are packed two to a word, so keep their count below 2^32
+        planned_chunk_edges_ = std::max<uint64_t>(chunk_edges_, (total_edges() >> 31) + 1);
+    }
+
+    // Scanned out-edges of the planned frontier
+    uint64_t total_edges() const { return prefix_.empty() ? 0 : prefix_.back(); }
+
+    size_t num_chunks() const { return static_cast<size_t>((total_edges() + planned_chunk_edges_ - 1) / planned_chunk_edges_); }
+
+    /*
+    Must be called by every thread of the enclosing parallel region. Calls visit(u, begin, end)
+    once for every piece of a chunk: the neighbors[begin] .. neighbors[end - 1] of frontier vertex
+    u. A vertex cut across chunks is visited once per chunk, possibly by different threads.
+    */
+    template <typename Visit>
+    void run(Visit visit)
+    {
+#pragma omp single
+        {
+            split_ranges(static_cast<size_t>(omp_get_num_threads()));
+        }
+        const size_t self = static_cast<size_t>(omp_get_thread_num());
+        const auto start = chrono::steady_clock::now();
+        size_t chunk;
+        while (take_front(self, chunk))
+        {
+            visit_chunk(chunk, visit);
+        }
+        size_t stolen = 0;
+        for (size_t offset = 1; offset < num_ranges_; ++offset)
+        {
+            const size_t victim = (self + offset) % num_ranges_;
+            while (take_back(victim, chunk))
+            {
+                visit_chunk(chunk, visit);
+                ++stolen;
+            }
+        }
+        busy_seconds_[self] = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        steals_.fetch_add(stolen, std::memory_order_relaxed);
+#pragma omp barrier
+    }
+
+    // Seconds each thread of the last run() spent on chunks, indexed by thread number
+    const std::vector<double> &busy_seconds() const { return busy_seconds_; }
+
+    // Chunks taken from another thread's range during the last run()
+    size_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    // Remaining chunks [first, last) of one thread, packed as first << 32 | last
+    struct alignas(64) ChunkRange
+    {
+        std::atomic<uint64_t> bounds;
+    };
+
+    void split_ranges(size_t num_threads)
+    {
+        if (num_threads > num_ranges_)
+        {
+            ranges_.reset(new ChunkRange[num_threads]);
+        }
+        num_ranges_ = num_threads;
+        busy_seconds_.assign(num_threads, 0.0);
+        steals_.store(0, std::memory_order_relaxed);
+        const uint64_t chunks = num_chunks();
+        for (size_t t = 0; t < num_threads; ++t)
+        {
+            const uint64_t first = chunks * t / num_threads;
+            const uint64_t last = chunks * (t + 1) / num_threads;
+            ranges_[t].bounds.store(first << 32 | last, std::memory_order_relaxed);
+        }
+    }
+
+    // The owner takes chunks from the front of its range
+    bool take_front(size_t t, size_t &chunk)
+    {
+        uint64_t bounds = ranges_[t].bounds.load(std::memory_order_relaxed);
+        while ((bounds >> 32) < (bounds & 0xffffffff))
+        {
+            if (ranges_[t].bounds.compare_exchange_weak(bounds, bounds + (uint64_t(1) << 32), std::memory_order_relaxed))
+            {
+                chunk = static_cast<size_t>(bounds >> 32);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Thieves take chunks from the back, away from where the owner is working
+    bool take_back(size_t t, size_t &chunk)
+    {
+        uint64_t bounds = ranges_[t].bounds.load(std::memory_order_relaxed);
+        while ((bounds >> 32) < (bounds & 0xffffffff))
+        {
+            if (ranges_[t].bounds.compare_exchange_weak(bounds, bounds - 1, std::memory_order_relaxed))
+            {
+                chunk = static_cast<size_t>((bounds & 0xffffffff) - 1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename Visit>
+    void visit_chunk(size_t chunk, Visit &visit)
+    {
+        uint64_t position = chunk * planned_chunk_edges_;
+        const uint64_t last = std::min(position + planned_chunk_edges_, total_edges());
+        // Last frontier vertex whose edges start at or before the chunk
+        size_t i = std::upper_bound(prefix_.begin(), prefix_.end(), position) - prefix_.begin() - 1;
+        for (; position < last; ++i)
+        {
+            const uint64_t vertex_last = std::min(prefix_[i + 1], last);
+            if (vertex_last <= position)
+            {
+                continue;
+            }
+            const uint64_t begin = starts_[i] + (position - prefix_[i]);
+            visit(queue_[i], begin, begin + (vertex_last - position));
+            position = vertex_last;
+        }
+    }
+
+    uint64_t chunk_edges_;
+    uint64_t planned_chunk_edges_;
+    const VertexId *queue_;
+    std::vector<uint64_t> starts_; // offsets[u] of every frontier vertex
+    std::vector<uint64_t> prefix_; // Scanned edges before each frontier vertex
+    std::unique_ptr<ChunkRange[]> ranges_;
+    size_t num_ranges_;
+    std::vector<double> busy_seconds_;
+    std::atomic<size_t> steals_;
+};
+
+#endif // FRONTIER_SCHEDULER_H
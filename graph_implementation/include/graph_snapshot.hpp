@@ -0,0 +1,55 @@
+#ifndef GRAPH_SNAPSHOT_H
+#define GRAPH_SNAPSHOT_H
+
+#include "csr_graph.hpp"
+#include "address_interner.hpp"
+
+// Bumped whenever the snapshot layout or the meaning of its contents changes
+const uint32_t GRAPH_SNAPSHOT_VERSION = 3;
+
+// Identity of one source chunk. A snapshot is stale if any of these differ from the files on disk.
+struct ChunkFingerprint
+{
+    std::string filename;
+    uint64_t size;
+    int64_t modified_time;
+
+    bool operator==(const ChunkFingerprint &other) const
+    {
+        return filename == other.filename && size == other.size && modified_time == other.modified_time;
+    }
+};
+
+std::vector<ChunkFingerprint> fingerprint_chunks(const std::vector<std::string> &chunk_files);
+
+// The chunk list section shared by the snapshot and the files derived from it
+void write_chunk_list(std::ostream &out, const std::vector<ChunkFingerprint> &chunks);
+
+bool read_chunk_list(BinaryReader &reader, std::vector<ChunkFingerprint> &chunks);
+
+// 64-bit checksum of a byte range, computed in 1 MB blocks on all cores
+uint64_t snapshot_checksum(const char *data, size_t size);
+
+/*
+Writes the graph, the address dictionary and the source chunk list to a versioned binary file.
+The file is written next to its final name and renamed into place, so readers never see a
+partial snapshot.
+*/
+void write_graph_snapshot(const std::string &snapshot_filename, const CSRGraph &graph, const AddressInterner &interner, const std::vector<ChunkFingerprint> &chunks);
+
+/*
+Memory-maps a snapshot, verifies magic, version, checksum and that it was built from exactly
+expected_chunks, then copies the arrays out of the mapping. Returns false, logging why, when the
+snapshot is missing, corrupt or stale.
+*/
+bool read_graph_snapshot(const std::string &snapshot_filename, const std::vector<ChunkFingerprint> &expected_chunks, CSRGraph &graph, AddressInterner &interner);
+
+// Uses the snapshot if it is current, otherwise parses the chunks and rewrites the snapshot.
+// Returns true if the graph came from the snapshot.
+bool load_or_build_graph(const std::vector<std::string> &chunk_files, const std::string &snapshot_filename, CSRGraph &graph, AddressInterner &interner);
+
+// Same, also producing the in-neighbor index: from the parsed edges on a rebuild, by transposing
+// the loaded lists on a snapshot hit
+bool load_or_build_graph(const std::vector<std::string> &chunk_files, const std::string &snapshot_filename, CSRGraph &graph, CSRGraph &reverse_graph, AddressInterner &interner);
+
+#endif // GRAPH_SNAPSHOT_H
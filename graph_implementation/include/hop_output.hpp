@@ -0,0 +1,56 @@
+#ifndef HOP_OUTPUT_H
+#define HOP_OUTPUT_H
+
+#include "parallel_bfs.hpp"
+#include "address_interner.hpp"
+
+// Row order of the result files
+enum class HopOutputOrder
+{
+    VertexOrder, // Vertex id order, no sorting cost
+    Sorted       // Ascending address
+};
+
+// Vertex ids in the requested output order
+std::vector<VertexId> output_order(const AddressInterner &interner, HopOutputOrder order);
+
+/*
+Writes "address,hops" lines. The lines are formatted on all cores into large per-thread buffers
+that are written out in order. Vertices whose hop count is UNVISITED_HOPS are written with
+unreached_hops (6 for the default max_hops of 5). Returns the number of bytes written.
+*/
+size_t write_hops_text(const std::string &filename, const std::vector<uint8_t> &hops, const AddressInterner &interner, uint8_t unreached_hops, HopOutputOrder order = HopOutputOrder::VertexOrder);
+
+// Same as write_hops_text for num_columns hop counts per vertex (hops[v * num_columns + c]),
+// preceded by the header line unless it is empty
+size_t write_hop_columns_text(const std::string &filename, const std::vector<uint8_t> &hops, size_t num_columns, const std::string &header, const AddressInterner &interner, uint8_t unreached_hops, HopOutputOrder order = HopOutputOrder::VertexOrder);
+
+/*
+Writes "address,hops,seed,path" lines for the target vertices, where path lists the addresses
+from the originating seed to the target separated by '>'. Seed and path are empty for targets
+the BFS did not reach. Returns the number of bytes written.
+*/
+size_t write_paths_text(const std::string &filename, const std::vector<VertexId> &targets, const std::vector<uint8_t> &hops, const std::vector<VertexId> &parents, const AddressInterner &interner, uint8_t unreached_hops);
+
+// Writes "address,score" lines, formatted on all cores like write_hops_text. Returns the number of bytes written.
+size_t write_scores_text(const std::string &filename, const std::vector<double> &scores, const AddressInterner &interner, HopOutputOrder order = HopOutputOrder::VertexOrder);
+
+// Writes "address,reach..." lines of num_columns rounded estimates per vertex (reach[v * num_columns + c]),
+// preceded by the header line. Returns the number of bytes written.
+size_t write_reach_text(const std::string &filename, const std::vector<float> &reach, size_t num_columns, const std::string &header, const AddressInterner &interner, HopOutputOrder order = HopOutputOrder::VertexOrder);
+
+/*
+Compact binary result file for downstream loaders, in host byte order:
+    32-byte header: char magic[8] = "EAIHOPS1", uint64 record count, uint64 fallback count,
+                    uint32 unreached_hops (the hop value of unreached addresses), uint32 reserved (0)
+    record count x (20 address bytes, 1 hop byte),
+    fallback count x (uint32 length, address text, 1 hop byte)   (8-byte aligned)
+Fallback entries hold the addresses that are not 20-byte hex keys. Both sections follow order.
+Returns the bytes written.
+*/
+size_t write_hops_binary(const std::string &filename, const std::vector<uint8_t> &hops, const AddressInterner &interner, uint8_t unreached_hops, HopOutputOrder order = HopOutputOrder::VertexOrder);
+
+// Reads a binary result file, interning its addresses. hops is indexed by the interner ids.
+bool read_hops_binary(const std::string &filename, AddressInterner &interner, std::vector<uint8_t> &hops);
+
+#endif // HOP_OUTPUT_H
@@ -0,0 +1,83 @@
+#ifndef INCREMENTAL_BFS_H
+#define INCREMENTAL_BFS_H
+
+#include "parallel_bfs.hpp"
+#include "chunk_loader.hpp"
+#include "graph_snapshot.hpp"
+
+// Bumped whenever the distance state layout changes
+const uint32_t DISTANCE_STATE_VERSION = 1;
+
+/*
+Distances of a finished run, kept next to the graph snapshot so the next run can update them
+instead of recomputing: the hop count of every vertex (UNVISITED_HOPS beyond max_hops) and the
+chunks the graph held when they were computed.
+*/
+struct DistanceState
+{
+    int max_hops = 0;
+    std::vector<ChunkFingerprint> chunks;
+    std::vector<uint8_t> hops;
+};
+
+// Writes the state next to its final name and renames it into place. Throws std::runtime_error on failure.
+void write_distance_state(const std::string &filename, const DistanceState &state);
+
+// Returns false, logging why, if the file is missing, corrupt or of another version
+bool read_distance_state(const std::string &filename, DistanceState &state);
+
+/*
+The chunks of current that are not in previous, in order. Returns false if a chunk of previous is
+gone or changed, since removing or rewriting transfers can raise distances and needs a full run.
+*/
+bool find_new_chunks(const std::vector<ChunkFingerprint> &previous, const std::vector<ChunkFingerprint> &current, std::vector<std::string> &new_chunk_files);
+
+/*
+Updates hops, computed from a subset of seeds on graph minus new_edges, to the distances from
+seeds on graph (which already holds the new edges). Inserting edges and seeds can only lower
+distances, so only vertices whose hop count drops are visited: the new seeds and the heads of the
+new edges start at their lowered value and the decrease is pushed out level by level. The work is
+proportional to the edges of the vertices that change, not to the graph. hops grows to the
+vertex count of graph, new vertices starting unvisited. Returns one entry per level that lowered
+something.
+*/
+std::vector<BFSLevelStats> update_distances_after_insertions(const CSRGraph &graph, const std::vector<VertexId> &seeds, const std::vector<TransferEdge> &new_edges, int max_hops, std::vector<uint8_t> &hops);
+
+// A vertex whose hop count differs between two distance arrays
+struct HopChange
+{
+    VertexId vertex;
+    uint8_t old_hops;
+    uint8_t new_hops;
+};
+
+/*
+What-if analysis of a changed seed list. hops holds the distances from a seed set on graph; it is
+updated to the distances after adding added_seeds and dropping removed_seeds (removals of
+vertices that are not seeds are ignored). Additions only lower counts and are pushed out as in
+update_distances_after_insertions. For removals, the vertices whose every shortest path started
+at a removed seed are found level by level through the reverse graph, reset, and restarted from
+their in-neighbors outside that region. When that search passes num_edges / alpha edges, the
+removed seeds reach so much of the graph that a full BFS from the changed seed list is run
+instead. Returns the vertices whose count changed, by vertex id.
+*/
+std::vector<HopChange> apply_seed_delta(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &added_seeds, const std::vector<VertexId> &removed_seeds, int max_hops, std::vector<uint8_t> &hops, int alpha = 15);
+
+/*
+Hop distances from seeds at several cutoff dates in one pass, on a graph from
+build_dated_csr_graph: at cutoff c only the transfers first seen on or before c exist. Only the
+dates are read, so the dust filter is the one build_dated_csr_graph applied when dating each pair:
+exact for rows of one period each, but with rows summed over the whole history a pair counts from
+its first transfer even if it passed 10 USD only later.
+Adding transfers only lowers distances, so the cutoffs (days since 1970-01-01, in increasing
+order) are processed in turn on the same graph and distances: the first one is a BFS over the
+visible prefixes of the lists, every later one lowers the receivers of the transfers first seen
+since the previous cutoff and pushes the decrease out as update_distances_after_insertions does.
+Those transfers are bucketed by cutoff in one pass over the lists up front, so a cutoff only
+visits the senders of its new transfers.
+hops[v * cutoffs.size() + c] is the hop count of v at cutoff c, or UNVISITED_HOPS. Returns the
+levels of each cutoff. Throws std::invalid_argument if the cutoffs are not in increasing order.
+*/
+std::vector<std::vector<BFSLevelStats>> bfs_by_cutoff_dates(const CSRGraph &graph, const std::vector<uint32_t> &first_seen, const std::vector<VertexId> &seeds, const std::vector<uint32_t> &cutoffs, int max_hops, std::vector<uint8_t> &hops);
+
+#endif // INCREMENTAL_BFS_H
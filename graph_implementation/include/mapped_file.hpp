@@ -0,0 +1,81 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Read-only memory mapping of a whole file. An empty or missing file maps to an empty range.
+class MappedFile
+{
+public:
+    MappedFile() : data_(nullptr), size_(0) {}
+
+    explicit MappedFile(const std::string &filename) : data_(nullptr), size_(0) { open(filename); }
+
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Returns false if the file cannot be opened or mapped
+    bool open(const std::string &filename)
+    {
+        close();
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        size_ = static_cast<size_t>(file_stat.st_size);
+        if (size_ > 0)
+        {
+            void *address = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address == MAP_FAILED)
+            {
+                ::close(fd);
+                size_ = 0;
+                return false;
+            }
+            data_ = static_cast<const char *>(address);
+            // The chunks are scanned front to back exactly once
+            madvise(address, size_, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+        opened_ = true;
+        return true;
+    }
+
+    void close()
+    {
+        if (data_)
+        {
+            munmap(const_cast<char *>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+        opened_ = false;
+    }
+
+    bool is_open() const { return opened_; }
+
+    const char *data() const { return data_; }
+
+    size_t size() const { return size_; }
+
+private:
+    const char *data_;
+    size_t size_;
+    bool opened_ = false;
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,90 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "parallel_bfs.hpp"
+
+/*
+Per-run instrumentation. A run is a sequence of named phases (ingest, KYC load, BFS, output),
+each recording wall time, process CPU time, the peak RSS reached so far, the bytes it read and
+any named counters, plus the per-level statistics of every BFS. The whole run is emitted as one
+JSON document so runs can be compared as the graph grows.
+
+Everything here works at phase granularity, outside the parallel loops. Building without
+EAI_METRICS turns the API into empty inline stubs and also drops the per-edge work counters of
+the BFS loops (EAI_METRIC), so the traversals pay nothing for instrumentation.
+*/
+
+#ifdef EAI_METRICS
+// Keeps a statement only in instrumented builds, for counters inside hot loops
+#define EAI_METRIC(statement) statement
+#else
+#define EAI_METRIC(statement)
+#endif
+
+#ifdef EAI_METRICS
+
+// Starts a new report, discarding the phases of any previous run
+void metrics_begin_run(const std::string &run_name);
+
+// Records one phase from construction to stop() or destruction
+class PhaseTimer
+{
+public:
+    explicit PhaseTimer(const std::string &name);
+
+    ~PhaseTimer() { stop(); }
+
+    PhaseTimer(const PhaseTimer &) = delete;
+    PhaseTimer &operator=(const PhaseTimer &) = delete;
+
+    void add_bytes_read(uint64_t bytes) { bytes_read_ += bytes; }
+
+    void set_counter(const std::string &name, double value);
+
+    // Closes the phase and adds it to the report; later calls do nothing
+    void stop();
+
+private:
+    std::string name_;
+    bool stopped_;
+    double start_wall_;
+    double start_cpu_;
+    uint64_t start_io_read_;
+    uint64_t bytes_read_;
+    std::vector<std::pair<std::string, double>> counters_;
+};
+
+// Adds the levels of one traversal, with its overall edges traversed per second (TEPS)
+void record_bfs_levels(const std::string &name, const std::vector<BFSLevelStats> &levels);
+
+// The report so far as a JSON document
+std::string metrics_json();
+
+// Writes metrics_json() to filename; logs and returns false on failure
+bool write_metrics_report(const std::string &filename);
+
+#else
+
+inline void metrics_begin_run(const std::string &) {}
+
+class PhaseTimer
+{
+public:
+    explicit PhaseTimer(const std::string &) {}
+
+    void add_bytes_read(uint64_t) {}
+
+    void set_counter(const std::string &, double) {}
+
+    void stop() {}
+};
+
+inline void record_bfs_levels(const std::string &, const std::vector<BFSLevelStats> &) {}
+
+inline std::string metrics_json() { return "{}"; }
+
+inline bool write_metrics_report(const std::string &) { return true; }
+
+#endif // EAI_METRICS
+
+#endif // METRICS_H
@@ -0,0 +1,34 @@
+#ifndef MULTI_SOURCE_BFS_H
+#define MULTI_SOURCE_BFS_H
+
+#include "parallel_bfs.hpp"
+#include "address_interner.hpp"
+
+// One bit of the per-vertex masks per group
+const size_t MAX_SEED_GROUPS = 64;
+
+// A labelled seed set, e.g. exchange wallets or known hackers
+struct SeedGroup
+{
+    std::string label;
+    std::vector<VertexId> seeds;
+};
+
+/*
+Reads "address[,label]" rows (after a header line) into labelled seed groups. Rows without a label
+column go to default_label; rows with a label are grouped by it, so one file can hold several
+categories. Groups already in `groups` are extended. Addresses not in the graph are skipped.
+*/
+void read_seed_groups(const std::string &filename, const AddressInterner &interner, const std::string &default_label, std::vector<SeedGroup> &groups);
+
+/*
+Bit-parallel multi-source BFS. Every vertex carries 64-bit masks of the groups that have reached it
+and of the groups in its current frontier, so one traversal answers every group at once.
+Sparse levels push frontier masks along out-edges with an atomic fetch_or, the edges split
+evenly over the threads by a FrontierScheduler; dense levels let every
+vertex pull the OR of its in-neighbors' frontier masks (switching on the same alpha rule as the
+single-source BFS). hops[v * groups.size() + g] is the hop count of v from group g, or UNVISITED_HOPS.
+*/
+std::vector<BFSLevelStats> multi_source_bfs(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<SeedGroup> &groups, int max_hops, std::vector<uint8_t> &hops, int alpha = 15);
+
+#endif // MULTI_SOURCE_BFS_H
@@ -0,0 +1,39 @@
+#ifndef NEIGHBORHOOD_SKETCH_H
+#define NEIGHBORHOOD_SKETCH_H
+
+#include "csr_graph.hpp"
+
+// Supported precisions: log2 of the HyperLogLog registers per vertex. The relative standard
+// error of an estimate is about 1.04 / sqrt(2^precision), e.g. 13% at 6 and 6.5% at 8.
+const int MIN_SKETCH_PRECISION = 4;
+const int MAX_SKETCH_PRECISION = 16;
+
+// Register memory of neighborhood_sizes: two arrays of 2^precision bytes per vertex
+uint64_t sketch_memory_bytes(size_t num_vertices, int precision);
+
+// Largest precision up to max_precision whose registers fit in memory_bytes (MIN_SKETCH_PRECISION if none does)
+int sketch_precision_for_memory(size_t num_vertices, uint64_t memory_bytes, int max_precision);
+
+// Work of one HyperANF iteration
+struct SketchIterationStats
+{
+    int hops;       // Ball radius after this iteration
+    size_t changed; // Vertices whose counter grew
+    double seconds; // Wall time of the iteration
+};
+
+/*
+Approximate neighborhood function in the style of HyperANF (Boldi, Rosa and Vigna). Every
+vertex keeps a HyperLogLog counter of 2^precision one-byte registers, starting with just itself;
+iteration k sets each counter to the register-wise max of itself and the counters of its list
+entries, so it then counts the vertices within k hops along the lists of graph (pass the
+reverse graph for the vertices that reach v instead). The max runs as a SIMD loop over the
+registers. Only neighbors whose counter grew in the previous iteration are merged, since the
+others are already included, and the iterations stop early once no counter grows.
+
+reach[v * max_hops + k - 1] estimates the size of the k-hop ball of v, v included. hash_seed
+picks the hash function. Returns one entry per iteration run.
+*/
+std::vector<SketchIterationStats> neighborhood_sizes(const CSRGraph &graph, int max_hops, int precision, std::vector<float> &reach, uint64_t hash_seed = 0);
+
+#endif // NEIGHBORHOOD_SKETCH_H
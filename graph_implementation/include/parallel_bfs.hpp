@@ -0,0 +1,87 @@
+#ifndef PARALLEL_BFS_H
+#define PARALLEL_BFS_H
+
+#include "csr_graph.hpp"
+#include "bitmap.hpp"
+#include "frontier_scheduler.hpp"
+
+// Hop value of a vertex the BFS never reached
+const uint8_t UNVISITED_HOPS = std::numeric_limits<uint8_t>::max();
+
+// Predecessor of a vertex the BFS never reached; seeds are their own predecessor
+const VertexId NO_PREDECESSOR = std::numeric_limits<VertexId>::max();
+
+// Timing and work counters of one BFS level, used to check the direction switch point
+struct BFSLevelStats
+{
+    int level;            // Level being expanded (its frontier has hop count `level`)
+    bool bottom_up;       // Direction used for this level
+    size_t frontier_size; // Vertices in the frontier
+    size_t edges_scanned; // Adjacency entries inspected (0 in builds without EAI_METRICS)
+    size_t discovered;    // Vertices assigned hop count level + 1
+    double seconds;       // Wall time of the level
+    // Per-thread busy time of a top-down level (0 on bottom-up levels); max / mean near 1 means balanced
+    double max_busy_seconds = 0.0;
+    double mean_busy_seconds = 0.0;
+    size_t steals = 0; // Edge chunks taken from another thread's share
+};
+
+// Copies the frontier queue into the (cleared) frontier bitmap
+void queue_to_bitmap(const std::vector<VertexId> &queue, Bitmap &bitmap);
+
+// Collects the set bits of the frontier bitmap into the frontier queue
+void bitmap_to_queue(const Bitmap &bitmap, std::vector<VertexId> &queue);
+
+// Fills the busy-time fields of level from the scheduler's last run
+void record_busy_times(const FrontierScheduler &scheduler, BFSLevelStats &level);
+
+/*
+Lock-free, direction-optimizing BFS from a set of seeds.
+Top-down levels expand the frontier queue and claim neighbors with an atomic visited bitmap; the
+frontier's edges are split into equal chunks by a FrontierScheduler, so hubs do not stall a thread.
+Bottom-up levels let every unvisited vertex scan its in-neighbors (reverse_graph) for a member
+of the frontier bitmap. The switch follows Beamer's heuristic: go bottom-up once the frontier's
+out-edges exceed 1/alpha of the unexplored edges, and back top-down once the frontier shrinks
+below 1/beta of the vertices.
+Only edges weighing at least min_weight are followed; on a weighted graph those are a prefix of
+every list, so a threshold costs no extra scanning.
+On return hops[v] holds the hop count of v, or UNVISITED_HOPS if v is further than max_hops.
+Every level is logged to stdout unless quiet is set.
+*/
+std::vector<BFSLevelStats> bfs_direction_optimizing(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &seeds, int max_hops, std::vector<uint8_t> &hops, int alpha = 15, int beta = 18, float min_weight = 0.0f, bool quiet = false);
+
+/*
+bfs_direction_optimizing that also records one BFS predecessor per vertex in parents (one extra
+32-bit array). Each predecessor is written only by the thread that claimed the vertex, so no
+locks are needed. Following parents from any reached vertex ends at the seed it traces back to
+after exactly hops[v] steps.
+*/
+std::vector<BFSLevelStats> bfs_with_predecessors(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &seeds, int max_hops, std::vector<uint8_t> &hops, std::vector<VertexId> &parents, int alpha = 15, int beta = 18);
+
+// Shortest path from a seed to v as recorded in parents: the seed first, v last. Empty if v was not reached.
+std::vector<VertexId> trace_path(VertexId v, const std::vector<VertexId> &parents);
+
+// trace_path for a batch of vertices, on all cores
+std::vector<std::vector<VertexId>> trace_paths(const std::vector<VertexId> &targets, const std::vector<VertexId> &parents);
+
+/*
+Distances at several transfer value thresholds from the same loaded graph, one BFS per threshold.
+Returns hops[v * thresholds.size() + t] for threshold t.
+A threshold compares against the merged weight of a sender/receiver pair, which is the sum of
+only those rows that each passed the 10 USD load filter: two 6 USD rows leave no edge at all,
+while 8 USD + 12 USD leave an edge of 12, not 20.
+*/
+std::vector<uint8_t> bfs_weight_thresholds(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &seeds, const std::vector<float> &thresholds, int max_hops);
+
+/*
+Distances from the seeds along the transfers (hops[2 * v]) and to the seeds, i.e. how many hops
+the funds of v take to reach a seed (hops[2 * v + 1]). The backward BFS is the same traversal with
+graph and reverse_graph swapped.
+*/
+std::vector<uint8_t> bfs_forward_backward(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &seeds, int max_hops);
+
+// bfs_direction_optimizing with the map interface of the original BFS: address_to_hops gets the
+// hop count of every address in vertex_to_address, 6 for those not reached within max_hops
+void bfs_from_kyc_nodes_parallel(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::unordered_set<Vertex> &kyc_nodes, int max_hops, std::unordered_map<string, int> &address_to_hops, const std::unordered_map<Vertex, string> &vertex_to_address);
+
+#endif // PARALLEL_BFS_H
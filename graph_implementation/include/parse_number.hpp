@@ -0,0 +1,16 @@
+#ifndef PARSE_NUMBER_H
+#define PARSE_NUMBER_H
+
+#include <charconv>
+#include <cstring>
+
+// Parses all of text as a number; false on anything else, including trailing characters and overflow
+template <typename T>
+bool parse_number(const char *text, T &value)
+{
+    const char *end = text + std::strlen(text);
+    auto result = std::from_chars(text, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+#endif // PARSE_NUMBER_H
@@ -0,0 +1,50 @@
+#ifndef QUERY_CLIENT_H
+#define QUERY_CLIENT_H
+
+#include "socket_io.hpp"
+#include <vector>
+
+// Blocking client for the query service protocol described in query_server.hpp
+class QueryClient
+{
+public:
+    QueryClient() : fd_(-1) {}
+
+    ~QueryClient() { disconnect(); }
+
+    QueryClient(const QueryClient &) = delete;
+    QueryClient &operator=(const QueryClient &) = delete;
+
+    bool connect(const std::string &endpoint);
+
+    void disconnect();
+
+    // Sends one request line and collects the response lines after the "OK <n>" header.
+    // Returns false for an "ERR" response (its message goes to error) or a broken connection.
+    bool request(const std::string &line, std::vector<std::string> &response, std::string &error);
+
+private:
+    int fd_;
+    SocketLineReader reader_;
+};
+
+// Latency and throughput figures of one load run
+struct LoadReport
+{
+    size_t requests;
+    size_t errors;
+    double seconds;
+    double queries_per_second;
+    double p50_ms;
+    double p99_ms;
+    double max_ms;
+};
+
+/*
+Opens num_clients connections, each sending requests_per_client requests taken round-robin from
+requests (every client starting at a different offset) and waiting for each response before
+sending the next. Latencies are measured per request from send to the last response line.
+*/
+LoadReport generate_load(const std::string &endpoint, const std::vector<std::string> &requests, int num_clients, size_t requests_per_client);
+
+#endif // QUERY_CLIENT_H
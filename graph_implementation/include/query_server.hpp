@@ -0,0 +1,105 @@
+#ifndef QUERY_SERVER_H
+#define QUERY_SERVER_H
+
+#include "parallel_bfs.hpp"
+#include "address_interner.hpp"
+#include <thread>
+#include <list>
+
+/*
+Line protocol of the query service. Every request is one line of space-separated words; every
+response starts with "OK <n>" followed by n lines, or is a single "ERR <message>" line.
+
+    HOPS <address>...                    address,hops,seed for each address
+    PATH <address>...                    address,hops,seed,path (seed first, '>'-separated)
+    BFS <max_hops> <seed>[,<seed>...] [<address>...]
+                                         BFS from custom seeds: address,hops for each address,
+                                         or level,count for levels 0..max_hops without addresses
+    STATS                                vertices,edges,seeds,max_hops
+
+Unreached addresses report max_hops + 1 and an empty seed; addresses not in the graph report
+empty hops and seed fields.
+*/
+
+// Read-only state behind the queries. handle() is const and lock-free, so any number of
+// connections can call it at the same time.
+class QueryEngine
+{
+public:
+    // Runs the KYC BFS with predecessors once; the graphs and interner must outlive the engine
+    QueryEngine(const CSRGraph &graph, const CSRGraph &reverse_graph, const AddressInterner &interner, const std::vector<VertexId> &seeds, int max_hops);
+
+    // Response text for one request line, including the trailing newline
+    std::string handle(const std::string &request) const;
+
+    size_t num_seeds() const { return num_seeds_; }
+
+private:
+    std::string hops_response(const std::vector<std::string> &words) const;
+    std::string path_response(const std::vector<std::string> &words) const;
+    std::string bfs_response(const std::vector<std::string> &words) const;
+
+    const CSRGraph &graph_;
+    const CSRGraph &reverse_graph_;
+    const AddressInterner &interner_;
+    int max_hops_;
+    size_t num_seeds_;
+    std::vector<uint8_t> hops_;
+    std::vector<VertexId> parents_;
+};
+
+// OpenMP threads one request may use unless the server is told otherwise
+const int DEFAULT_THREADS_PER_REQUEST = 4;
+
+/*
+Serves a QueryEngine on a Unix socket or loopback TCP endpoint (see socket_io.hpp). Every
+connection gets its own thread; requests on one connection are answered in order. A request
+runs on at most threads_per_request OpenMP threads (and no more than omp_get_max_threads()),
+so concurrent BFS requests share the cores instead of each starting a full team.
+*/
+class QueryServer
+{
+public:
+    explicit QueryServer(const QueryEngine &engine, int threads_per_request = DEFAULT_THREADS_PER_REQUEST);
+
+    ~QueryServer();
+
+    QueryServer(const QueryServer &) = delete;
+    QueryServer &operator=(const QueryServer &) = delete;
+
+    // Returns false if the endpoint is malformed or cannot be bound
+    bool listen(const std::string &endpoint);
+
+    // Accepts connections until stop() is called, then waits for the open connections to finish
+    void serve();
+
+    // Safe to call from any thread
+    void stop();
+
+    // Connection threads not yet joined; closed connections are joined on the next accept poll
+    size_t num_connections();
+
+private:
+    // A connection thread and the flag it sets when its socket is closed
+    struct Connection
+    {
+        std::thread thread;
+        std::atomic<bool> done{false};
+    };
+
+    void handle_connection(int fd, std::atomic<bool> *done);
+
+    // Joins and drops the connections whose thread has finished
+    void reap_connections();
+
+    const QueryEngine &engine_;
+    int listen_fd_;
+    int threads_per_request_;
+    std::string unix_path_;
+    std::atomic<bool> stopping_;
+    std::mutex connections_mutex_;
+    // A list keeps each done flag in place while its thread runs
+    std::list<Connection> connections_;
+};
+
+#endif // QUERY_SERVER_H
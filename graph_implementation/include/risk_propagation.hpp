@@ -0,0 +1,29 @@
+#ifndef RISK_PROPAGATION_H
+#define RISK_PROPAGATION_H
+
+#include "csr_graph.hpp"
+
+// Convergence of one power iteration
+struct PageRankIterationStats
+{
+    int iteration;
+    double residual; // L1 change of the scores in this iteration
+    double seconds;  // Wall time of the iteration
+};
+
+/*
+Personalized PageRank from a seed set (e.g. known hacker addresses), weighted by transfer value.
+Every iteration keeps damping of each vertex's score flowing along its out-transfers in
+proportion to their USD weight (1 each if the graph is unweighted) and returns the rest, and
+the score of vertices without out-transfers, to the seeds in equal shares. The scores sum to 1;
+an address scores high when much of the value leaving the seeds ends up there.
+
+Each iteration is a pull-based sparse matrix-vector product over reverse_graph: the senders'
+scores are scaled by their inverse out-weight once, then every vertex sums its in-edges in a
+SIMD reduction, so the threads write disjoint scores and need no atomics. Iterates until the
+residual drops below tolerance or after max_iterations. scores gets one entry per vertex.
+Returns one entry per iteration.
+*/
+std::vector<PageRankIterationStats> personalized_pagerank(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &seeds, std::vector<double> &scores, double damping = 0.85, double tolerance = 1e-9, int max_iterations = 100);
+
+#endif // RISK_PROPAGATION_H
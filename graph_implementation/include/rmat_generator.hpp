@@ -0,0 +1,40 @@
+#ifndef RMAT_GENERATOR_H
+#define RMAT_GENERATOR_H
+
+#include "address_interner.hpp"
+
+/*
+Parameters of a synthetic transfer graph. Edges follow the R-MAT recursive quadrant model
+(Chakrabarti et al.) over 2^scale vertices, which gives the power-law degrees of the real
+transfer graph; scale 24 is about the size of the real data. On top of that, hot_wallet_share of
+the transfers go to or come from one of hot_wallets exchange-like addresses, so at full scale a
+few vertices carry millions of edges.
+*/
+struct RMATParams
+{
+    uint32_t scale = 16;
+    uint32_t edge_factor = 8;      // Transfers per vertex
+    double a = 0.57;               // Quadrant probabilities; d is 1 - a - b - c
+    double b = 0.19;
+    double c = 0.19;
+    uint32_t hot_wallets = 16;
+    double hot_wallet_share = 0.05;
+    uint64_t seed = 1;
+    size_t lines_per_chunk = 1000000;
+};
+
+// Address text of a synthetic vertex: "0x" and 40 hex digits derived from the vertex and the seed
+std::string rmat_address(uint64_t vertex, uint64_t seed);
+
+/*
+Writes 2^scale * edge_factor transfers as chunk files base_filename + 12-digit index, in the
+"address1,address2,total_transfer_usd" format of the real exports. Amounts are log-uniform
+between 1 and 100k USD, so a fifth of them fall under the 10 USD dust filter. Chunks are
+generated on all cores; the output only depends on the parameters. Returns the chunk names.
+*/
+std::vector<std::string> write_rmat_chunks(const std::string &base_filename, const RMATParams &params);
+
+// Writes a KYC file: the hot wallets followed by every stride-th vertex. Returns the number of addresses.
+size_t write_rmat_kyc(const std::string &filename, const RMATParams &params, uint64_t stride);
+
+#endif // RMAT_GENERATOR_H
@@ -0,0 +1,91 @@
+#ifndef SEMI_EXTERNAL_BFS_H
+#define SEMI_EXTERNAL_BFS_H
+
+#include "parallel_bfs.hpp"
+#include "graph_snapshot.hpp"
+#include <future>
+
+const uint32_t EDGE_PARTITIONS_VERSION = 1;
+
+// Contiguous range of source vertices whose out-lists are stored together
+struct EdgePartition
+{
+    uint64_t first_vertex;
+    uint64_t num_vertices;
+    uint64_t num_edges;
+    uint64_t file_offset; // Start of the partition's local offsets, then its neighbors
+
+    // Bytes of the partition on disk and in memory
+    uint64_t bytes() const { return (num_vertices + 1) * sizeof(uint64_t) + num_edges * sizeof(VertexId); }
+};
+
+/*
+Writes the out-lists of graph as a file of vertex-range partitions of about partition_bytes each
+(a single list larger than that gets a partition of its own), followed by the address dictionary
+and the source chunk list, so a semi-external run needs neither the chunks nor the snapshot.
+Partitions start on 4 KiB boundaries and are read with one pread each. Throws std::runtime_error
+if the file cannot be written.
+*/
+void write_edge_partitions(const std::string &filename, const CSRGraph &graph, const AddressInterner &interner, const std::vector<ChunkFingerprint> &chunks, uint64_t partition_bytes);
+
+/*
+A partition file opened for semi-external traversal. Per-vertex state lives in memory; adjacency
+stays on disk except for the leading partitions that fit in the memory budget. Two streaming
+buffers for the largest partition are always reserved out of the budget, so the adjacency never
+takes more than max(budget, 2 * largest partition).
+*/
+class PartitionedGraph
+{
+public:
+    PartitionedGraph() : fd_(-1), num_vertices_(0), num_edges_(0), max_partition_bytes_(0), num_resident_(0), bytes_read_(0) {}
+
+    ~PartitionedGraph() { close(); }
+
+    PartitionedGraph(const PartitionedGraph &) = delete;
+    PartitionedGraph &operator=(const PartitionedGraph &) = delete;
+
+    // Reads the index and the dictionary into interner and loads the partitions that fit in
+    // memory_budget bytes. Returns false (and logs) if the file is missing, corrupt, of another
+    // version or built from other chunks.
+    bool open(const std::string &filename, const std::vector<ChunkFingerprint> &expected_chunks, uint64_t memory_budget, AddressInterner &interner);
+
+    void close();
+
+    size_t num_vertices() const { return num_vertices_; }
+
+    size_t num_edges() const { return num_edges_; }
+
+    const std::vector<EdgePartition> &partitions() const { return partitions_; }
+
+    size_t num_resident() const { return num_resident_; }
+
+    uint64_t max_partition_bytes() const { return max_partition_bytes_; }
+
+    // Partition data kept in memory, or nullptr if p is streamed
+    const uint64_t *resident(size_t p) const { return p < num_resident_ ? resident_[p].data() : nullptr; }
+
+    // Reads partition p into buffer with large sequential reads; throws std::runtime_error on I/O errors
+    void read_partition(size_t p, std::vector<uint64_t> &buffer);
+
+    // Adjacency bytes read from disk since open(), resident partitions included
+    uint64_t bytes_read() const { return bytes_read_.load(std::memory_order_relaxed); }
+
+private:
+    int fd_;
+    size_t num_vertices_;
+    size_t num_edges_;
+    uint64_t max_partition_bytes_;
+    std::vector<EdgePartition> partitions_;
+    std::vector<std::vector<uint64_t>> resident_;
+    size_t num_resident_;
+    std::atomic<uint64_t> bytes_read_;
+};
+
+/*
+Top-down BFS over a partitioned graph. Each level sorts the frontier, skips the partitions it does
+not touch and expands the others in file order; streamed partitions are read on a background
+thread one ahead of the one being expanded. The distances equal those of bfs_direction_optimizing.
+*/
+std::vector<BFSLevelStats> bfs_semi_external(PartitionedGraph &graph, const std::vector<VertexId> &seeds, int max_hops, std::vector<uint8_t> &hops);
+
+#endif // SEMI_EXTERNAL_BFS_H
@@ -0,0 +1,202 @@
+#ifndef SOCKET_IO_H
+#define SOCKET_IO_H
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/*
+Endpoints are written "unix:<socket path>" or "tcp:<port>". TCP endpoints only ever bind and
+connect on the loopback interface.
+*/
+struct Endpoint
+{
+    bool is_unix;
+    std::string path;
+    int port;
+};
+
+// Returns false for anything that is not a valid endpoint
+inline bool parse_endpoint(const std::string &text, Endpoint &endpoint)
+{
+    if (text.compare(0, 5, "unix:") == 0 && text.size() > 5)
+    {
+        endpoint = Endpoint{true, text.substr(5), 0};
+        return endpoint.path.size() < sizeof(sockaddr_un::sun_path);
+    }
+    if (text.compare(0, 4, "tcp:") == 0 && text.size() > 4)
+    {
+        const std::string port = text.substr(4);
+        if (port.find_first_not_of("0123456789") != std::string::npos || port.size() > 5)
+        {
+            return false;
+        }
+        endpoint = Endpoint{false, "", std::stoi(port)};
+        return endpoint.port > 0 && endpoint.port < 65536;
+    }
+    return false;
+}
+
+// Socket address of an endpoint; returns its length
+inline socklen_t endpoint_address(const Endpoint &endpoint, sockaddr_storage &storage)
+{
+    std::memset(&storage, 0, sizeof(storage));
+    if (endpoint.is_unix)
+    {
+        sockaddr_un *address = reinterpret_cast<sockaddr_un *>(&storage);
+        address->sun_family = AF_UNIX;
+        std::strncpy(address->sun_path, endpoint.path.c_str(), sizeof(address->sun_path) - 1);
+        return sizeof(sockaddr_un);
+    }
+    sockaddr_in *address = reinterpret_cast<sockaddr_in *>(&storage);
+    address->sin_family = AF_INET;
+    address->sin_port = htons(static_cast<uint16_t>(endpoint.port));
+    address->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return sizeof(sockaddr_in);
+}
+
+// Listening socket for the endpoint, or -1. A stale Unix socket file is replaced.
+inline int open_listener(const Endpoint &endpoint)
+{
+    int fd = socket(endpoint.is_unix ? AF_UNIX : AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    if (endpoint.is_unix)
+    {
+        unlink(endpoint.path.c_str());
+    }
+    else
+    {
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    }
+    sockaddr_storage storage;
+    socklen_t length = endpoint_address(endpoint, storage);
+    if (bind(fd, reinterpret_cast<sockaddr *>(&storage), length) != 0 || listen(fd, 128) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Connected socket for the endpoint, or -1
+inline int open_connection(const Endpoint &endpoint)
+{
+    int fd = socket(endpoint.is_unix ? AF_UNIX : AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    sockaddr_storage storage;
+    socklen_t length = endpoint_address(endpoint, storage);
+    if (connect(fd, reinterpret_cast<sockaddr *>(&storage), length) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    if (!endpoint.is_unix)
+    {
+        // Requests and responses are small and latency bound
+        int no_delay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+    }
+    return fd;
+}
+
+// Writes the whole buffer, retrying short writes. Returns false once the peer is gone.
+inline bool write_all(int fd, const char *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = send(fd, data, size, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Buffered reader splitting a socket stream into '\n'-terminated lines
+class SocketLineReader
+{
+public:
+    explicit SocketLineReader(int fd = -1) : fd_(fd), start_(0) {}
+
+    void reset(int fd)
+    {
+        fd_ = fd;
+        buffer_.clear();
+        start_ = 0;
+    }
+
+    // 1 for a line (without its '\n' or '\r'), 0 if timeout_ms passed without one, -1 at the end of the stream
+    int read_line(std::string &line, int timeout_ms = -1)
+    {
+        while (true)
+        {
+            const size_t newline = buffer_.find('\n', start_);
+            if (newline != std::string::npos)
+            {
+                size_t end = newline;
+                if (end > start_ && buffer_[end - 1] == '\r')
+                {
+                    --end;
+                }
+                line.assign(buffer_, start_, end - start_);
+                start_ = newline + 1;
+                return 1;
+            }
+            // Drop the consumed prefix before reading more
+            buffer_.erase(0, start_);
+            start_ = 0;
+            if (timeout_ms >= 0)
+            {
+                pollfd waiting{fd_, POLLIN, 0};
+                int ready = poll(&waiting, 1, timeout_ms);
+                if (ready == 0 || (ready < 0 && errno == EINTR))
+                {
+                    return 0;
+                }
+                if (ready < 0)
+                {
+                    return -1;
+                }
+            }
+            char chunk[1 << 16];
+            ssize_t received = recv(fd_, chunk, sizeof(chunk), 0);
+            if (received < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (received <= 0)
+            {
+                return -1;
+            }
+            buffer_.append(chunk, static_cast<size_t>(received));
+        }
+    }
+
+private:
+    int fd_;
+    std::string buffer_;
+    size_t start_;
+};
+
+#endif // SOCKET_IO_H
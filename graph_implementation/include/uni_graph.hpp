@@ -19,6 +19,8 @@
 #include <iomanip>
 #include <mutex>
 #include <atomic>
+#include <cstdint>
+#include <algorithm>
 
 using namespace std;
 using namespace boost;
@@ -26,13 +28,95 @@ using namespace boost;
 typedef adjacency_list<vecS, vecS, directedS> Graph;
 typedef graph_traits<Graph>::vertex_descriptor Vertex;
 typedef graph_traits<Graph>::edge_descriptor Edge;
+// Dense 32-bit vertex id used by the compressed graph representations
+typedef uint32_t VertexId;
 
+class AddressInterner;
+enum class VertexOrdering : int;
+enum class HopOutputOrder;
+
+// Hop distance of every address in vertex_to_address from the KYC nodes, unreached addresses getting 6.
+// Converts graph to a CSRGraph and runs bfs_direction_optimizing (see parallel_bfs.hpp).
 void bfs_from_kyc_nodes_parallel(const Graph &graph, const std::unordered_set<Vertex> &kyc_nodes, int max_hops, std::unordered_map<string, int> &address_to_hops, const std::unordered_map<Vertex, string> &vertex_to_address);
 
 void build_graph_from_chunks(const std::string &base_filename, int num_chunks, Graph &graph, std::unordered_map<std::string, Vertex> &address_to_vertex);
 
+void build_graph_from_chunks(const std::string &base_filename, int num_chunks, Graph &graph, AddressInterner &interner);
+
 std::unordered_set<Vertex> read_kyc_addr(const std::string &kyc_address_filename, const std::unordered_map<std::string, Vertex> &address_to_vertex);
 
+std::vector<VertexId> read_kyc_addr(const std::string &kyc_address_filename, const AddressInterner &interner);
+
 int calculates_eai_dist(const std::string kyc_filename, const std::string output_filename);
 
+// Same, running the BFS on a copy of the graph relabeled by ordering (the distances are unchanged)
+// and writing the rows in order (HopOutputOrder::Sorted for ascending address)
+int calculates_eai_dist(const std::string kyc_filename, const std::string output_filename, VertexOrdering ordering, HopOutputOrder order);
+
+// Times every vertex ordering against the ingest order: relabeling cost, BFS time, speedup, and
+// how many runs it takes to pay back the relabeling
+int compare_vertex_orders(const std::string kyc_filename);
+
+// Hop distance from each labelled seed group (up to 64, one column per group) in a single traversal
+int calculates_group_dist(const std::vector<std::string> &seed_filenames, const std::string output_filename);
+
+// Hop distance from the KYC addresses over transfers of at least each threshold (USD), one column
+// per threshold. Thresholds below the 10 USD load filter behave like 10, and each applies to the
+// summed value of the rows of a pair that passed that filter (see bfs_weight_thresholds).
+int calculates_threshold_dist(const std::string kyc_filename, const std::vector<float> &thresholds, const std::string output_filename);
+
+// Hop distance from the KYC addresses and to them (against the transfer direction), both per address
+int calculates_bidirectional_dist(const std::string kyc_filename, const std::string output_filename);
+
+// For every address listed in addresses_filename, its hop distance, the KYC address it traces back
+// to and the intermediaries on one shortest path
+int calculates_eai_paths(const std::string kyc_filename, const std::string addresses_filename, const std::string output_filename);
+
+// Loads the graph once and answers hop, path and BFS queries on endpoint ("unix:<path>" or
+// "tcp:<port>") until interrupted
+int serve_queries(const std::string kyc_filename, const std::string endpoint);
+
+// Reports the memory of the byte-compressed adjacency lists against the CSR layout and the BFS
+// time on each, after checking both give the same distances
+int compare_compressed_graph(const std::string kyc_filename);
+
+/*
+calculates_eai_dist for a history that only grew: loads the distances and graph of the previous
+run, ingests just the chunks added since and lowers the distances reachable from the new
+transfers and KYC addresses. The state lives in graph.distances and its graph in its own
+graph.distances.snapshot, which no other subcommand rewrites. Falls back to a full run, saying
+why, when there is no usable previous state or a chunk was changed or removed. With verify, the
+result is checked against a full recompute.
+*/
+int update_eai_dist(const std::string kyc_filename, const std::string output_filename, bool verify);
+
+// What-if run for a changed KYC list: computes the baseline distances, applies the addresses in
+// added_filename and removed_filename (same layout as the KYC file) as a seed delta and writes
+// "address,old_hops,new_hops" for every address whose distance changed
+int calculates_seed_delta(const std::string kyc_filename, const std::string added_filename, const std::string removed_filename, const std::string output_filename);
+
+// Scores every address by the share of the value leaving the addresses in hackers_filename that
+// reaches it (personalized PageRank over the USD-weighted transfers) and writes "address,score"
+int calculates_hacker_risk(const std::string hackers_filename, const std::string output_filename, double tolerance = 1e-9, int max_iterations = 100);
+
+// Estimated number of addresses within 1 to 5 hops of every address, along the transfers and
+// against them, from HyperLogLog counters of 2^precision registers. A memory_mb above 0 lowers the
+// precision until the registers fit.
+int calculates_reach_sketches(const std::string output_filename, int precision = 6, uint64_t memory_mb = 0);
+
+// Hop distance from the KYC addresses at each YYYY-MM-DD cutoff date (one column per date), counting
+// only the pairs whose rows reached 10 USD by their first_seen dates on or before it (see
+// build_dated_csr_graph for what that means for whole-history rows); one ingest for every date
+int calculates_windowed_dist(const std::string kyc_filename, const std::vector<std::string> &cutoff_dates, const std::string output_filename);
+
+// Parses every transfer chunk once and writes the binary graph snapshot that later runs map
+int compile_graph_snapshot();
+
+// Writes the out-lists as on-disk partitions of about partition_mb each, for calculates_eai_dist_external
+int compile_edge_partitions(uint64_t partition_mb);
+
+// calculates_eai_dist on a graph larger than memory: only per-vertex state and the dictionary are
+// loaded, and the edge partitions beyond budget_mb are streamed from disk on every BFS level
+int calculates_eai_dist_external(const std::string kyc_filename, uint64_t budget_mb, const std::string output_filename);
+
 #endif // UNI_GRAPH_H
@@ -0,0 +1,53 @@
+#ifndef VERTEX_ORDER_H
+#define VERTEX_ORDER_H
+
+#include "csr_graph.hpp"
+
+/*
+Cache-locality relabeling. Vertex ids come from the order addresses first appear in the chunks,
+which scatters the neighbors of a vertex over the whole hops array and visited bitmap. A
+relabeling pass renumbers the vertices of the loaded graph so that vertices touched together get
+nearby ids; the BFS then runs on the renumbered graph and its results are mapped back to the
+original ids, so the address interner and the output never see the new ids.
+*/
+enum class VertexOrdering : int
+{
+    Original, // Ingest order, no relabeling
+    Degree,   // Descending total (in + out) degree: hubs and their hot state packed together
+    BFS,      // Discovery order of an undirected BFS from the seeds, so every level is a contiguous id range
+    RCM       // Reverse Cuthill-McKee over the undirected graph, which keeps edges close to the diagonal
+};
+
+// "original", "degree", "bfs" or "rcm"; returns false for anything else
+bool parse_vertex_ordering(const std::string &name, VertexOrdering &ordering);
+
+const char *vertex_ordering_name(VertexOrdering ordering);
+
+/*
+New id of every vertex: new_id[v] for old id v. Edges are followed in both directions (graph and
+reverse_graph). Seeds are only used by VertexOrdering::BFS; vertices it cannot reach keep their
+relative order after the reached ones. Ties are broken by old id, so the result is deterministic.
+*/
+std::vector<VertexId> compute_vertex_order(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &seeds, VertexOrdering ordering);
+
+// The graph with vertex v renamed new_id[v]. Weighted lists stay sorted by descending weight,
+// unweighted lists are sorted by ascending new id.
+CSRGraph relabel_csr_graph(const CSRGraph &graph, const std::vector<VertexId> &new_id);
+
+// new_id of every vertex in the list
+std::vector<VertexId> relabel_vertices(const std::vector<VertexId> &vertices, const std::vector<VertexId> &new_id);
+
+// Per-vertex values computed on the relabeled graph, indexed by original id again
+template <typename T>
+std::vector<T> to_original_order(const std::vector<T> &values, const std::vector<VertexId> &new_id)
+{
+    std::vector<T> original(new_id.size());
+#pragma omp parallel for schedule(static)
+    for (size_t v = 0; v < new_id.size(); ++v)
+    {
+        original[v] = values[new_id[v]];
+    }
+    return original;
+}
+
+#endif // VERTEX_ORDER_H
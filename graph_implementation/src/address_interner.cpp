@@ -0,0 +1,283 @@
+#include "address_interner.hpp"
+
+using namespace std;
+
+namespace
+{
+    inline int hex_value(char c)
+    {
+        if (c >= '0' && c <= '9')
+        {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f')
+        {
+            return c - 'a' + 10;
+        }
+        return -1;
+    }
+
+    // Addresses are already uniformly distributed, a cheap mix of the key words is enough
+    inline uint64_t hash_key(const AddressKey &key)
+    {
+        uint64_t a, b;
+        uint32_t c;
+        std::memcpy(&a, key.bytes, 8);
+        std::memcpy(&b, key.bytes + 8, 8);
+        std::memcpy(&c, key.bytes + 16, 4);
+        uint64_t h = (a ^ (b * 0x9e3779b97f4a7c15ULL) ^ c) * 0xbf58476d1ce4e5b9ULL;
+        return h ^ (h >> 31);
+    }
+}
+
+bool parse_address_key(const char *text, size_t length, AddressKey &key)
+{
+    if (length != 42 || text[0] != '0' || text[1] != 'x')
+    {
+        return false;
+    }
+    for (size_t i = 0; i < 20; ++i)
+    {
+        const int high = hex_value(text[2 + 2 * i]);
+        const int low = hex_value(text[3 + 2 * i]);
+        if (high < 0 || low < 0)
+        {
+            return false;
+        }
+        key.bytes[i] = static_cast<uint8_t>((high << 4) | low);
+    }
+    return true;
+}
+
+void format_address_key(const AddressKey &key, char *out)
+{
+    static const char digits[] = "0123456789abcdef";
+    out[0] = '0';
+    out[1] = 'x';
+    for (size_t i = 0; i < 20; ++i)
+    {
+        out[2 + 2 * i] = digits[key.bytes[i] >> 4];
+        out[3 + 2 * i] = digits[key.bytes[i] & 15];
+    }
+}
+
+std::string format_address_key(const AddressKey &key)
+{
+    std::string text(42, '0');
+    format_address_key(key, &text[0]);
+    return text;
+}
+
+AddressInterner::AddressInterner(size_t expected_addresses) : mask_(0), num_keyed_(0)
+{
+    reserve(expected_addresses);
+}
+
+void AddressInterner::reserve(size_t expected_addresses)
+{
+    keys_.reserve(expected_addresses);
+    // Keep the load factor at or below one half
+    grow(expected_addresses * 2);
+}
+
+void AddressInterner::grow(size_t min_capacity)
+{
+    size_t capacity = 1024;
+    while (capacity < min_capacity)
+    {
+        capacity <<= 1;
+    }
+    if (capacity <= slots_.size())
+    {
+        return;
+    }
+    slots_.assign(capacity, Slot{EMPTY_SLOT, 0});
+    mask_ = capacity - 1;
+    for (VertexId id = 0; id < keys_.size(); ++id)
+    {
+        if (has_key(id))
+        {
+            insert_slot(id, hash_key(keys_[id]));
+        }
+    }
+}
+
+void AddressInterner::insert_slot(VertexId id, uint64_t hash)
+{
+    uint64_t pos = hash & mask_;
+    while (slots_[pos].id != EMPTY_SLOT)
+    {
+        pos = (pos + 1) & mask_;
+    }
+    slots_[pos] = Slot{id, static_cast<uint32_t>(hash >> 32)};
+}
+
+VertexId AddressInterner::find_key(const AddressKey &key, uint64_t hash) const
+{
+    if (slots_.empty())
+    {
+        return EMPTY_SLOT;
+    }
+    const uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    uint64_t pos = hash & mask_;
+    // Linear probing: the run ends at the first empty slot
+    while (slots_[pos].id != EMPTY_SLOT)
+    {
+        if (slots_[pos].tag == tag && keys_[slots_[pos].id] == key)
+        {
+            return slots_[pos].id;
+        }
+        pos = (pos + 1) & mask_;
+    }
+    return EMPTY_SLOT;
+}
+
+VertexId AddressInterner::intern(const char *text, size_t length)
+{
+    if (keys_.size() >= std::numeric_limits<VertexId>::max())
+    {
+        throw std::runtime_error("Too many addresses for 32-bit vertex ids");
+    }
+
+    AddressKey key;
+    if (!parse_address_key(text, length, key))
+    {
+        // Fallback path for text that is not a lowercase hex address
+        auto result = fallback_ids_.try_emplace(std::string(text, length), static_cast<VertexId>(keys_.size()));
+        if (result.second)
+        {
+            fallback_addresses_.emplace(result.first->second, result.first->first);
+            keys_.push_back(AddressKey{});
+        }
+        return result.first->second;
+    }
+    return intern_key(key);
+}
+
+VertexId AddressInterner::intern_key(const AddressKey &key)
+{
+    if (keys_.size() >= std::numeric_limits<VertexId>::max())
+    {
+        throw std::runtime_error("Too many addresses for 32-bit vertex ids");
+    }
+
+    const uint64_t hash = hash_key(key);
+    VertexId id = find_key(key, hash);
+    if (id != EMPTY_SLOT)
+    {
+        return id;
+    }
+    if ((num_keyed_ + 1) * 2 > slots_.size())
+    {
+        grow(slots_.size() * 2);
+    }
+    id = static_cast<VertexId>(keys_.size());
+    keys_.push_back(key);
+    insert_slot(id, hash);
+    num_keyed_++;
+    return id;
+}
+
+bool AddressInterner::find(const char *text, size_t length, VertexId &id) const
+{
+    AddressKey key;
+    if (!parse_address_key(text, length, key))
+    {
+        auto it = fallback_ids_.find(std::string(text, length));
+        if (it == fallback_ids_.end())
+        {
+            return false;
+        }
+        id = it->second;
+        return true;
+    }
+    id = find_key(key, hash_key(key));
+    return id != EMPTY_SLOT;
+}
+
+std::string AddressInterner::address(VertexId id) const
+{
+    if (!fallback_addresses_.empty())
+    {
+        auto it = fallback_addresses_.find(id);
+        if (it != fallback_addresses_.end())
+        {
+            return it->second;
+        }
+    }
+    return format_address_key(keys_[id]);
+}
+
+size_t AddressInterner::memory_bytes() const
+{
+    size_t bytes = keys_.capacity() * sizeof(AddressKey) + slots_.capacity() * sizeof(Slot);
+    for (const auto &entry : fallback_ids_)
+    {
+        // Rough per-entry cost of the two fallback hash maps
+        bytes += 2 * (entry.first.capacity() + sizeof(std::string) + sizeof(VertexId) + 2 * sizeof(void *));
+    }
+    return bytes;
+}
+
+void AddressInterner::write_to(std::ostream &out) const
+{
+    write_pod(out, static_cast<uint64_t>(keys_.size()));
+    write_pod(out, static_cast<uint64_t>(num_keyed_));
+    write_pod(out, static_cast<uint64_t>(slots_.size()));
+    write_pod(out, static_cast<uint64_t>(fallback_addresses_.size()));
+    write_array(out, keys_.data(), keys_.size());
+    write_array(out, slots_.data(), slots_.size());
+    // Fallback strings in id order so the output does not depend on hash map iteration
+    std::vector<VertexId> fallback_ids;
+    for (const auto &entry : fallback_addresses_)
+    {
+        fallback_ids.push_back(entry.first);
+    }
+    std::sort(fallback_ids.begin(), fallback_ids.end());
+    for (const VertexId id : fallback_ids)
+    {
+        const std::string &text = fallback_addresses_.at(id);
+        write_pod(out, id);
+        write_pod(out, static_cast<uint32_t>(text.size()));
+        write_array(out, text.data(), text.size());
+    }
+}
+
+bool AddressInterner::read_from(BinaryReader &reader)
+{
+    uint64_t num_keys, num_keyed, num_slots, num_fallback;
+    if (!reader.read_pod(num_keys) || !reader.read_pod(num_keyed) || !reader.read_pod(num_slots) || !reader.read_pod(num_fallback))
+    {
+        return false;
+    }
+    // The slot table must be a power of two with room for every keyed address
+    if (num_keys > std::numeric_limits<VertexId>::max() || num_keyed + num_fallback != num_keys || num_slots < 1024 || (num_slots & (num_slots - 1)) != 0 || num_keyed * 2 > num_slots)
+    {
+        return false;
+    }
+    if (!reader.read_vector(num_keys, keys_) || !reader.read_vector(num_slots, slots_))
+    {
+        return false;
+    }
+    mask_ = num_slots - 1;
+    num_keyed_ = num_keyed;
+    fallback_ids_.clear();
+    fallback_addresses_.clear();
+    for (uint64_t i = 0; i < num_fallback; ++i)
+    {
+        VertexId id;
+        uint32_t length;
+        if (!reader.read_pod(id) || !reader.read_pod(length) || id >= num_keys)
+        {
+            return false;
+        }
+        const char *text = reader.read_array<char>(length);
+        if (!text)
+        {
+            return false;
+        }
+        fallback_ids_.emplace(std::string(text, length), id);
+        fallback_addresses_.emplace(id, std::string(text, length));
+    }
+    return true;
+}
@@ -0,0 +1,627 @@
+#include "chunk_loader.hpp"
+#include "mapped_file.hpp"
+#include <charconv>
+#include <cstdio>
+#include <map>
+#include <cstring>
+#include <glob.h>
+
+using namespace std;
+
+namespace
+{
+    // Malformed lines reported per chunk before the rest are only counted
+    const size_t MAX_REPORTED_ERRORS = 10;
+
+    // State of one chunk between the parallel parse and the ordered merge
+    struct ParsedChunk
+    {
+        AddressInterner local_interner;    // Chunk-local ids in order of first appearance
+        std::vector<TransferEdge> edges;   // Kept edges, in local ids
+        std::vector<VertexId> global_ids;  // Local id -> global id
+        std::vector<std::string> errors;   // First malformed lines
+        bool opened = false;
+        ChunkLoadStats stats;
+    };
+
+    void parse_chunk(const std::string &chunk_filename, float min_transfer_usd, ParsedChunk &chunk)
+    {
+        auto start = chrono::high_resolution_clock::now();
+        chunk.stats = ChunkLoadStats{chunk_filename, omp_get_thread_num(), 0, 0, 0, 0.0};
+
+        MappedFile file;
+        if (!file.open(chunk_filename))
+        {
+            return;
+        }
+        chunk.opened = true;
+        chunk.stats.bytes = file.size();
+        // Roughly 90 bytes per row and a few rows per distinct address
+        chunk.local_interner.reserve(file.size() / 128);
+        chunk.edges.reserve(file.size() / 96);
+
+        const char *pos = file.data();
+        const char *end = pos + file.size();
+
+        // Skip the header line
+        const char *eol = static_cast<const char *>(memchr(pos, '\n', end - pos));
+        pos = eol ? eol + 1 : end;
+        size_t line_number = 1;
+
+        TransferFields fields;
+        while (pos < end)
+        {
+            eol = static_cast<const char *>(memchr(pos, '\n', end - pos));
+            if (!eol)
+            {
+                eol = end;
+            }
+            line_number++;
+            // Blank lines (including a trailing "\r") are not rows
+            if (eol - pos > 1 || (eol - pos == 1 && *pos != '\r'))
+            {
+                chunk.stats.lines++;
+                if (parse_transfer_line(pos, eol, fields))
+                {
+                    VertexId v1 = chunk.local_interner.intern(fields.address1, fields.address1_length);
+                    VertexId v2 = chunk.local_interner.intern(fields.address2, fields.address2_length);
+                    if (v1 != v2 && fields.total_transfer_usd >= min_transfer_usd)
+                    {
+                        chunk.edges.push_back(TransferEdge{v1, v2, fields.total_transfer_usd, fields.first_seen});
+                    }
+                }
+                else
+                {
+                    chunk.stats.malformed_lines++;
+                    if (chunk.errors.size() < MAX_REPORTED_ERRORS)
+                    {
+                        chunk.errors.push_back("line " + std::to_string(line_number) + ": " + std::string(pos, eol));
+                    }
+                }
+            }
+            pos = eol + 1;
+        }
+
+        auto finish = chrono::high_resolution_clock::now();
+        chrono::duration<double> elapsed = finish - start;
+        chunk.stats.seconds = elapsed.count();
+    }
+}
+
+bool parse_transfer_line(const char *begin, const char *end, TransferFields &fields)
+{
+    if (end > begin && end[-1] == '\r')
+    {
+        --end;
+    }
+    const char *comma1 = static_cast<const char *>(memchr(begin, ',', end - begin));
+    if (!comma1)
+    {
+        return false;
+    }
+    const char *comma2 = static_cast<const char *>(memchr(comma1 + 1, ',', end - comma1 - 1));
+    if (!comma2)
+    {
+        return false;
+    }
+    fields.address1 = begin;
+    fields.address1_length = comma1 - begin;
+    fields.address2 = comma1 + 1;
+    fields.address2_length = comma2 - comma1 - 1;
+
+    // The amount ends at the next comma, if any further columns follow
+    const char *amount = comma2 + 1;
+    while (amount < end && (*amount == ' ' || *amount == '+'))
+    {
+        ++amount;
+    }
+    auto result = std::from_chars(amount, end, fields.total_transfer_usd);
+    if (result.ec != std::errc() || result.ptr == amount)
+    {
+        return false;
+    }
+
+    // Optional fourth column: the date the pair first transacted; empty or absent means undated
+    fields.first_seen = UNDATED;
+    if (result.ptr < end && *result.ptr == ',')
+    {
+        const char *date = result.ptr + 1;
+        const char *date_end = static_cast<const char *>(memchr(date, ',', end - date));
+        if (!date_end)
+        {
+            date_end = end;
+        }
+        if (date_end > date && !parse_date(date, date_end, fields.first_seen))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parse_date(const char *begin, const char *end, uint32_t &days)
+{
+    // "YYYY-MM-DD"
+    if (end - begin != 10 || begin[4] != '-' || begin[7] != '-')
+    {
+        return false;
+    }
+    int year, month, day;
+    if (std::from_chars(begin, begin + 4, year).ptr != begin + 4 || std::from_chars(begin + 5, begin + 7, month).ptr != begin + 7 || std::from_chars(begin + 8, begin + 10, day).ptr != begin + 10)
+    {
+        return false;
+    }
+    static const int days_in_month[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (year < 1970 || month < 1 || month > 12 || day < 1 || day > days_in_month[month - 1] || (month == 2 && day == 29 && !leap))
+    {
+        return false;
+    }
+    // Days from civil (Howard Hinnant), with March as the first month of the year
+    const int y = month <= 2 ? year - 1 : year;
+    const int era = y / 400;
+    const int year_of_era = y - era * 400;
+    const int day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    const int days_since_epoch = era * 146097 + day_of_era - 719468;
+    if (days_since_epoch <= static_cast<int>(UNDATED))
+    {
+        return false;
+    }
+    days = static_cast<uint32_t>(days_since_epoch);
+    return true;
+}
+
+std::string format_date(uint32_t days)
+{
+    // Civil from days (Howard Hinnant)
+    const int z = static_cast<int>(days) + 719468;
+    const int era = z / 146097;
+    const int day_of_era = z - era * 146097;
+    const int year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    const int day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const int mp = (5 * day_of_year + 2) / 153;
+    const int day = day_of_year - (153 * mp + 2) / 5 + 1;
+    const int month = mp < 10 ? mp + 3 : mp - 9;
+    const int year = year_of_era + era * 400 + (month <= 2);
+    char text[16];
+    std::snprintf(text, sizeof(text), "%04d-%02d-%02d", year, month, day);
+    return text;
+}
+
+std::vector<std::string> find_chunk_files(const std::string &base_filename)
+{
+    std::vector<std::string> chunk_files;
+    glob_t matches;
+    if (glob((base_filename + "[0-9][0-9][0-9][0-9][0-9][0-9][0-9][0-9][0-9][0-9][0-9][0-9]").c_str(), 0, nullptr, &matches) == 0)
+    {
+        // glob() sorts the names, and the zero padding makes that numeric order
+        for (size_t i = 0; i < matches.gl_pathc; ++i)
+        {
+            chunk_files.emplace_back(matches.gl_pathv[i]);
+        }
+    }
+    globfree(&matches);
+    return chunk_files;
+}
+
+std::vector<std::string> numbered_chunk_files(const std::string &base_filename, int num_chunks)
+{
+    std::vector<std::string> chunk_files;
+    std::ostringstream chunk_filename_stream;
+    for (int i = 0; i < num_chunks; ++i)
+    {
+        chunk_filename_stream.str(""); // Clear the contents
+        chunk_filename_stream.clear(); // Reset error flags
+        chunk_filename_stream << base_filename << std::setw(12) << std::setfill('0') << i;
+        chunk_files.push_back(chunk_filename_stream.str());
+    }
+    return chunk_files;
+}
+
+std::vector<ChunkLoadStats> load_transfer_chunks(const std::vector<std::string> &chunk_files, AddressInterner &interner, std::vector<TransferEdge> &edges, float min_transfer_usd)
+{
+    std::vector<ChunkLoadStats> stats;
+    const size_t wave_size = static_cast<size_t>(std::max(1, omp_get_max_threads()));
+
+    // Chunks are parsed a wave at a time so only one wave of chunk-local tables is alive
+    for (size_t wave_start = 0; wave_start < chunk_files.size(); wave_start += wave_size)
+    {
+        const size_t wave_end = std::min(chunk_files.size(), wave_start + wave_size);
+        std::vector<ParsedChunk> wave(wave_end - wave_start);
+
+#pragma omp parallel for schedule(dynamic, 1)
+        for (size_t i = wave_start; i < wave_end; ++i)
+        {
+            parse_chunk(chunk_files[i], min_transfer_usd, wave[i - wave_start]);
+        }
+
+        // Merge the chunk-local ids in chunk order, which keeps the numbering deterministic
+        std::vector<size_t> edge_offsets(wave.size() + 1, edges.size());
+        for (size_t c = 0; c < wave.size(); ++c)
+        {
+            ParsedChunk &chunk = wave[c];
+            if (!chunk.opened)
+            {
+                std::cerr << "Error: Unable to open file " << chunk.stats.filename << std::endl;
+            }
+            for (const std::string &error : chunk.errors)
+            {
+                std::cerr << "Error: Failed to parse CSV line in file " << chunk.stats.filename << ", " << error << std::endl;
+            }
+            if (chunk.stats.malformed_lines > chunk.errors.size())
+            {
+                std::cerr << "Error: " << chunk.stats.malformed_lines - chunk.errors.size() << " more malformed lines in file " << chunk.stats.filename << std::endl;
+            }
+
+            const AddressInterner &local = chunk.local_interner;
+            chunk.global_ids.resize(local.size());
+            for (VertexId id = 0; id < local.size(); ++id)
+            {
+                chunk.global_ids[id] = local.has_key(id) ? interner.intern_key(local.key(id)) : interner.intern(local.address(id));
+            }
+            edge_offsets[c + 1] = edge_offsets[c] + chunk.edges.size();
+            if (chunk.opened)
+            {
+                std::cout << "Processed file " << chunk.stats.filename << " (" << chunk.stats.lines << " lines)" << std::endl;
+                stats.push_back(chunk.stats);
+            }
+        }
+
+        // Translate the edges to global ids
+        edges.resize(edge_offsets.back());
+#pragma omp parallel for schedule(dynamic, 1)
+        for (size_t c = 0; c < wave.size(); ++c)
+        {
+            const ParsedChunk &chunk = wave[c];
+            size_t pos = edge_offsets[c];
+            for (const TransferEdge &edge : chunk.edges)
+            {
+                edges[pos++] = TransferEdge{chunk.global_ids[edge.src], chunk.global_ids[edge.dst], edge.total_transfer_usd, edge.first_seen};
+            }
+        }
+    }
+
+    // Per-thread parse throughput
+    std::map<int, std::pair<size_t, double>> thread_totals;
+    for (const ChunkLoadStats &chunk_stats : stats)
+    {
+        thread_totals[chunk_stats.thread].first += chunk_stats.bytes;
+        thread_totals[chunk_stats.thread].second += chunk_stats.seconds;
+    }
+    for (const auto &[thread, totals] : thread_totals)
+    {
+        const double megabytes = totals.first / (1024.0 * 1024.0);
+        std::cout << "Thread " << thread << " parsed " << megabytes << " MB in " << totals.second << " seconds ("
+                  << (totals.second > 0 ? megabytes / totals.second : 0.0) << " MB/s)" << std::endl;
+    }
+    return stats;
+}
+
+namespace
+{
+    // Shared by the forward and reverse builds; a reversed graph lists every edge under its target
+    CSRGraph build_csr_from_edges(size_t num_vertices, const std::vector<TransferEdge> &edges, bool reversed)
+    {
+        if (num_vertices > std::numeric_limits<VertexId>::max())
+        {
+            throw std::runtime_error("Graph has too many vertices for 32-bit vertex ids");
+        }
+        CSRGraph csr;
+        csr.offsets.assign(num_vertices + 1, 0);
+
+        // Degrees, then their prefix sum
+#pragma omp parallel for schedule(static)
+        for (size_t e = 0; e < edges.size(); ++e)
+        {
+            const VertexId owner = reversed ? edges[e].dst : edges[e].src;
+            __atomic_fetch_add(&csr.offsets[owner + 1], 1, __ATOMIC_RELAXED);
+        }
+        for (size_t v = 0; v < num_vertices; ++v)
+        {
+            csr.offsets[v + 1] += csr.offsets[v];
+        }
+
+        // Scatter the neighbors and their weights
+        csr.neighbors.resize(edges.size());
+        csr.weights.resize(edges.size());
+        std::vector<uint64_t> cursor(csr.offsets.begin(), csr.offsets.end() - 1);
+#pragma omp parallel for schedule(static)
+        for (size_t e = 0; e < edges.size(); ++e)
+        {
+            const VertexId owner = reversed ? edges[e].dst : edges[e].src;
+            const uint64_t pos = __atomic_fetch_add(&cursor[owner], 1, __ATOMIC_RELAXED);
+            csr.neighbors[pos] = reversed ? edges[e].src : edges[e].dst;
+            csr.weights[pos] = edges[e].total_transfer_usd;
+        }
+
+        // A sender/receiver pair can appear in several chunks: keep one edge carrying the summed
+        // value. unique_offsets[v + 1] first holds the merged degree of v.
+        std::vector<uint64_t> unique_offsets(num_vertices + 1, 0);
+#pragma omp parallel
+        {
+            std::vector<std::pair<VertexId, float>> list;
+#pragma omp for schedule(dynamic, 4096)
+            for (size_t v = 0; v < num_vertices; ++v)
+            {
+                const uint64_t begin = csr.offsets[v];
+                const uint64_t end = csr.offsets[v + 1];
+                if (end - begin < 2)
+                {
+                    unique_offsets[v + 1] = end - begin;
+                    continue;
+                }
+                list.clear();
+                for (uint64_t e = begin; e < end; ++e)
+                {
+                    list.emplace_back(csr.neighbors[e], csr.weights[e]);
+                }
+                // Summing in a fixed order keeps the merged value independent of thread timing
+                std::sort(list.begin(), list.end());
+                uint64_t pos = begin;
+                for (size_t i = 0; i < list.size(); ++i)
+                {
+                    if (pos > begin && csr.neighbors[pos - 1] == list[i].first)
+                    {
+                        csr.weights[pos - 1] += list[i].second;
+                        continue;
+                    }
+                    csr.neighbors[pos] = list[i].first;
+                    csr.weights[pos++] = list[i].second;
+                }
+                unique_offsets[v + 1] = pos - begin;
+            }
+        }
+        for (size_t v = 0; v < num_vertices; ++v)
+        {
+            unique_offsets[v + 1] += unique_offsets[v];
+        }
+        const uint64_t merged = edges.size() - unique_offsets[num_vertices];
+        if (merged > 0)
+        {
+            std::vector<VertexId> neighbors(unique_offsets[num_vertices]);
+            std::vector<float> weights(unique_offsets[num_vertices]);
+#pragma omp parallel for schedule(dynamic, 4096)
+            for (size_t v = 0; v < num_vertices; ++v)
+            {
+                const uint64_t length = unique_offsets[v + 1] - unique_offsets[v];
+                std::copy_n(csr.neighbors.begin() + csr.offsets[v], length, neighbors.begin() + unique_offsets[v]);
+                std::copy_n(csr.weights.begin() + csr.offsets[v], length, weights.begin() + unique_offsets[v]);
+            }
+            csr.neighbors.swap(neighbors);
+            csr.weights.swap(weights);
+            csr.offsets.swap(unique_offsets);
+            if (!reversed)
+            {
+                std::cout << "Merged " << merged << " repeated transfer pairs" << std::endl;
+            }
+        }
+
+        // Sort every list so the layout does not depend on thread timing
+        sort_by_descending_weight(csr);
+        return csr;
+    }
+}
+
+CSRGraph build_csr_graph(size_t num_vertices, const std::vector<TransferEdge> &edges)
+{
+    return build_csr_from_edges(num_vertices, edges, false);
+}
+
+CSRGraph add_edges_to_csr_graph(const CSRGraph &graph, size_t num_vertices, const std::vector<TransferEdge> &edges)
+{
+    const CSRGraph added = build_csr_graph(num_vertices, edges);
+    const size_t old_vertices = ::num_vertices(graph);
+    // Old and new out-edges of v as one list in build_csr_graph order
+    auto merge_lists = [&](size_t v, std::vector<std::pair<VertexId, float>> &list)
+    {
+        list.clear();
+        if (v < old_vertices)
+        {
+            for (uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e)
+            {
+                list.emplace_back(graph.neighbors[e], graph.weights.empty() ? 0.0f : graph.weights[e]);
+            }
+        }
+        for (uint64_t e = added.offsets[v]; e < added.offsets[v + 1]; ++e)
+        {
+            list.emplace_back(added.neighbors[e], added.weights[e]);
+        }
+        std::sort(list.begin(), list.end());
+        size_t kept = 0;
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            if (kept > 0 && list[kept - 1].first == list[i].first)
+            {
+                list[kept - 1].second += list[i].second;
+                continue;
+            }
+            list[kept++] = list[i];
+        }
+        list.resize(kept);
+        std::sort(list.begin(), list.end(), [](const std::pair<VertexId, float> &a, const std::pair<VertexId, float> &b)
+                  { return a.second != b.second ? a.second > b.second : a.first < b.first; });
+    };
+
+    // Merged degrees first, then their prefix sum, then the lists straight into place
+    CSRGraph merged;
+    merged.offsets.assign(num_vertices + 1, 0);
+#pragma omp parallel
+    {
+        std::vector<std::pair<VertexId, float>> list;
+#pragma omp for schedule(dynamic, 4096)
+        for (size_t v = 0; v < num_vertices; ++v)
+        {
+            if (out_degree(static_cast<VertexId>(v), added) == 0)
+            {
+                merged.offsets[v + 1] = v < old_vertices ? out_degree(static_cast<VertexId>(v), graph) : 0;
+                continue;
+            }
+            merge_lists(v, list);
+            merged.offsets[v + 1] = list.size();
+        }
+    }
+    for (size_t v = 0; v < num_vertices; ++v)
+    {
+        merged.offsets[v + 1] += merged.offsets[v];
+    }
+    merged.neighbors.resize(merged.offsets[num_vertices]);
+    merged.weights.resize(merged.offsets[num_vertices]);
+#pragma omp parallel
+    {
+        std::vector<std::pair<VertexId, float>> list;
+#pragma omp for schedule(dynamic, 4096)
+        for (size_t v = 0; v < num_vertices; ++v)
+        {
+            uint64_t pos = merged.offsets[v];
+            if (out_degree(static_cast<VertexId>(v), added) == 0)
+            {
+                if (v < old_vertices)
+                {
+                    std::copy(graph.neighbors.begin() + graph.offsets[v], graph.neighbors.begin() + graph.offsets[v + 1], merged.neighbors.begin() + pos);
+                    if (!graph.weights.empty())
+                    {
+                        std::copy(graph.weights.begin() + graph.offsets[v], graph.weights.begin() + graph.offsets[v + 1], merged.weights.begin() + pos);
+                    }
+                }
+                continue;
+            }
+            merge_lists(v, list);
+            for (const std::pair<VertexId, float> &edge : list)
+            {
+                merged.neighbors[pos] = edge.first;
+                merged.weights[pos++] = edge.second;
+            }
+        }
+    }
+    return merged;
+}
+
+CSRGraph build_reverse_csr_graph(size_t num_vertices, const std::vector<TransferEdge> &edges)
+{
+    return build_csr_from_edges(num_vertices, edges, true);
+}
+
+CSRGraph build_dated_csr_graph(size_t num_vertices, const std::vector<TransferEdge> &edges, std::vector<uint32_t> &first_seen, float min_transfer_usd)
+{
+    if (num_vertices > std::numeric_limits<VertexId>::max())
+    {
+        throw std::runtime_error("Graph has too many vertices for 32-bit vertex ids");
+    }
+    CSRGraph csr;
+    csr.offsets.assign(num_vertices + 1, 0);
+#pragma omp parallel for schedule(static)
+    for (size_t e = 0; e < edges.size(); ++e)
+    {
+        __atomic_fetch_add(&csr.offsets[edges[e].src + 1], 1, __ATOMIC_RELAXED);
+    }
+    for (size_t v = 0; v < num_vertices; ++v)
+    {
+        csr.offsets[v + 1] += csr.offsets[v];
+    }
+    // Edge indices grouped by sender
+    std::vector<uint64_t> order(edges.size());
+    std::vector<uint64_t> cursor(csr.offsets.begin(), csr.offsets.end() - 1);
+#pragma omp parallel for schedule(static)
+    for (size_t e = 0; e < edges.size(); ++e)
+    {
+        order[__atomic_fetch_add(&cursor[edges[e].src], 1, __ATOMIC_RELAXED)] = e;
+    }
+
+    // Merge the rows of each pair into one edge dated where their running sum reaches
+    // min_transfer_usd, then order each list by date. unique_offsets[v + 1] first holds the merged
+    // degree of v.
+    struct DatedNeighbor
+    {
+        VertexId neighbor;
+        uint32_t first_seen;
+        float weight;
+    };
+    std::vector<DatedNeighbor> dated(edges.size());
+    std::vector<uint64_t> unique_offsets(num_vertices + 1, 0);
+#pragma omp parallel for schedule(dynamic, 4096)
+    for (size_t v = 0; v < num_vertices; ++v)
+    {
+        const uint64_t begin = csr.offsets[v];
+        const uint64_t end = csr.offsets[v + 1];
+        for (uint64_t i = begin; i < end; ++i)
+        {
+            const TransferEdge &edge = edges[order[i]];
+            dated[i] = DatedNeighbor{edge.dst, edge.first_seen, edge.total_transfer_usd};
+        }
+        // Summing in a fixed order keeps the merged value independent of thread timing
+        std::sort(dated.begin() + begin, dated.begin() + end, [](const DatedNeighbor &a, const DatedNeighbor &b)
+                  { return a.neighbor != b.neighbor ? a.neighbor < b.neighbor : a.first_seen != b.first_seen ? a.first_seen < b.first_seen : a.weight < b.weight; });
+        uint64_t pos = begin;
+        for (uint64_t i = begin; i < end;)
+        {
+            DatedNeighbor merged{dated[i].neighbor, UNDATED, 0.0f};
+            bool passed = false;
+            for (; i < end && dated[i].neighbor == merged.neighbor; ++i)
+            {
+                merged.weight += dated[i].weight;
+                if (!passed && merged.weight >= min_transfer_usd)
+                {
+                    merged.first_seen = dated[i].first_seen;
+                    passed = true;
+                }
+            }
+            if (passed)
+            {
+                dated[pos++] = merged;
+            }
+        }
+        std::sort(dated.begin() + begin, dated.begin() + pos, [](const DatedNeighbor &a, const DatedNeighbor &b)
+                  { return a.first_seen != b.first_seen ? a.first_seen < b.first_seen : a.neighbor < b.neighbor; });
+        unique_offsets[v + 1] = pos - begin;
+    }
+    for (size_t v = 0; v < num_vertices; ++v)
+    {
+        unique_offsets[v + 1] += unique_offsets[v];
+    }
+
+    const uint64_t num_unique = unique_offsets[num_vertices];
+    csr.neighbors.resize(num_unique);
+    csr.weights.resize(num_unique);
+    first_seen.resize(num_unique);
+#pragma omp parallel for schedule(dynamic, 4096)
+    for (size_t v = 0; v < num_vertices; ++v)
+    {
+        uint64_t from = csr.offsets[v];
+        for (uint64_t pos = unique_offsets[v]; pos < unique_offsets[v + 1]; ++pos, ++from)
+        {
+            csr.neighbors[pos] = dated[from].neighbor;
+            csr.weights[pos] = dated[from].weight;
+            first_seen[pos] = dated[from].first_seen;
+        }
+    }
+    csr.offsets.swap(unique_offsets);
+    if (edges.size() > num_unique)
+    {
+        std::cout << "Merged " << edges.size() - num_unique << " repeated transfer pairs" << std::endl;
+    }
+    return csr;
+}
+
+void build_graph_from_chunks(const std::vector<std::string> &chunk_files, CSRGraph &graph, AddressInterner &interner)
+{
+    std::vector<TransferEdge> edges;
+    load_transfer_chunks(chunk_files, interner, edges);
+    graph = build_csr_graph(interner.size(), edges);
+}
+
+void build_graph_from_chunks(const std::vector<std::string> &chunk_files, CSRGraph &graph, CSRGraph &reverse_graph, AddressInterner &interner)
+{
+    std::vector<TransferEdge> edges;
+    load_transfer_chunks(chunk_files, interner, edges);
+    graph = build_csr_graph(interner.size(), edges);
+    reverse_graph = build_reverse_csr_graph(interner.size(), edges);
+}
+
+void build_graph_from_chunks(const std::vector<std::string> &chunk_files, CSRGraph &graph, std::vector<uint32_t> &first_seen, AddressInterner &interner)
+{
+    // Dust rows are kept: a pair can pass the filter only once its later rows are added
+    std::vector<TransferEdge> edges;
+    load_transfer_chunks(chunk_files, interner, edges, 0.0f);
+    graph = build_dated_csr_graph(interner.size(), edges, first_seen);
+}
@@ -0,0 +1,165 @@
+#include "compressed_graph.hpp"
+#include "bfs_levels.hpp"
+
+using namespace std;
+
+namespace
+{
+    size_t varint_size(uint64_t value)
+    {
+        size_t size = 1;
+        while (value >= 0x80)
+        {
+            value >>= 7;
+            ++size;
+        }
+        return size;
+    }
+
+    uint8_t *write_varint(uint64_t value, uint8_t *out)
+    {
+        while (value >= 0x80)
+        {
+            *out++ = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        *out++ = static_cast<uint8_t>(value);
+        return out;
+    }
+
+    // The neighbors of v kept by the threshold, sorted and without repeats
+    void sorted_list(VertexId v, const CSRGraph &graph, float min_weight, std::vector<VertexId> &list)
+    {
+        list.assign(graph.neighbors.begin() + graph.offsets[v], graph.neighbors.begin() + weighted_end(v, graph, min_weight));
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+    }
+
+    // Bytes of the encoded list: degree, first neighbor, gaps
+    size_t encoded_size(const std::vector<VertexId> &list)
+    {
+        size_t size = varint_size(list.size());
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            size += varint_size(i == 0 ? list[0] : list[i] - list[i - 1]);
+        }
+        return size;
+    }
+
+    // Adjacency of bfs_levels over compressed lists. A list cannot be entered mid-way, so
+    // top-down levels hand out whole frontier vertices dynamically.
+    class CompressedAdjacency
+    {
+    public:
+        CompressedAdjacency(const CompressedGraph &graph, const CompressedGraph &reverse_graph)
+            : graph_(graph), reverse_graph_(reverse_graph)
+        {
+        }
+
+        size_t vertex_count() const { return num_vertices(graph_); }
+
+        size_t edge_count() const { return num_edges(graph_); }
+
+        uint64_t degree(VertexId v) const { return out_degree(v, graph_); }
+
+        // Decodes the in-list only until visit finds what it is looking for
+        template <typename Visit>
+        void for_each_in_neighbor(VertexId v, Visit visit) const
+        {
+            VertexId u;
+            for (NeighborDecoder it(reverse_graph_, v); it.next(u) && !visit(u);)
+            {
+            }
+        }
+
+        uint64_t plan_top_down(const std::vector<VertexId> &queue) const
+        {
+            uint64_t edges = 0;
+            EAI_METRIC(for (const VertexId u : queue) { edges += degree(u); });
+            return edges;
+        }
+
+        template <typename Visit>
+        void for_each_frontier_edge(const std::vector<VertexId> &queue, Visit visit) const
+        {
+#pragma omp for schedule(dynamic, 64) nowait
+            for (size_t i = 0; i < queue.size(); ++i)
+            {
+                VertexId v;
+                for (NeighborDecoder it(graph_, queue[i]); it.next(v);)
+                {
+                    visit(queue[i], v);
+                }
+            }
+        }
+
+        void record_top_down(BFSLevelStats &) const {}
+
+    private:
+        const CompressedGraph &graph_;
+        const CompressedGraph &reverse_graph_;
+    };
+}
+
+CompressedGraph compress_csr_graph(const CSRGraph &graph, float min_weight)
+{
+    const size_t n = num_vertices(graph);
+    CompressedGraph compressed;
+    compressed.offsets.assign(n + 1, 0);
+
+    // Sizes first, then their prefix sum, then the encoding straight into place
+    size_t kept_edges = 0;
+#pragma omp parallel reduction(+ : kept_edges)
+    {
+        std::vector<VertexId> list;
+#pragma omp for schedule(dynamic, 4096)
+        for (size_t v = 0; v < n; ++v)
+        {
+            sorted_list(static_cast<VertexId>(v), graph, min_weight, list);
+            compressed.offsets[v + 1] = encoded_size(list);
+            kept_edges += list.size();
+        }
+    }
+    for (size_t v = 0; v < n; ++v)
+    {
+        compressed.offsets[v + 1] += compressed.offsets[v];
+    }
+    compressed.num_edges = kept_edges;
+    compressed.data.resize(compressed.offsets[n]);
+#pragma omp parallel
+    {
+        std::vector<VertexId> list;
+#pragma omp for schedule(dynamic, 4096)
+        for (size_t v = 0; v < n; ++v)
+        {
+            sorted_list(static_cast<VertexId>(v), graph, min_weight, list);
+            uint8_t *out = write_varint(list.size(), compressed.data.data() + compressed.offsets[v]);
+            for (size_t i = 0; i < list.size(); ++i)
+            {
+                out = write_varint(i == 0 ? list[0] : list[i] - list[i - 1], out);
+            }
+        }
+    }
+    return compressed;
+}
+
+size_t num_vertices(const CompressedGraph &graph)
+{
+    return graph.offsets.empty() ? 0 : graph.offsets.size() - 1;
+}
+
+size_t num_edges(const CompressedGraph &graph)
+{
+    return graph.num_edges;
+}
+
+size_t memory_bytes(const CompressedGraph &graph)
+{
+    return graph.offsets.capacity() * sizeof(uint64_t) + graph.data.capacity();
+}
+
+std::vector<BFSLevelStats> bfs_compressed(const CompressedGraph &graph, const CompressedGraph &reverse_graph, const std::vector<VertexId> &seeds, int max_hops, std::vector<uint8_t> &hops, int alpha, int beta)
+{
+    CompressedAdjacency adjacency(graph, reverse_graph);
+    return bfs_levels(adjacency, seeds, max_hops, hops, alpha, beta, nullptr, false);
+}
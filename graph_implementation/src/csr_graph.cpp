@@ -0,0 +1,138 @@
+#include "csr_graph.hpp"
+
+using namespace std;
+using namespace boost;
+
+CSRGraph build_csr_graph(const Graph &graph)
+{
+    CSRGraph csr;
+    const size_t n = boost::num_vertices(graph);
+    if (n > std::numeric_limits<VertexId>::max())
+    {
+        throw std::runtime_error("Graph has too many vertices for 32-bit vertex ids");
+    }
+
+    // Prefix sum of the out-degrees gives the start of every adjacency list
+    csr.offsets.assign(n + 1, 0);
+    for (size_t v = 0; v < n; ++v)
+    {
+        csr.offsets[v + 1] = csr.offsets[v] + out_degree(v, graph);
+    }
+    csr.neighbors.resize(csr.offsets[n]);
+
+    // Copy the adjacency lists, keeping the order in which edges were added
+#pragma omp parallel for schedule(dynamic, 4096)
+    for (size_t v = 0; v < n; ++v)
+    {
+        uint64_t pos = csr.offsets[v];
+        graph_traits<Graph>::adjacency_iterator ai, ai_end;
+        for (tie(ai, ai_end) = adjacent_vertices(v, graph); ai != ai_end; ++ai)
+        {
+            csr.neighbors[pos++] = static_cast<VertexId>(*ai);
+        }
+    }
+    return csr;
+}
+
+size_t num_vertices(const CSRGraph &graph)
+{
+    return graph.offsets.empty() ? 0 : graph.offsets.size() - 1;
+}
+
+size_t num_edges(const CSRGraph &graph)
+{
+    return graph.neighbors.size();
+}
+
+size_t memory_bytes(const CSRGraph &graph)
+{
+    return graph.offsets.capacity() * sizeof(uint64_t) + graph.neighbors.capacity() * sizeof(VertexId) + weight_memory_bytes(graph);
+}
+
+size_t weight_memory_bytes(const CSRGraph &graph)
+{
+    return graph.weights.capacity() * sizeof(float);
+}
+
+CSRGraph transpose_csr_graph(const CSRGraph &graph)
+{
+    CSRGraph reverse;
+    const size_t n = num_vertices(graph);
+    const bool weighted = !graph.weights.empty();
+
+    // Count the in-degree of every vertex
+    reverse.offsets.assign(n + 1, 0);
+#pragma omp parallel for schedule(static)
+    for (size_t e = 0; e < graph.neighbors.size(); ++e)
+    {
+        __atomic_fetch_add(&reverse.offsets[graph.neighbors[e] + 1], 1, __ATOMIC_RELAXED);
+    }
+    for (size_t v = 0; v < n; ++v)
+    {
+        reverse.offsets[v + 1] += reverse.offsets[v];
+    }
+
+    // Scatter the sources on all cores, then sort every in-list so the layout does not depend on thread timing
+    reverse.neighbors.resize(graph.neighbors.size());
+    reverse.weights.resize(graph.weights.size());
+    std::vector<uint64_t> cursor(reverse.offsets.begin(), reverse.offsets.end() - 1);
+#pragma omp parallel for schedule(dynamic, 4096)
+    for (size_t u = 0; u < n; ++u)
+    {
+        for (uint64_t e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e)
+        {
+            const uint64_t pos = __atomic_fetch_add(&cursor[graph.neighbors[e]], 1, __ATOMIC_RELAXED);
+            reverse.neighbors[pos] = static_cast<VertexId>(u);
+            if (weighted)
+            {
+                reverse.weights[pos] = graph.weights[e];
+            }
+        }
+    }
+    if (weighted)
+    {
+        sort_by_descending_weight(reverse);
+    }
+    else
+    {
+#pragma omp parallel for schedule(dynamic, 4096)
+        for (size_t v = 0; v < n; ++v)
+        {
+            std::sort(reverse.neighbors.begin() + reverse.offsets[v], reverse.neighbors.begin() + reverse.offsets[v + 1]);
+        }
+    }
+    return reverse;
+}
+
+void sort_by_descending_weight(CSRGraph &graph)
+{
+    const size_t n = num_vertices(graph);
+#pragma omp parallel
+    {
+        // (weight, neighbor) pairs of one list, reused across the lists of a thread
+        std::vector<std::pair<float, VertexId>> list;
+#pragma omp for schedule(dynamic, 4096)
+        for (size_t v = 0; v < n; ++v)
+        {
+            const uint64_t begin = graph.offsets[v];
+            const uint64_t end = graph.offsets[v + 1];
+            if (end - begin < 2)
+            {
+                continue;
+            }
+            list.resize(end - begin);
+            for (uint64_t e = begin; e < end; ++e)
+            {
+                list[e - begin] = {graph.weights[e], graph.neighbors[e]};
+            }
+            // Ties keep ascending neighbor order so the layout is deterministic
+            std::sort(list.begin(), list.end(), [](const std::pair<float, VertexId> &a, const std::pair<float, VertexId> &b)
+                      { return a.first != b.first ? a.first > b.first : a.second < b.second; });
+            for (uint64_t e = begin; e < end; ++e)
+            {
+                graph.weights[e] = list[e - begin].first;
+                graph.neighbors[e] = list[e - begin].second;
+            }
+        }
+    }
+}
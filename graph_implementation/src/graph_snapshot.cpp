@@ -0,0 +1,279 @@
+#include "graph_snapshot.hpp"
+#include "chunk_loader.hpp"
+#include "mapped_file.hpp"
+#include <cstdio>
+
+using namespace std;
+
+namespace
+{
+    const char SNAPSHOT_MAGIC[8] = {'E', 'A', 'I', 'G', 'R', 'A', 'P', 'H'};
+
+    // Fixed-size header at the start of the file; the checksum covers everything after it
+    struct SnapshotHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t num_vertices;
+        uint64_t num_edges;
+        uint64_t payload_bytes;
+        uint64_t checksum;
+    };
+
+    inline uint64_t mix_word(uint64_t hash, uint64_t word)
+    {
+        hash ^= word;
+        hash = (hash << 29) | (hash >> 35);
+        return hash * 0xbf58476d1ce4e5b9ULL;
+    }
+
+    void save_snapshot(const std::string &snapshot_filename, const CSRGraph &graph, const AddressInterner &interner, const std::vector<ChunkFingerprint> &chunks)
+    {
+        try
+        {
+            write_graph_snapshot(snapshot_filename, graph, interner, chunks);
+            std::cout << "Wrote graph snapshot " << snapshot_filename << std::endl;
+        }
+        catch (const std::exception &e)
+        {
+            // The run can go on without a snapshot, the next one will simply rebuild again
+            std::cerr << "Error: " << e.what() << std::endl;
+        }
+    }
+}
+
+std::vector<ChunkFingerprint> fingerprint_chunks(const std::vector<std::string> &chunk_files)
+{
+    std::vector<ChunkFingerprint> chunks;
+    for (const std::string &chunk_filename : chunk_files)
+    {
+        struct stat file_stat;
+        if (stat(chunk_filename.c_str(), &file_stat) != 0)
+        {
+            // A missing file still takes part in the comparison
+            chunks.push_back(ChunkFingerprint{chunk_filename, 0, -1});
+            continue;
+        }
+        const int64_t modified_time = static_cast<int64_t>(file_stat.st_mtim.tv_sec) * 1000000000 + file_stat.st_mtim.tv_nsec;
+        chunks.push_back(ChunkFingerprint{chunk_filename, static_cast<uint64_t>(file_stat.st_size), modified_time});
+    }
+    return chunks;
+}
+
+void write_chunk_list(std::ostream &out, const std::vector<ChunkFingerprint> &chunks)
+{
+    write_pod(out, static_cast<uint64_t>(chunks.size()));
+    for (const ChunkFingerprint &chunk : chunks)
+    {
+        write_pod(out, chunk.size);
+        write_pod(out, chunk.modified_time);
+        write_pod(out, static_cast<uint64_t>(chunk.filename.size()));
+        write_array(out, chunk.filename.data(), chunk.filename.size());
+    }
+}
+
+bool read_chunk_list(BinaryReader &reader, std::vector<ChunkFingerprint> &chunks)
+{
+    uint64_t num_chunks = 0;
+    chunks.clear();
+    if (reader.read_pod(num_chunks))
+    {
+        for (uint64_t i = 0; i < num_chunks && !reader.failed(); ++i)
+        {
+            ChunkFingerprint chunk;
+            uint64_t name_length = 0;
+            reader.read_pod(chunk.size);
+            reader.read_pod(chunk.modified_time);
+            reader.read_pod(name_length);
+            const char *name = reader.read_array<char>(name_length);
+            if (name)
+            {
+                chunk.filename.assign(name, name_length);
+                chunks.push_back(chunk);
+            }
+        }
+    }
+    return !reader.failed();
+}
+
+uint64_t snapshot_checksum(const char *data, size_t size)
+{
+    const size_t block = 1 << 20;
+    const size_t num_blocks = (size + block - 1) / block;
+    std::vector<uint64_t> block_hashes(num_blocks);
+
+#pragma omp parallel for schedule(static)
+    for (size_t b = 0; b < num_blocks; ++b)
+    {
+        const char *begin = data + b * block;
+        const size_t length = std::min(block, size - b * block);
+        uint64_t hash = 0x9e3779b97f4a7c15ULL ^ b;
+        size_t i = 0;
+        for (; i + 8 <= length; i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, begin + i, 8);
+            hash = mix_word(hash, word);
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, begin + i, length - i);
+        block_hashes[b] = mix_word(hash, tail ^ length);
+    }
+
+    uint64_t checksum = size;
+    for (const uint64_t block_hash : block_hashes)
+    {
+        checksum = mix_word(checksum, block_hash);
+    }
+    return checksum;
+}
+
+void write_graph_snapshot(const std::string &snapshot_filename, const CSRGraph &graph, const AddressInterner &interner, const std::vector<ChunkFingerprint> &chunks)
+{
+    const std::string temporary_filename = snapshot_filename + ".tmp";
+    {
+        std::ofstream out(temporary_filename, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            throw std::runtime_error("Unable to open snapshot file " + temporary_filename);
+        }
+
+        // The header is patched with the payload size and checksum once the payload is on disk
+        SnapshotHeader header{};
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = GRAPH_SNAPSHOT_VERSION;
+        header.num_vertices = num_vertices(graph);
+        header.num_edges = num_edges(graph);
+        write_pod(out, header);
+
+        write_chunk_list(out, chunks);
+        write_array(out, graph.offsets.data(), graph.offsets.size());
+        write_array(out, graph.neighbors.data(), graph.neighbors.size());
+        // Edge weights, absent for an unweighted graph
+        write_pod(out, static_cast<uint64_t>(graph.weights.size()));
+        write_array(out, graph.weights.data(), graph.weights.size());
+        interner.write_to(out);
+        if (!out)
+        {
+            throw std::runtime_error("Failed to write snapshot file " + temporary_filename);
+        }
+    }
+
+    SnapshotHeader header{};
+    {
+        MappedFile file(temporary_filename);
+        if (!file.is_open() || file.size() < sizeof(SnapshotHeader))
+        {
+            throw std::runtime_error("Unable to reopen snapshot file " + temporary_filename);
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        header.payload_bytes = file.size() - sizeof(SnapshotHeader);
+        header.checksum = snapshot_checksum(file.data() + sizeof(SnapshotHeader), header.payload_bytes);
+    }
+    {
+        std::fstream out(temporary_filename, std::ios::binary | std::ios::in | std::ios::out);
+        out.seekp(0);
+        write_pod(out, header);
+        if (!out)
+        {
+            throw std::runtime_error("Failed to write snapshot header " + temporary_filename);
+        }
+    }
+    if (std::rename(temporary_filename.c_str(), snapshot_filename.c_str()) != 0)
+    {
+        throw std::runtime_error("Unable to move snapshot into place at " + snapshot_filename);
+    }
+}
+
+bool read_graph_snapshot(const std::string &snapshot_filename, const std::vector<ChunkFingerprint> &expected_chunks, CSRGraph &graph, AddressInterner &interner)
+{
+    MappedFile file;
+    if (!file.open(snapshot_filename))
+    {
+        std::cout << "No graph snapshot at " << snapshot_filename << std::endl;
+        return false;
+    }
+    SnapshotHeader header;
+    if (file.size() < sizeof(header))
+    {
+        std::cerr << "Error: Graph snapshot " << snapshot_filename << " is truncated" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0)
+    {
+        std::cerr << "Error: " << snapshot_filename << " is not a graph snapshot" << std::endl;
+        return false;
+    }
+    if (header.version != GRAPH_SNAPSHOT_VERSION)
+    {
+        std::cout << "Graph snapshot version " << header.version << " is outdated (expected " << GRAPH_SNAPSHOT_VERSION << ")" << std::endl;
+        return false;
+    }
+    const char *payload = file.data() + sizeof(header);
+    if (header.payload_bytes != file.size() - sizeof(header) || snapshot_checksum(payload, header.payload_bytes) != header.checksum)
+    {
+        std::cerr << "Error: Graph snapshot " << snapshot_filename << " failed its checksum" << std::endl;
+        return false;
+    }
+
+    BinaryReader reader(payload, header.payload_bytes);
+    std::vector<ChunkFingerprint> chunks;
+    if (!read_chunk_list(reader, chunks))
+    {
+        std::cerr << "Error: Graph snapshot " << snapshot_filename << " has a corrupt chunk list" << std::endl;
+        return false;
+    }
+    if (chunks != expected_chunks)
+    {
+        std::cout << "Graph snapshot " << snapshot_filename << " is stale: its source chunks changed" << std::endl;
+        return false;
+    }
+
+    uint64_t num_weights = 0;
+    if (!reader.read_vector(header.num_vertices + 1, graph.offsets) || !reader.read_vector(header.num_edges, graph.neighbors) || !reader.read_pod(num_weights) || (num_weights != 0 && num_weights != header.num_edges) || !reader.read_vector(num_weights, graph.weights) || !interner.read_from(reader) || graph.offsets.back() != header.num_edges || interner.size() != header.num_vertices)
+    {
+        std::cerr << "Error: Graph snapshot " << snapshot_filename << " has inconsistent sections" << std::endl;
+        graph = CSRGraph();
+        interner = AddressInterner();
+        return false;
+    }
+    return true;
+}
+
+bool load_or_build_graph(const std::vector<std::string> &chunk_files, const std::string &snapshot_filename, CSRGraph &graph, AddressInterner &interner)
+{
+    auto start = chrono::high_resolution_clock::now();
+    std::vector<ChunkFingerprint> chunks = fingerprint_chunks(chunk_files);
+    if (read_graph_snapshot(snapshot_filename, chunks, graph, interner))
+    {
+        chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+        std::cout << "Loaded graph snapshot " << snapshot_filename << " in " << elapsed.count() << " seconds" << std::endl;
+        return true;
+    }
+
+    std::cout << "Rebuilding the graph from " << chunk_files.size() << " chunks" << std::endl;
+    build_graph_from_chunks(chunk_files, graph, interner);
+    save_snapshot(snapshot_filename, graph, interner, chunks);
+    return false;
+}
+
+bool load_or_build_graph(const std::vector<std::string> &chunk_files, const std::string &snapshot_filename, CSRGraph &graph, CSRGraph &reverse_graph, AddressInterner &interner)
+{
+    auto start = chrono::high_resolution_clock::now();
+    std::vector<ChunkFingerprint> chunks = fingerprint_chunks(chunk_files);
+    if (read_graph_snapshot(snapshot_filename, chunks, graph, interner))
+    {
+        // The snapshot only holds the forward lists, their transpose is cheaper to rebuild than to store
+        reverse_graph = transpose_csr_graph(graph);
+        chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+        std::cout << "Loaded graph snapshot " << snapshot_filename << " in " << elapsed.count() << " seconds" << std::endl;
+        return true;
+    }
+
+    std::cout << "Rebuilding the graph from " << chunk_files.size() << " chunks" << std::endl;
+    build_graph_from_chunks(chunk_files, graph, reverse_graph, interner);
+    save_snapshot(snapshot_filename, graph, interner, chunks);
+    return false;
+}
@@ -0,0 +1,453 @@
+#include "hop_output.hpp"
+#include "mapped_file.hpp"
+#include <cstdio>
+#include <parallel/algorithm>
+
+using namespace std;
+
+namespace
+{
+    const char HOPS_MAGIC[8] = {'E', 'A', 'I', 'H', 'O', 'P', 'S', '1'};
+
+    // Vertices formatted by one thread before the buffers are flushed
+    const size_t OUTPUT_BLOCK = 1 << 16;
+
+    struct HopsHeader
+    {
+        char magic[8];
+        uint64_t record_count;
+        uint64_t fallback_count;
+        uint32_t unreached_hops;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(HopsHeader) == 32, "the header layout is documented in hop_output.hpp");
+
+    struct HopRecord
+    {
+        AddressKey key;
+        uint8_t hops;
+    };
+    static_assert(sizeof(HopRecord) == 21, "records are packed back to back");
+
+    inline uint8_t output_hops(const std::vector<uint8_t> &hops, size_t index, uint8_t unreached_hops)
+    {
+        return (index < hops.size() && hops[index] != UNVISITED_HOPS) ? hops[index] : unreached_hops;
+    }
+
+    inline char *format_hops(uint8_t value, char *out)
+    {
+        if (value >= 100)
+        {
+            *out++ = static_cast<char>('0' + value / 100);
+        }
+        if (value >= 10)
+        {
+            *out++ = static_cast<char>('0' + (value / 10) % 10);
+        }
+        *out++ = static_cast<char>('0' + value % 10);
+        return out;
+    }
+
+    FILE *open_output(const std::string &filename)
+    {
+        FILE *out = std::fopen(filename.c_str(), "wb");
+        if (!out)
+        {
+            throw std::runtime_error("Unable to open output file " + filename);
+        }
+        // Large stdio buffer, the blocks are handed over in big writes anyway
+        std::setvbuf(out, nullptr, _IOFBF, 1 << 22);
+        return out;
+    }
+
+    void write_buffer(FILE *out, const char *data, size_t size, const std::string &filename)
+    {
+        if (size > 0 && std::fwrite(data, 1, size, out) != size)
+        {
+            std::fclose(out);
+            throw std::runtime_error("Failed to write output file " + filename);
+        }
+    }
+
+    void report_throughput(const char *what, const std::string &filename, size_t bytes, chrono::high_resolution_clock::time_point start)
+    {
+        chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+        const double megabytes = bytes / (1024.0 * 1024.0);
+        std::cout << "Wrote " << megabytes << " MB of " << what << " to " << filename << " in " << elapsed.count() << " seconds ("
+                  << (elapsed.count() > 0 ? megabytes / elapsed.count() : 0.0) << " MB/s)" << std::endl;
+    }
+
+    // "address,value..." lines for num_columns values per vertex (values[v * num_columns + c]),
+    // each printed with format, formatted on all cores in blocks and written in order
+    template <typename T>
+    size_t write_value_columns_text(const std::string &filename, const std::vector<T> &values, size_t num_columns, const std::string &header, const char *format, const char *what, const AddressInterner &interner, HopOutputOrder order)
+    {
+        auto start = chrono::high_resolution_clock::now();
+        std::vector<VertexId> ids;
+        if (order != HopOutputOrder::VertexOrder)
+        {
+            ids = output_order(interner, order);
+        }
+        const size_t n = interner.size();
+        const size_t num_threads = static_cast<size_t>(std::max(1, omp_get_max_threads()));
+        std::vector<std::string> buffers(num_threads);
+        FILE *out = open_output(filename);
+        write_buffer(out, header.data(), header.size(), filename);
+        write_buffer(out, "\n", 1, filename);
+        size_t bytes_written = header.size() + 1;
+
+        for (size_t round_start = 0; round_start < n; round_start += num_threads * OUTPUT_BLOCK)
+        {
+#pragma omp parallel for schedule(static, 1)
+            for (size_t t = 0; t < num_threads; ++t)
+            {
+                const size_t begin = std::min(n, round_start + t * OUTPUT_BLOCK);
+                const size_t end = std::min(n, begin + OUTPUT_BLOCK);
+                std::string &buffer = buffers[t];
+                buffer.clear();
+                char digits[32];
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const VertexId v = ids.empty() ? static_cast<VertexId>(i) : ids[i];
+                    buffer += interner.address(v);
+                    for (size_t c = 0; c < num_columns; ++c)
+                    {
+                        const size_t index = v * num_columns + c;
+                        buffer += ',';
+                        buffer.append(digits, std::snprintf(digits, sizeof(digits), format, index < values.size() ? static_cast<double>(values[index]) : 0.0));
+                    }
+                    buffer += '\n';
+                }
+            }
+            for (size_t t = 0; t < num_threads; ++t)
+            {
+                write_buffer(out, buffers[t].data(), buffers[t].size(), filename);
+                bytes_written += buffers[t].size();
+            }
+        }
+        if (std::fclose(out) != 0)
+        {
+            throw std::runtime_error("Failed to close output file " + filename);
+        }
+        report_throughput(what, filename, bytes_written, start);
+        return bytes_written;
+    }
+}
+
+std::vector<VertexId> output_order(const AddressInterner &interner, HopOutputOrder order)
+{
+    std::vector<VertexId> ids(interner.size());
+#pragma omp parallel for schedule(static)
+    for (size_t v = 0; v < ids.size(); ++v)
+    {
+        ids[v] = static_cast<VertexId>(v);
+    }
+    if (order == HopOutputOrder::Sorted)
+    {
+        // Byte order of the keys is the order of their lowercase hex text
+        auto address_less = [&interner](VertexId a, VertexId b)
+        {
+            if (interner.has_key(a) && interner.has_key(b))
+            {
+                return std::memcmp(interner.key(a).bytes, interner.key(b).bytes, sizeof(AddressKey)) < 0;
+            }
+            return interner.address(a) < interner.address(b);
+        };
+        __gnu_parallel::sort(ids.begin(), ids.end(), address_less);
+    }
+    return ids;
+}
+
+size_t write_hops_text(const std::string &filename, const std::vector<uint8_t> &hops, const AddressInterner &interner, uint8_t unreached_hops, HopOutputOrder order)
+{
+    return write_hop_columns_text(filename, hops, 1, "", interner, unreached_hops, order);
+}
+
+size_t write_hop_columns_text(const std::string &filename, const std::vector<uint8_t> &hops, size_t num_columns, const std::string &header, const AddressInterner &interner, uint8_t unreached_hops, HopOutputOrder order)
+{
+    auto start = chrono::high_resolution_clock::now();
+    std::vector<VertexId> ids;
+    if (order != HopOutputOrder::VertexOrder)
+    {
+        ids = output_order(interner, order);
+    }
+    const size_t n = interner.size();
+    // Longest line for a keyed address: 42 characters, then a comma and up to three digits per column, and a newline
+    const size_t max_keyed_line = 42 + 4 * num_columns + 1;
+    const size_t num_threads = static_cast<size_t>(std::max(1, omp_get_max_threads()));
+    std::vector<std::string> buffers(num_threads);
+    std::vector<size_t> lengths(num_threads);
+    FILE *out = open_output(filename);
+    size_t bytes_written = 0;
+    if (!header.empty())
+    {
+        write_buffer(out, header.data(), header.size(), filename);
+        write_buffer(out, "\n", 1, filename);
+        bytes_written += header.size() + 1;
+    }
+
+    // Each round formats one block per thread in parallel, then writes the blocks in order
+    for (size_t round_start = 0; round_start < n; round_start += num_threads * OUTPUT_BLOCK)
+    {
+#pragma omp parallel for schedule(static, 1)
+        for (size_t t = 0; t < num_threads; ++t)
+        {
+            const size_t begin = std::min(n, round_start + t * OUTPUT_BLOCK);
+            const size_t end = std::min(n, begin + OUTPUT_BLOCK);
+            std::string &buffer = buffers[t];
+            buffer.resize((end - begin) * max_keyed_line);
+            size_t length = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                const VertexId v = ids.empty() ? static_cast<VertexId>(i) : ids[i];
+                char *pos;
+                if (interner.has_key(v))
+                {
+                    pos = &buffer[length];
+                    format_address_key(interner.key(v), pos);
+                    pos += 42;
+                }
+                else
+                {
+                    // Fallback addresses can be of any length
+                    const std::string address = interner.address(v);
+                    if (length + address.size() + (end - i) * max_keyed_line > buffer.size())
+                    {
+                        buffer.resize(length + address.size() + (end - i) * max_keyed_line);
+                    }
+                    pos = &buffer[length];
+                    std::memcpy(pos, address.data(), address.size());
+                    pos += address.size();
+                }
+                for (size_t c = 0; c < num_columns; ++c)
+                {
+                    *pos++ = ',';
+                    pos = format_hops(output_hops(hops, v * num_columns + c, unreached_hops), pos);
+                }
+                *pos++ = '\n';
+                length = pos - buffer.data();
+            }
+            lengths[t] = length;
+        }
+        for (size_t t = 0; t < num_threads; ++t)
+        {
+            write_buffer(out, buffers[t].data(), lengths[t], filename);
+            bytes_written += lengths[t];
+        }
+    }
+    if (std::fclose(out) != 0)
+    {
+        throw std::runtime_error("Failed to close output file " + filename);
+    }
+    report_throughput("hop counts", filename, bytes_written, start);
+    return bytes_written;
+}
+
+size_t write_paths_text(const std::string &filename, const std::vector<VertexId> &targets, const std::vector<uint8_t> &hops, const std::vector<VertexId> &parents, const AddressInterner &interner, uint8_t unreached_hops)
+{
+    auto start = chrono::high_resolution_clock::now();
+    const size_t num_threads = static_cast<size_t>(std::max(1, omp_get_max_threads()));
+    std::vector<std::string> buffers(num_threads);
+    FILE *out = open_output(filename);
+    const std::string header = "address,hops,seed,path\n";
+    write_buffer(out, header.data(), header.size(), filename);
+    size_t bytes_written = header.size();
+
+    for (size_t round_start = 0; round_start < targets.size(); round_start += num_threads * OUTPUT_BLOCK)
+    {
+#pragma omp parallel for schedule(static, 1)
+        for (size_t t = 0; t < num_threads; ++t)
+        {
+            const size_t begin = std::min(targets.size(), round_start + t * OUTPUT_BLOCK);
+            const size_t end = std::min(targets.size(), begin + OUTPUT_BLOCK);
+            std::string &buffer = buffers[t];
+            buffer.clear();
+            char digits[4];
+            for (size_t i = begin; i < end; ++i)
+            {
+                const VertexId v = targets[i];
+                const std::vector<VertexId> path = trace_path(v, parents);
+                buffer += interner.address(v);
+                buffer += ',';
+                buffer.append(digits, format_hops(output_hops(hops, v, unreached_hops), digits) - digits);
+                buffer += ',';
+                // Unreached addresses get empty seed and path fields
+                if (!path.empty())
+                {
+                    buffer += interner.address(path.front());
+                    buffer += ',';
+                    for (size_t p = 0; p < path.size(); ++p)
+                    {
+                        if (p > 0)
+                        {
+                            buffer += '>';
+                        }
+                        buffer += interner.address(path[p]);
+                    }
+                }
+                else
+                {
+                    buffer += ',';
+                }
+                buffer += '\n';
+            }
+        }
+        for (size_t t = 0; t < num_threads; ++t)
+        {
+            write_buffer(out, buffers[t].data(), buffers[t].size(), filename);
+            bytes_written += buffers[t].size();
+        }
+    }
+    if (std::fclose(out) != 0)
+    {
+        throw std::runtime_error("Failed to close output file " + filename);
+    }
+    report_throughput("paths", filename, bytes_written, start);
+    return bytes_written;
+}
+
+size_t write_scores_text(const std::string &filename, const std::vector<double> &scores, const AddressInterner &interner, HopOutputOrder order)
+{
+    // Round-trip precision, the scores of far-away addresses are tiny
+    return write_value_columns_text(filename, scores, 1, "address,score", "%.17g", "scores", interner, order);
+}
+
+size_t write_reach_text(const std::string &filename, const std::vector<float> &reach, size_t num_columns, const std::string &header, const AddressInterner &interner, HopOutputOrder order)
+{
+    // Estimates rounded to whole addresses
+    return write_value_columns_text(filename, reach, num_columns, header, "%.0f", "reach estimates", interner, order);
+}
+
+size_t write_hops_binary(const std::string &filename, const std::vector<uint8_t> &hops, const AddressInterner &interner, uint8_t unreached_hops, HopOutputOrder order)
+{
+    auto start = chrono::high_resolution_clock::now();
+    std::vector<VertexId> ids = output_order(interner, order);
+
+    // Keyed addresses become fixed 21-byte records, the others go to the fallback section
+    std::vector<VertexId> keyed_ids, fallback_ids;
+    keyed_ids.reserve(ids.size());
+    for (const VertexId v : ids)
+    {
+        (interner.has_key(v) ? keyed_ids : fallback_ids).push_back(v);
+    }
+    ids.clear();
+    ids.shrink_to_fit();
+
+    std::ostringstream header_stream;
+    HopsHeader header{};
+    std::memcpy(header.magic, HOPS_MAGIC, sizeof(header.magic));
+    header.record_count = keyed_ids.size();
+    header.fallback_count = fallback_ids.size();
+    header.unreached_hops = unreached_hops;
+    write_pod(header_stream, header);
+
+    FILE *out = open_output(filename);
+    size_t bytes_written = header_stream.str().size();
+    write_buffer(out, header_stream.str().data(), bytes_written, filename);
+
+    const size_t record_size = sizeof(HopRecord);
+    const size_t num_threads = static_cast<size_t>(std::max(1, omp_get_max_threads()));
+    std::vector<std::string> buffers(num_threads);
+    for (size_t round_start = 0; round_start < keyed_ids.size(); round_start += num_threads * OUTPUT_BLOCK)
+    {
+#pragma omp parallel for schedule(static, 1)
+        for (size_t t = 0; t < num_threads; ++t)
+        {
+            const size_t begin = std::min(keyed_ids.size(), round_start + t * OUTPUT_BLOCK);
+            const size_t end = std::min(keyed_ids.size(), begin + OUTPUT_BLOCK);
+            std::string &buffer = buffers[t];
+            buffer.resize((end - begin) * record_size);
+            char *pos = &buffer[0];
+            for (size_t i = begin; i < end; ++i)
+            {
+                std::memcpy(pos, interner.key(keyed_ids[i]).bytes, sizeof(AddressKey));
+                pos[sizeof(AddressKey)] = static_cast<char>(output_hops(hops, keyed_ids[i], unreached_hops));
+                pos += record_size;
+            }
+        }
+        for (size_t t = 0; t < num_threads; ++t)
+        {
+            write_buffer(out, buffers[t].data(), buffers[t].size(), filename);
+            bytes_written += buffers[t].size();
+        }
+    }
+
+    // Pad the record section, then append the fallback entries
+    std::ostringstream tail_stream;
+    static const char padding[8] = {0};
+    tail_stream.write(padding, (8 - bytes_written % 8) % 8);
+    for (const VertexId v : fallback_ids)
+    {
+        const std::string address = interner.address(v);
+        write_pod(tail_stream, static_cast<uint32_t>(address.size()));
+        tail_stream.write(address.data(), address.size());
+        write_pod(tail_stream, output_hops(hops, v, unreached_hops));
+    }
+    const std::string tail = tail_stream.str();
+    write_buffer(out, tail.data(), tail.size(), filename);
+    bytes_written += tail.size();
+    if (std::fclose(out) != 0)
+    {
+        throw std::runtime_error("Failed to close output file " + filename);
+    }
+    report_throughput("binary hop counts", filename, bytes_written, start);
+    return bytes_written;
+}
+
+bool read_hops_binary(const std::string &filename, AddressInterner &interner, std::vector<uint8_t> &hops)
+{
+    MappedFile file;
+    if (!file.open(filename))
+    {
+        std::cerr << "Error: Unable to open hop file " << filename << std::endl;
+        return false;
+    }
+    BinaryReader reader(file.data(), file.size());
+    HopsHeader header;
+    if (!reader.read_pod(header) || std::memcmp(header.magic, HOPS_MAGIC, sizeof(header.magic)) != 0)
+    {
+        std::cerr << "Error: " << filename << " is not a binary hop file" << std::endl;
+        return false;
+    }
+    // Counted in records, so a corrupt count cannot wrap around the size check
+    const HopRecord *records = header.record_count <= std::numeric_limits<size_t>::max() ? reader.read_array<HopRecord>(header.record_count) : nullptr;
+    if (!records)
+    {
+        std::cerr << "Error: Binary hop file " << filename << " is truncated" << std::endl;
+        return false;
+    }
+
+    // The unreached value goes back to the in-memory sentinel
+    auto stored_hops = [&header](uint8_t value)
+    {
+        return value == header.unreached_hops ? UNVISITED_HOPS : value;
+    };
+    for (uint64_t i = 0; i < header.record_count; ++i)
+    {
+        const VertexId v = interner.intern_key(records[i].key);
+        if (v >= hops.size())
+        {
+            hops.resize(v + 1, UNVISITED_HOPS);
+        }
+        hops[v] = stored_hops(records[i].hops);
+    }
+    for (uint64_t i = 0; i < header.fallback_count; ++i)
+    {
+        uint32_t length = 0;
+        uint8_t value;
+        const char *text = reader.read_pod(length) ? reader.read_bytes(length) : nullptr;
+        if (!text || !reader.read_pod(value))
+        {
+            std::cerr << "Error: Binary hop file " << filename << " has a corrupt fallback section" << std::endl;
+            return false;
+        }
+        const VertexId v = interner.intern(text, length);
+        if (v >= hops.size())
+        {
+            hops.resize(v + 1, UNVISITED_HOPS);
+        }
+        hops[v] = stored_hops(value);
+    }
+    hops.resize(interner.size(), UNVISITED_HOPS);
+    return true;
+}
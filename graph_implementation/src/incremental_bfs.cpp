@@ -0,0 +1,625 @@
+#include "incremental_bfs.hpp"
+#include "mapped_file.hpp"
+#include "metrics.hpp"
+#include <cstdio>
+
+using namespace std;
+
+namespace
+{
+    const char DISTANCE_STATE_MAGIC[8] = {'E', 'A', 'I', 'D', 'I', 'S', 'T', 'S'};
+
+    // Fixed-size header; the checksum covers everything after it
+    struct DistanceStateHeader
+    {
+        char magic[8];
+        uint32_t version;
+        int32_t max_hops;
+        uint64_t num_vertices;
+        uint64_t payload_bytes;
+        uint64_t checksum;
+    };
+
+    // Lowers hops[v] to value unless it is already at or below it. Returns true for the one caller
+    // that lowered it, so a vertex enters each level's queue once; previous receives the old count.
+    inline bool lower_hops(uint8_t *hops, VertexId v, uint8_t value, uint8_t &previous)
+    {
+        previous = __atomic_load_n(&hops[v], __ATOMIC_RELAXED);
+        while (previous > value)
+        {
+            if (__atomic_compare_exchange_n(&hops[v], &previous, value, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Records the hop count of v before its first change, once per vertex
+    class ChangeLog
+    {
+    public:
+        explicit ChangeLog(size_t num_vertices) : touched_(num_vertices) {}
+
+        void record(VertexId v, uint8_t previous, std::vector<HopChange> &local_changes)
+        {
+            if (touched_.set_atomic(v))
+            {
+                local_changes.push_back({v, previous, previous});
+            }
+        }
+
+        void merge(std::vector<HopChange> &local_changes)
+        {
+#pragma omp critical
+            {
+                changes_.insert(changes_.end(), local_changes.begin(), local_changes.end());
+            }
+            local_changes.clear();
+        }
+
+        // The recorded vertices whose count really changed, by vertex id, with their final count
+        std::vector<HopChange> finish(const std::vector<uint8_t> &hops)
+        {
+            std::vector<HopChange> changed;
+            for (HopChange &change : changes_)
+            {
+                change.new_hops = hops[change.vertex];
+                if (change.new_hops != change.old_hops)
+                {
+                    changed.push_back(change);
+                }
+            }
+            std::sort(changed.begin(), changed.end(), [](const HopChange &a, const HopChange &b)
+                      { return a.vertex < b.vertex; });
+            return changed;
+        }
+
+    private:
+        Bitmap touched_;
+        std::vector<HopChange> changes_;
+    };
+
+    // List end of propagate_decreases that follows every edge
+    auto whole_lists(const CSRGraph &graph)
+    {
+        return [&graph](VertexId u)
+        { return graph.offsets[u + 1]; };
+    }
+
+    /*
+    Pushes lowered hop counts out over graph. lowered[d] holds vertices whose count was set to d
+    (entries lowered again since are skipped); every level relaxes the out-edges of its vertices
+    and queues the neighbors it lowers on the next level. Only the list entries of u before
+    list_end(u) are followed. log, when given, records each vertex's count before its first change.
+    */
+    template <typename ListEnd>
+    std::vector<BFSLevelStats> propagate_decreases(const CSRGraph &graph, const ListEnd &list_end, std::vector<std::vector<VertexId>> &lowered, int max_hops, std::vector<uint8_t> &hops, ChangeLog *log)
+    {
+        std::vector<BFSLevelStats> stats;
+        for (int current_level = 0; current_level < max_hops; ++current_level)
+        {
+            std::vector<VertexId> &queue = lowered[current_level];
+            queue.erase(std::remove_if(queue.begin(), queue.end(), [&hops, current_level](VertexId v)
+                                       { return hops[v] != current_level; }),
+                        queue.end());
+            if (queue.empty())
+            {
+                continue;
+            }
+            auto start = chrono::high_resolution_clock::now();
+            const uint8_t next_hops = static_cast<uint8_t>(current_level + 1);
+            size_t edges_scanned = 0;
+            size_t discovered = 0;
+            std::vector<VertexId> &next_queue = lowered[current_level + 1];
+#pragma omp parallel reduction(+ : edges_scanned, discovered)
+            {
+                std::vector<VertexId> local_queue;
+                std::vector<HopChange> local_changes;
+#pragma omp for schedule(dynamic, 64) nowait
+                for (size_t i = 0; i < queue.size(); ++i)
+                {
+                    const VertexId u = queue[i];
+                    const uint64_t end = list_end(u);
+                    EAI_METRIC(edges_scanned += end - graph.offsets[u]);
+                    for (uint64_t e = graph.offsets[u]; e < end; ++e)
+                    {
+                        const VertexId v = graph.neighbors[e];
+                        uint8_t previous;
+                        if (hops[v] > next_hops && lower_hops(hops.data(), v, next_hops, previous))
+                        {
+                            if (log)
+                            {
+                                log->record(v, previous, local_changes);
+                            }
+                            local_queue.push_back(v);
+                            ++discovered;
+                        }
+                    }
+                }
+#pragma omp critical
+                {
+                    next_queue.insert(next_queue.end(), local_queue.begin(), local_queue.end());
+                }
+                if (log)
+                {
+                    log->merge(local_changes);
+                }
+            }
+
+            chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+            stats.push_back({current_level, false, queue.size(), edges_scanned, discovered, elapsed.count()});
+            std::cout << "Level " << current_level << " (incremental): lowered " << queue.size() << ", edges scanned " << edges_scanned
+                      << ", lowered next " << discovered << ", time " << elapsed.count() << " seconds" << std::endl;
+            std::vector<VertexId>().swap(queue);
+        }
+        return stats;
+    }
+
+    // apply_seed_delta by brute force: a full BFS from the changed seed list, diffed against hops
+    std::vector<HopChange> recompute_from_seeds(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &added, const std::vector<VertexId> &removed_seeds, int max_hops, std::vector<uint8_t> &hops)
+    {
+        std::vector<VertexId> removed(removed_seeds);
+        std::sort(removed.begin(), removed.end());
+        std::vector<VertexId> seeds(added);
+#pragma omp parallel
+        {
+            std::vector<VertexId> local_seeds;
+#pragma omp for schedule(static) nowait
+            for (size_t v = 0; v < hops.size(); ++v)
+            {
+                if (hops[v] == 0 && !std::binary_search(removed.begin(), removed.end(), static_cast<VertexId>(v)))
+                {
+                    local_seeds.push_back(static_cast<VertexId>(v));
+                }
+            }
+#pragma omp critical
+            {
+                seeds.insert(seeds.end(), local_seeds.begin(), local_seeds.end());
+            }
+        }
+        std::vector<uint8_t> new_hops;
+        bfs_direction_optimizing(graph, reverse_graph, seeds, max_hops, new_hops);
+        std::vector<HopChange> changed;
+#pragma omp parallel
+        {
+            std::vector<HopChange> local_changed;
+#pragma omp for schedule(static) nowait
+            for (size_t v = 0; v < hops.size(); ++v)
+            {
+                if (new_hops[v] != hops[v])
+                {
+                    local_changed.push_back({static_cast<VertexId>(v), hops[v], new_hops[v]});
+                }
+            }
+#pragma omp critical
+            {
+                changed.insert(changed.end(), local_changed.begin(), local_changed.end());
+            }
+        }
+        std::sort(changed.begin(), changed.end(), [](const HopChange &a, const HopChange &b)
+                  { return a.vertex < b.vertex; });
+        hops.swap(new_hops);
+        return changed;
+    }
+}
+
+void write_distance_state(const std::string &filename, const DistanceState &state)
+{
+    const std::string temporary_filename = filename + ".tmp";
+    {
+        std::ofstream out(temporary_filename, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            throw std::runtime_error("Unable to open distance state file " + temporary_filename);
+        }
+        DistanceStateHeader header{};
+        std::memcpy(header.magic, DISTANCE_STATE_MAGIC, sizeof(header.magic));
+        header.version = DISTANCE_STATE_VERSION;
+        header.max_hops = state.max_hops;
+        header.num_vertices = state.hops.size();
+        write_pod(out, header);
+        write_chunk_list(out, state.chunks);
+        write_array(out, state.hops.data(), state.hops.size());
+        if (!out)
+        {
+            throw std::runtime_error("Failed to write distance state file " + temporary_filename);
+        }
+    }
+
+    // Patch in the payload size and checksum, as for the graph snapshot
+    DistanceStateHeader header{};
+    {
+        MappedFile file(temporary_filename);
+        if (!file.is_open() || file.size() < sizeof(DistanceStateHeader))
+        {
+            throw std::runtime_error("Unable to reopen distance state file " + temporary_filename);
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        header.payload_bytes = file.size() - sizeof(DistanceStateHeader);
+        header.checksum = snapshot_checksum(file.data() + sizeof(DistanceStateHeader), header.payload_bytes);
+    }
+    {
+        std::fstream out(temporary_filename, std::ios::binary | std::ios::in | std::ios::out);
+        out.seekp(0);
+        write_pod(out, header);
+        if (!out)
+        {
+            throw std::runtime_error("Failed to write distance state header " + temporary_filename);
+        }
+    }
+    if (std::rename(temporary_filename.c_str(), filename.c_str()) != 0)
+    {
+        throw std::runtime_error("Unable to move distance state into place at " + filename);
+    }
+}
+
+bool read_distance_state(const std::string &filename, DistanceState &state)
+{
+    MappedFile file;
+    if (!file.open(filename))
+    {
+        std::cout << "No distance state at " << filename << std::endl;
+        return false;
+    }
+    DistanceStateHeader header;
+    if (file.size() < sizeof(header))
+    {
+        std::cerr << "Error: Distance state " << filename << " is truncated" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, DISTANCE_STATE_MAGIC, sizeof(header.magic)) != 0)
+    {
+        std::cerr << "Error: " << filename << " is not a distance state file" << std::endl;
+        return false;
+    }
+    if (header.version != DISTANCE_STATE_VERSION)
+    {
+        std::cout << "Distance state version " << header.version << " is outdated (expected " << DISTANCE_STATE_VERSION << ")" << std::endl;
+        return false;
+    }
+    const char *payload = file.data() + sizeof(header);
+    if (header.payload_bytes != file.size() - sizeof(header) || snapshot_checksum(payload, header.payload_bytes) != header.checksum)
+    {
+        std::cerr << "Error: Distance state " << filename << " failed its checksum" << std::endl;
+        return false;
+    }
+    BinaryReader reader(payload, header.payload_bytes);
+    if (!read_chunk_list(reader, state.chunks) || !reader.read_vector(header.num_vertices, state.hops))
+    {
+        std::cerr << "Error: Distance state " << filename << " has inconsistent sections" << std::endl;
+        state = DistanceState();
+        return false;
+    }
+    state.max_hops = header.max_hops;
+    return true;
+}
+
+bool find_new_chunks(const std::vector<ChunkFingerprint> &previous, const std::vector<ChunkFingerprint> &current, std::vector<std::string> &new_chunk_files)
+{
+    new_chunk_files.clear();
+    for (const ChunkFingerprint &chunk : previous)
+    {
+        if (std::find(current.begin(), current.end(), chunk) == current.end())
+        {
+            std::cout << "Chunk " << chunk.filename << " was removed or changed since the last run" << std::endl;
+            return false;
+        }
+    }
+    for (const ChunkFingerprint &chunk : current)
+    {
+        if (std::find(previous.begin(), previous.end(), chunk) == previous.end())
+        {
+            new_chunk_files.push_back(chunk.filename);
+        }
+    }
+    return true;
+}
+
+std::vector<BFSLevelStats> update_distances_after_insertions(const CSRGraph &graph, const std::vector<VertexId> &seeds, const std::vector<TransferEdge> &new_edges, int max_hops, std::vector<uint8_t> &hops)
+{
+    const size_t n = num_vertices(graph);
+    hops.resize(n, UNVISITED_HOPS);
+    if (max_hops <= 0)
+    {
+        return {};
+    }
+
+    // lowered[d]: vertices whose hop count just dropped to d, still to be pushed out
+    std::vector<std::vector<VertexId>> lowered(max_hops + 1);
+    uint8_t previous;
+    for (const VertexId seed : seeds)
+    {
+        if (seed < n && lower_hops(hops.data(), seed, 0, previous))
+        {
+            lowered[0].push_back(seed);
+        }
+    }
+    // A new transfer from a reached vertex can shorten the path to its receiver
+    for (const TransferEdge &edge : new_edges)
+    {
+        const uint8_t source_hops = hops[edge.src];
+        if (source_hops < max_hops && lower_hops(hops.data(), edge.dst, static_cast<uint8_t>(source_hops + 1), previous))
+        {
+            lowered[source_hops + 1].push_back(edge.dst);
+        }
+    }
+    return propagate_decreases(graph, whole_lists(graph), lowered, max_hops, hops, nullptr);
+}
+
+std::vector<HopChange> apply_seed_delta(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &added_seeds, const std::vector<VertexId> &removed_seeds, int max_hops, std::vector<uint8_t> &hops, int alpha)
+{
+    const size_t n = num_vertices(graph);
+    ChangeLog log(n);
+    if (max_hops <= 0)
+    {
+        return {};
+    }
+    std::vector<VertexId> added(added_seeds);
+    std::sort(added.begin(), added.end());
+
+    /*
+    Removals. A vertex at level d depends on the removed seeds if none of its in-neighbors at level
+    d - 1 is still supported; only out-neighbors of dependent vertices can be dependent, so the
+    search stays inside the region the removed seeds reached.
+    */
+    Bitmap dependent(n), checked(n);
+    std::vector<std::vector<VertexId>> levels(max_hops + 1);
+    for (const VertexId seed : removed_seeds)
+    {
+        if (seed < n && hops[seed] == 0 && !std::binary_search(added.begin(), added.end(), seed) && dependent.set_atomic(seed))
+        {
+            levels[0].push_back(seed);
+        }
+    }
+    size_t num_dependent = levels[0].size();
+    // Past this many edges a full BFS from the changed seed list is cheaper than the repair
+    const uint64_t repair_limit = num_edges(graph) / alpha;
+    std::atomic<uint64_t> repair_edges(0);
+    for (int current_level = 1; current_level <= max_hops && !levels[current_level - 1].empty() && repair_edges <= repair_limit; ++current_level)
+    {
+        const std::vector<VertexId> &parents = levels[current_level - 1];
+        std::vector<VertexId> &found = levels[current_level];
+#pragma omp parallel
+        {
+            std::vector<VertexId> local_found;
+#pragma omp for schedule(dynamic, 64) nowait
+            for (size_t i = 0; i < parents.size(); ++i)
+            {
+                // Once over the limit the rest of the search is wasted
+                if (repair_edges.load(std::memory_order_relaxed) > repair_limit)
+                {
+                    continue;
+                }
+                const VertexId u = parents[i];
+                uint64_t scanned = out_degree(u, graph);
+                for (uint64_t e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e)
+                {
+                    const VertexId v = graph.neighbors[e];
+                    if (hops[v] != current_level || !checked.set_atomic(v))
+                    {
+                        continue;
+                    }
+                    bool supported = false;
+                    uint64_t f = reverse_graph.offsets[v];
+                    for (; f < reverse_graph.offsets[v + 1] && !supported; ++f)
+                    {
+                        const VertexId w = reverse_graph.neighbors[f];
+                        supported = hops[w] == current_level - 1 && !dependent.test(w);
+                    }
+                    scanned += f - reverse_graph.offsets[v];
+                    if (!supported)
+                    {
+                        dependent.set_atomic(v);
+                        local_found.push_back(v);
+                    }
+                }
+                repair_edges.fetch_add(scanned, std::memory_order_relaxed);
+            }
+#pragma omp critical
+            {
+                found.insert(found.end(), local_found.begin(), local_found.end());
+            }
+        }
+        num_dependent += found.size();
+    }
+
+    // Every dependent vertex loses its count, then restarts from its best in-neighbor outside the
+    // region. Counts can only go up here, so the old count is the one the log needs.
+    std::vector<VertexId> region;
+    region.reserve(num_dependent);
+    for (int d = 0; d <= max_hops; ++d)
+    {
+        region.insert(region.end(), levels[d].begin(), levels[d].end());
+        std::vector<VertexId>().swap(levels[d]);
+    }
+    uint64_t restart_edges = repair_edges;
+    for (size_t i = 0; i < region.size() && restart_edges <= repair_limit; ++i)
+    {
+        restart_edges += out_degree(region[i], reverse_graph);
+    }
+    if (restart_edges > repair_limit)
+    {
+        std::cout << "Seed delta: the removed seeds reach too much of the graph, recomputing from the changed seed list" << std::endl;
+        return recompute_from_seeds(graph, reverse_graph, added, removed_seeds, max_hops, hops);
+    }
+    std::vector<HopChange> local_changes;
+    for (const VertexId v : region)
+    {
+        log.record(v, hops[v], local_changes);
+        hops[v] = UNVISITED_HOPS;
+    }
+    log.merge(local_changes);
+    std::vector<uint8_t> restart(region.size(), UNVISITED_HOPS);
+#pragma omp parallel for schedule(dynamic, 64)
+    for (size_t i = 0; i < region.size(); ++i)
+    {
+        const VertexId v = region[i];
+        for (uint64_t e = reverse_graph.offsets[v]; e < reverse_graph.offsets[v + 1]; ++e)
+        {
+            const uint8_t parent_hops = hops[reverse_graph.neighbors[e]];
+            if (parent_hops < max_hops)
+            {
+                restart[i] = std::min<uint8_t>(restart[i], parent_hops + 1);
+            }
+        }
+    }
+    std::vector<std::vector<VertexId>> lowered(max_hops + 1);
+    for (size_t i = 0; i < region.size(); ++i)
+    {
+        if (restart[i] != UNVISITED_HOPS)
+        {
+            hops[region[i]] = restart[i];
+            lowered[restart[i]].push_back(region[i]);
+        }
+    }
+
+    // Additions start at 0; one pass pushes out both the restarted region and the new seeds
+    uint8_t previous;
+    for (const VertexId seed : added)
+    {
+        if (seed < n && lower_hops(hops.data(), seed, 0, previous))
+        {
+            log.record(seed, previous, local_changes);
+            lowered[0].push_back(seed);
+        }
+    }
+    log.merge(local_changes);
+    std::cout << "Seed delta: " << added.size() << " added, " << removed_seeds.size() << " removed, "
+              << num_dependent << " vertices depended on the removed seeds" << std::endl;
+    propagate_decreases(graph, whole_lists(graph), lowered, max_hops, hops, &log);
+    return log.finish(hops);
+}
+
+namespace
+{
+    // Out-edges neighbors[begin] .. neighbors[end - 1] of source, all first seen in the same cutoff window
+    struct DatedRange
+    {
+        VertexId source;
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    // ranges[c] for c >= 1: the transfers first seen after cutoffs[c - 1] and on or before
+    // cutoffs[c], one range per sender. Date-ordered lists keep each window contiguous, so one
+    // pass over the lists past their first-cutoff prefix finds them all.
+    std::vector<std::vector<DatedRange>> transfers_by_cutoff(const CSRGraph &graph, const std::vector<uint32_t> &first_seen, const std::vector<uint32_t> &cutoffs)
+    {
+        const size_t n = num_vertices(graph);
+        const size_t num_cutoffs = cutoffs.size();
+        std::vector<std::vector<DatedRange>> ranges(num_cutoffs);
+        if (num_cutoffs < 2)
+        {
+            return ranges;
+        }
+#pragma omp parallel
+        {
+            std::vector<std::vector<DatedRange>> local_ranges(num_cutoffs);
+#pragma omp for schedule(dynamic, 4096) nowait
+            for (size_t u = 0; u < n; ++u)
+            {
+                const VertexId source = static_cast<VertexId>(u);
+                const uint64_t end = graph.offsets[u + 1];
+                uint64_t begin = dated_end(source, graph, first_seen, cutoffs[0]);
+                while (begin < end)
+                {
+                    // First cutoff that sees the transfer at begin
+                    const size_t c = std::lower_bound(cutoffs.begin(), cutoffs.end(), first_seen[begin]) - cutoffs.begin();
+                    if (c == num_cutoffs)
+                    {
+                        break;
+                    }
+                    const uint64_t window_end = dated_end(source, graph, first_seen, cutoffs[c]);
+                    local_ranges[c].push_back({source, begin, window_end});
+                    begin = window_end;
+                }
+            }
+#pragma omp critical
+            {
+                for (size_t c = 1; c < num_cutoffs; ++c)
+                {
+                    ranges[c].insert(ranges[c].end(), local_ranges[c].begin(), local_ranges[c].end());
+                }
+            }
+        }
+        return ranges;
+    }
+}
+
+std::vector<std::vector<BFSLevelStats>> bfs_by_cutoff_dates(const CSRGraph &graph, const std::vector<uint32_t> &first_seen, const std::vector<VertexId> &seeds, const std::vector<uint32_t> &cutoffs, int max_hops, std::vector<uint8_t> &hops)
+{
+    if (!std::is_sorted(cutoffs.begin(), cutoffs.end()))
+    {
+        throw std::invalid_argument("Cutoff dates must be in increasing order");
+    }
+    const size_t n = num_vertices(graph);
+    const size_t num_cutoffs = cutoffs.size();
+    max_hops = std::max(0, max_hops);
+    hops.assign(n * num_cutoffs, UNVISITED_HOPS);
+    std::vector<uint8_t> current(n, UNVISITED_HOPS);
+    std::vector<std::vector<BFSLevelStats>> stats;
+    const std::vector<std::vector<DatedRange>> new_transfers = transfers_by_cutoff(graph, first_seen, cutoffs);
+
+    for (size_t c = 0; c < num_cutoffs; ++c)
+    {
+        const uint32_t cutoff = cutoffs[c];
+        // lowered[d]: vertices whose hop count just dropped to d, still to be pushed out
+        std::vector<std::vector<VertexId>> lowered(max_hops + 1);
+        uint8_t previous;
+        if (c == 0)
+        {
+            for (const VertexId seed : seeds)
+            {
+                if (seed < n && lower_hops(current.data(), seed, 0, previous))
+                {
+                    lowered[0].push_back(seed);
+                }
+            }
+        }
+        else
+        {
+            // A transfer first seen since the previous cutoff can shorten the path to its receiver
+            const std::vector<DatedRange> &window = new_transfers[c];
+#pragma omp parallel
+            {
+                std::vector<std::vector<VertexId>> local_lowered(max_hops + 1);
+                uint8_t local_previous;
+#pragma omp for schedule(dynamic, 1024) nowait
+                for (size_t i = 0; i < window.size(); ++i)
+                {
+                    const uint8_t source_hops = current[window[i].source];
+                    if (source_hops >= max_hops)
+                    {
+                        continue;
+                    }
+                    for (uint64_t e = window[i].begin; e < window[i].end; ++e)
+                    {
+                        if (lower_hops(current.data(), graph.neighbors[e], static_cast<uint8_t>(source_hops + 1), local_previous))
+                        {
+                            local_lowered[source_hops + 1].push_back(graph.neighbors[e]);
+                        }
+                    }
+                }
+#pragma omp critical
+                {
+                    for (int d = 0; d <= max_hops; ++d)
+                    {
+                        lowered[d].insert(lowered[d].end(), local_lowered[d].begin(), local_lowered[d].end());
+                    }
+                }
+            }
+        }
+        auto visible_end = [&graph, &first_seen, cutoff](VertexId u)
+        { return dated_end(u, graph, first_seen, cutoff); };
+        stats.push_back(propagate_decreases(graph, visible_end, lowered, max_hops, current, nullptr));
+
+#pragma omp parallel for schedule(static)
+        for (size_t v = 0; v < n; ++v)
+        {
+            hops[v * num_cutoffs + c] = current[v];
+        }
+    }
+    return stats;
+}
@@ -1,9 +1,200 @@
 #include "uni_graph.hpp"
+#include "vertex_order.hpp"
+#include "neighborhood_sketch.hpp"
+#include "hop_output.hpp"
+#include "parse_number.hpp"
 
-int main()
+namespace
 {
-    string kyc_name = "agg_eai_no_dusting.csv";
-    string output_filename = "address_to_hops_no_dusting_dc.txt";
-    int a = calculates_eai_dist(kyc_name, output_filename);
-    return 0;
-}
\ No newline at end of file
+    // A size in MB that is positive and still fits in bytes
+    bool parse_megabytes(const char *text, uint64_t &megabytes)
+    {
+        return parse_number(text, megabytes) && megabytes > 0 && megabytes <= (std::numeric_limits<uint64_t>::max() >> 20);
+    }
+
+    int usage()
+    {
+        cerr << "usage: uni_graph [command]\n"
+             << "  (no command) or sorted                        distances from the KYC addresses\n"
+             << "  compile\n"
+             << "  groups <output> <seed file>...\n"
+             << "  thresholds <output> <usd>...\n"
+             << "  both <output>\n"
+             << "  paths <address file> <output>\n"
+             << "  serve <unix:path|tcp:port>\n"
+             << "  order <degree|bfs|rcm> <output> [sorted]\n"
+             << "  orders\n"
+             << "  compressed\n"
+             << "  update <output> [verify]\n"
+             << "  whatif <added addresses> <removed addresses> <output>\n"
+             << "  risk <hacker addresses> <output> [tolerance] [max iterations]\n"
+             << "  reach <output> [precision " << MIN_SKETCH_PRECISION << "-" << MAX_SKETCH_PRECISION << "] [memory MB]\n"
+             << "  windows <output> <YYYY-MM-DD>...\n"
+             << "  partition <MB>\n"
+             << "  external <budget MB> <output>" << endl;
+        return 1;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    // "uni_graph [sorted]" writes the KYC distances, with "sorted" in ascending address order
+    if (argc == 1 || (argc == 2 && string(argv[1]) == "sorted"))
+    {
+        string kyc_name = "agg_eai_no_dusting.csv";
+        string output_filename = "address_to_hops_no_dusting_dc.txt";
+        int a = calculates_eai_dist(kyc_name, output_filename, VertexOrdering::Original, argc == 2 ? HopOutputOrder::Sorted : HopOutputOrder::VertexOrder);
+        return 0;
+    }
+    const string command = argv[1];
+    // "uni_graph compile" only refreshes the graph snapshot
+    if (command == "compile")
+    {
+        return compile_graph_snapshot();
+    }
+    // "uni_graph groups <output> <seed file>..." computes one distance column per seed group
+    if (command == "groups")
+    {
+        if (argc < 4)
+        {
+            return usage();
+        }
+        return calculates_group_dist(std::vector<std::string>(argv + 3, argv + argc), argv[2]);
+    }
+    // "uni_graph thresholds <output> <usd>..." computes one distance column per dust threshold
+    if (command == "thresholds")
+    {
+        if (argc < 4)
+        {
+            return usage();
+        }
+        std::vector<float> thresholds;
+        for (int i = 3; i < argc; ++i)
+        {
+            float threshold;
+            if (!parse_number(argv[i], threshold) || !(threshold >= 0.0f))
+            {
+                return usage();
+            }
+            thresholds.push_back(threshold);
+        }
+        return calculates_threshold_dist("agg_eai_no_dusting.csv", thresholds, argv[2]);
+    }
+    // "uni_graph both <output>" writes the distance from and to the KYC addresses
+    if (command == "both")
+    {
+        if (argc < 3)
+        {
+            return usage();
+        }
+        return calculates_bidirectional_dist("agg_eai_no_dusting.csv", argv[2]);
+    }
+    // "uni_graph paths <address file> <output>" traces the listed addresses back to their KYC seed
+    if (command == "paths")
+    {
+        if (argc < 4)
+        {
+            return usage();
+        }
+        return calculates_eai_paths("agg_eai_no_dusting.csv", argv[2], argv[3]);
+    }
+    // "uni_graph serve <unix:path|tcp:port>" keeps the graph resident and answers queries
+    if (command == "serve")
+    {
+        if (argc < 3)
+        {
+            return usage();
+        }
+        return serve_queries("agg_eai_no_dusting.csv", argv[2]);
+    }
+    // "uni_graph order <degree|bfs|rcm> <output> [sorted]" relabels the vertices for cache locality before the BFS
+    if (command == "order")
+    {
+        VertexOrdering ordering;
+        if (argc < 4 || !parse_vertex_ordering(argv[2], ordering) || (argc > 4 && string(argv[4]) != "sorted"))
+        {
+            return usage();
+        }
+        return calculates_eai_dist("agg_eai_no_dusting.csv", argv[3], ordering, argc > 4 ? HopOutputOrder::Sorted : HopOutputOrder::VertexOrder);
+    }
+    // "uni_graph orders" reports what each ordering costs and how much faster the BFS gets
+    if (command == "orders")
+    {
+        return compare_vertex_orders("agg_eai_no_dusting.csv");
+    }
+    // "uni_graph compressed" compares the compressed adjacency lists with the CSR layout
+    if (command == "compressed")
+    {
+        return compare_compressed_graph("agg_eai_no_dusting.csv");
+    }
+    // "uni_graph update <output> [verify]" updates the previous run's distances with the chunks added since
+    if (command == "update")
+    {
+        if (argc < 3 || (argc > 3 && string(argv[3]) != "verify"))
+        {
+            return usage();
+        }
+        return update_eai_dist("agg_eai_no_dusting.csv", argv[2], argc > 3);
+    }
+    // "uni_graph whatif <added addresses> <removed addresses> <output>" lists the distances a KYC list change would move
+    if (command == "whatif")
+    {
+        if (argc < 5)
+        {
+            return usage();
+        }
+        return calculates_seed_delta("agg_eai_no_dusting.csv", argv[2], argv[3], argv[4]);
+    }
+    // "uni_graph risk <hacker addresses> <output> [tolerance] [max iterations]" scores addresses by the value reaching them from hackers
+    if (command == "risk")
+    {
+        double tolerance = 1e-9;
+        int max_iterations = 100;
+        if (argc < 4 || (argc > 4 && (!parse_number(argv[4], tolerance) || !(tolerance >= 0.0))) || (argc > 5 && (!parse_number(argv[5], max_iterations) || max_iterations < 1)))
+        {
+            return usage();
+        }
+        return calculates_hacker_risk(argv[2], argv[3], tolerance, max_iterations);
+    }
+    // "uni_graph reach <output> [precision] [memory MB]" estimates how many addresses each address reaches within k hops
+    if (command == "reach")
+    {
+        int precision = 6;
+        uint64_t memory_mb = 0;
+        if (argc < 3 || (argc > 3 && (!parse_number(argv[3], precision) || precision < MIN_SKETCH_PRECISION || precision > MAX_SKETCH_PRECISION)) || (argc > 4 && !parse_megabytes(argv[4], memory_mb)))
+        {
+            return usage();
+        }
+        return calculates_reach_sketches(argv[2], precision, memory_mb);
+    }
+    // "uni_graph windows <output> <YYYY-MM-DD>..." computes one distance column per cutoff date
+    if (command == "windows")
+    {
+        if (argc < 4)
+        {
+            return usage();
+        }
+        return calculates_windowed_dist("agg_eai_no_dusting.csv", std::vector<std::string>(argv + 3, argv + argc), argv[2]);
+    }
+    // "uni_graph partition <MB>" writes the on-disk edge partitions for the semi-external BFS
+    if (command == "partition")
+    {
+        uint64_t partition_mb;
+        if (argc < 3 || !parse_megabytes(argv[2], partition_mb))
+        {
+            return usage();
+        }
+        return compile_edge_partitions(partition_mb);
+    }
+    // "uni_graph external <budget MB> <output>" runs the BFS with at most budget MB of adjacency in memory
+    if (command == "external")
+    {
+        uint64_t budget_mb;
+        if (argc < 4 || !parse_megabytes(argv[2], budget_mb))
+        {
+            return usage();
+        }
+        return calculates_eai_dist_external("agg_eai_no_dusting.csv", budget_mb, argv[3]);
+    }
+    return usage();
+}
@@ -0,0 +1,214 @@
+#include "metrics.hpp"
+
+#ifdef EAI_METRICS
+
+#include <ctime>
+#include <sys/resource.h>
+
+using namespace std;
+
+namespace
+{
+    struct PhaseRecord
+    {
+        std::string name;
+        double wall_seconds;
+        double cpu_seconds;
+        uint64_t peak_rss_bytes;
+        uint64_t bytes_read;
+        uint64_t storage_read_bytes;
+        std::vector<std::pair<std::string, double>> counters;
+    };
+
+    struct BFSRecord
+    {
+        std::string name;
+        std::vector<BFSLevelStats> levels;
+    };
+
+    // Phases finish on whichever thread ran them, so the report is guarded
+    std::mutex report_mutex;
+    std::string run_name = "unnamed";
+    std::string run_started_at;
+    double run_start_wall = 0.0;
+    std::vector<PhaseRecord> phases;
+    std::vector<BFSRecord> traversals;
+
+    double wall_seconds()
+    {
+        return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    double cpu_seconds()
+    {
+        timespec now;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+        return now.tv_sec + now.tv_nsec * 1e-9;
+    }
+
+    uint64_t peak_rss_bytes()
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        // Linux reports kilobytes
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+    }
+
+    // Bytes this process caused to be fetched from storage, including mmap page-ins
+    uint64_t storage_read_bytes()
+    {
+        ifstream io("/proc/self/io");
+        string key;
+        uint64_t value;
+        while (io >> key >> value)
+        {
+            if (key == "read_bytes:")
+            {
+                return value;
+            }
+        }
+        return 0;
+    }
+
+    std::string utc_timestamp()
+    {
+        const std::time_t now = std::time(nullptr);
+        std::tm utc;
+        gmtime_r(&now, &utc);
+        char text[32];
+        std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", &utc);
+        return text;
+    }
+
+    std::string json_string(const std::string &text)
+    {
+        std::string quoted = "\"";
+        for (const char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                quoted += '\\';
+                quoted += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                quoted += escaped;
+            }
+            else
+            {
+                quoted += c;
+            }
+        }
+        return quoted + "\"";
+    }
+}
+
+void metrics_begin_run(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(report_mutex);
+    run_name = name;
+    run_started_at = utc_timestamp();
+    run_start_wall = wall_seconds();
+    phases.clear();
+    traversals.clear();
+}
+
+PhaseTimer::PhaseTimer(const std::string &name)
+    : name_(name), stopped_(false), start_wall_(wall_seconds()), start_cpu_(cpu_seconds()), start_io_read_(storage_read_bytes()), bytes_read_(0)
+{
+}
+
+void PhaseTimer::set_counter(const std::string &name, double value)
+{
+    for (auto &counter : counters_)
+    {
+        if (counter.first == name)
+        {
+            counter.second = value;
+            return;
+        }
+    }
+    counters_.emplace_back(name, value);
+}
+
+void PhaseTimer::stop()
+{
+    if (stopped_)
+    {
+        return;
+    }
+    stopped_ = true;
+    PhaseRecord record{name_, wall_seconds() - start_wall_, cpu_seconds() - start_cpu_, peak_rss_bytes(), bytes_read_, storage_read_bytes() - start_io_read_, counters_};
+    std::lock_guard<std::mutex> lock(report_mutex);
+    phases.push_back(std::move(record));
+}
+
+void record_bfs_levels(const std::string &name, const std::vector<BFSLevelStats> &levels)
+{
+    std::lock_guard<std::mutex> lock(report_mutex);
+    traversals.push_back(BFSRecord{name, levels});
+}
+
+std::string metrics_json()
+{
+    std::lock_guard<std::mutex> lock(report_mutex);
+    std::ostringstream json;
+    json << std::setprecision(9);
+    json << "{\n  \"run\": " << json_string(run_name) << ",\n  \"started_at\": " << json_string(run_started_at)
+         << ",\n  \"threads\": " << omp_get_max_threads()
+         << ",\n  \"wall_seconds\": " << (run_start_wall > 0 ? wall_seconds() - run_start_wall : 0.0)
+         << ",\n  \"peak_rss_bytes\": " << peak_rss_bytes() << ",\n  \"phases\": [";
+    for (size_t p = 0; p < phases.size(); ++p)
+    {
+        const PhaseRecord &phase = phases[p];
+        json << (p ? ",\n" : "\n") << "    {\"name\": " << json_string(phase.name) << ", \"wall_seconds\": " << phase.wall_seconds
+             << ", \"cpu_seconds\": " << phase.cpu_seconds << ", \"peak_rss_bytes\": " << phase.peak_rss_bytes
+             << ", \"bytes_read\": " << phase.bytes_read << ", \"storage_read_bytes\": " << phase.storage_read_bytes << ", \"counters\": {";
+        for (size_t c = 0; c < phase.counters.size(); ++c)
+        {
+            json << (c ? ", " : "") << json_string(phase.counters[c].first) << ": " << phase.counters[c].second;
+        }
+        json << "}}";
+    }
+    json << (phases.empty() ? "]" : "\n  ]") << ",\n  \"bfs\": [";
+    for (size_t t = 0; t < traversals.size(); ++t)
+    {
+        const BFSRecord &traversal = traversals[t];
+        size_t edges_scanned = 0;
+        double seconds = 0.0;
+        json << (t ? ",\n" : "\n") << "    {\"name\": " << json_string(traversal.name) << ", \"levels\": [";
+        for (size_t l = 0; l < traversal.levels.size(); ++l)
+        {
+            const BFSLevelStats &level = traversal.levels[l];
+            edges_scanned += level.edges_scanned;
+            seconds += level.seconds;
+            json << (l ? ",\n" : "\n") << "      {\"level\": " << level.level << ", \"direction\": \"" << (level.bottom_up ? "bottom-up" : "top-down")
+                 << "\", \"frontier\": " << level.frontier_size << ", \"edges_scanned\": " << level.edges_scanned
+                 << ", \"discovered\": " << level.discovered << ", \"seconds\": " << level.seconds
+                 << ", \"max_busy_seconds\": " << level.max_busy_seconds << ", \"mean_busy_seconds\": " << level.mean_busy_seconds
+                 << ", \"steals\": " << level.steals << "}";
+        }
+        json << (traversal.levels.empty() ? "]" : "\n    ]") << ", \"edges_scanned\": " << edges_scanned << ", \"seconds\": " << seconds
+             << ", \"teps\": " << (seconds > 0 ? edges_scanned / seconds : 0.0) << "}";
+    }
+    json << (traversals.empty() ? "]" : "\n  ]") << "\n}\n";
+    return json.str();
+}
+
+bool write_metrics_report(const std::string &filename)
+{
+    const std::string report = metrics_json();
+    ofstream out(filename);
+    out << report;
+    if (!out)
+    {
+        std::cerr << "Error: Unable to write metrics report " << filename << std::endl;
+        return false;
+    }
+    std::cout << "Wrote metrics report to " << filename << std::endl;
+    return true;
+}
+
+#endif // EAI_METRICS
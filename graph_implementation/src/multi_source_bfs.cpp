@@ -0,0 +1,191 @@
+#include "multi_source_bfs.hpp"
+#include "metrics.hpp"
+
+using namespace std;
+
+void read_seed_groups(const std::string &filename, const AddressInterner &interner, const std::string &default_label, std::vector<SeedGroup> &groups)
+{
+    ifstream seed_file(filename);
+    if (!seed_file)
+    {
+        throw std::runtime_error("Unable to open seed file " + filename);
+    }
+    std::unordered_map<std::string, size_t> group_index;
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        group_index[groups[g].label] = g;
+    }
+
+    string line;
+    // Skip the header line
+    getline(seed_file, line);
+    while (getline(seed_file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        size_t comma = line.find(',');
+        std::string address = line.substr(0, comma);
+        std::string label = comma == std::string::npos ? default_label : line.substr(comma + 1);
+
+        auto it = group_index.find(label);
+        if (it == group_index.end())
+        {
+            if (groups.size() == MAX_SEED_GROUPS)
+            {
+                throw std::runtime_error("More than " + std::to_string(MAX_SEED_GROUPS) + " seed groups in " + filename);
+            }
+            it = group_index.emplace(label, groups.size()).first;
+            groups.push_back(SeedGroup{label, {}});
+        }
+        VertexId id;
+        if (interner.find(address, id))
+        {
+            groups[it->second].seeds.push_back(id);
+        }
+    }
+}
+
+std::vector<BFSLevelStats> multi_source_bfs(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<SeedGroup> &groups, int max_hops, std::vector<uint8_t> &hops, int alpha)
+{
+    if (groups.size() > MAX_SEED_GROUPS)
+    {
+        throw std::runtime_error("multi_source_bfs supports at most 64 seed groups");
+    }
+    const size_t n = num_vertices(graph);
+    const size_t num_groups = groups.size();
+    const uint64_t all_groups = num_groups == 64 ? ~uint64_t(0) : (uint64_t(1) << num_groups) - 1;
+    std::vector<uint64_t> seen(n, 0), frontier(n, 0), next(n, 0);
+    hops.assign(n * num_groups, UNVISITED_HOPS);
+    FrontierScheduler scheduler;
+    std::vector<BFSLevelStats> stats;
+
+    // Level 0: each seed carries the bit of its groups
+    std::vector<VertexId> active;
+    for (size_t g = 0; g < num_groups; ++g)
+    {
+        const uint64_t bit = uint64_t(1) << g;
+        for (const VertexId seed : groups[g].seeds)
+        {
+            if (seed >= n || (seen[seed] & bit))
+            {
+                continue;
+            }
+            if (!frontier[seed])
+            {
+                active.push_back(seed);
+            }
+            seen[seed] |= bit;
+            frontier[seed] |= bit;
+            hops[seed * num_groups + g] = 0;
+        }
+    }
+
+    for (int current_level = 0; current_level < max_hops && !active.empty(); ++current_level)
+    {
+        auto start = chrono::high_resolution_clock::now();
+        const uint8_t next_hops = static_cast<uint8_t>(current_level + 1);
+        size_t edges_scanned = 0;
+        size_t discovered = 0;
+
+        uint64_t scout_count = 0;
+#pragma omp parallel for schedule(static) reduction(+ : scout_count)
+        for (size_t i = 0; i < active.size(); ++i)
+        {
+            scout_count += out_degree(active[i], graph);
+        }
+        const bool pull = scout_count > num_edges(graph) / alpha;
+
+        if (pull)
+        {
+            // Every vertex still missing a group ORs the frontier masks of its in-neighbors
+#pragma omp parallel for schedule(dynamic, 1024) reduction(+ : edges_scanned)
+            for (size_t v = 0; v < n; ++v)
+            {
+                const uint64_t missing = all_groups & ~seen[v];
+                if (!missing)
+                {
+                    continue;
+                }
+                uint64_t reached = 0;
+                for (uint64_t e = reverse_graph.offsets[v]; e < reverse_graph.offsets[v + 1]; ++e)
+                {
+                    EAI_METRIC(++edges_scanned);
+                    reached |= frontier[reverse_graph.neighbors[e]];
+                    if ((reached & missing) == missing)
+                    {
+                        break;
+                    }
+                }
+                next[v] = reached & missing;
+            }
+        }
+        else
+        {
+            // Every active vertex pushes its frontier mask to its out-neighbors, the edges shared out evenly
+            scheduler.plan(active, graph, [&graph](VertexId u)
+                           { return graph.offsets[u + 1]; });
+            edges_scanned = scheduler.total_edges();
+#pragma omp parallel
+            {
+                scheduler.run([&](VertexId u, uint64_t begin, uint64_t end)
+                              {
+                    const uint64_t mask = frontier[u];
+                    for (uint64_t e = begin; e < end; ++e)
+                    {
+                        const VertexId v = graph.neighbors[e];
+                        const uint64_t fresh = mask & ~seen[v];
+                        if (fresh && (__atomic_load_n(&next[v], __ATOMIC_RELAXED) & fresh) != fresh)
+                        {
+                            __atomic_fetch_or(&next[v], fresh, __ATOMIC_RELAXED);
+                        }
+                    } });
+            }
+        }
+
+        // Commit the level: new bits become the frontier and get their hop count
+        const size_t frontier_size = active.size();
+        active.clear();
+#pragma omp parallel reduction(+ : discovered)
+        {
+            std::vector<VertexId> local_active;
+#pragma omp for schedule(static) nowait
+            for (size_t v = 0; v < n; ++v)
+            {
+                const uint64_t fresh = next[v] & ~seen[v];
+                next[v] = 0;
+                frontier[v] = fresh;
+                if (!fresh)
+                {
+                    continue;
+                }
+                seen[v] |= fresh;
+                local_active.push_back(static_cast<VertexId>(v));
+                uint64_t bits = fresh;
+                while (bits)
+                {
+                    hops[v * num_groups + __builtin_ctzll(bits)] = next_hops;
+                    bits &= bits - 1;
+                    ++discovered;
+                }
+            }
+#pragma omp critical
+            {
+                active.insert(active.end(), local_active.begin(), local_active.end());
+            }
+        }
+
+        auto end = chrono::high_resolution_clock::now();
+        chrono::duration<double> elapsed = end - start;
+        stats.push_back({current_level, pull, frontier_size, edges_scanned, discovered, elapsed.count()});
+        if (!pull)
+        {
+            record_busy_times(scheduler, stats.back());
+        }
+        std::cout << "Level " << current_level << (pull ? " (pull)" : " (push)") << ": active vertices " << frontier_size
+                  << ", edges scanned " << edges_scanned << ", new (vertex, group) pairs " << discovered
+                  << ", time " << elapsed.count() << " seconds" << std::endl;
+    }
+    return stats;
+}
@@ -0,0 +1,182 @@
+#include "neighborhood_sketch.hpp"
+#include "bitmap.hpp"
+#include <cmath>
+
+using namespace std;
+
+namespace
+{
+    // Counters merged per scheduling chunk; hubs have millions of list entries
+    const int MERGE_CHUNK = 256;
+
+    // splitmix64 finalizer, so neighboring vertex ids land in unrelated registers
+    inline uint64_t hash_vertex(uint64_t v, uint64_t seed)
+    {
+        uint64_t z = v + seed * 0x9e3779b97f4a7c15ULL + 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // HyperLogLog estimate (Flajolet et al.) with the linear counting correction for small counts
+    float estimate_count(const uint8_t *registers, size_t num_registers, const double *inverse_powers)
+    {
+        double sum = 0.0;
+        size_t zeros = 0;
+        for (size_t j = 0; j < num_registers; ++j)
+        {
+            sum += inverse_powers[registers[j]];
+            zeros += registers[j] == 0;
+        }
+        const double m = static_cast<double>(num_registers);
+        const double alpha = num_registers == 16 ? 0.673 : num_registers == 32 ? 0.697 : num_registers == 64 ? 0.709 : 0.7213 / (1.0 + 1.079 / m);
+        double estimate = alpha * m * m / sum;
+        if (estimate <= 2.5 * m && zeros > 0)
+        {
+            estimate = m * std::log(m / static_cast<double>(zeros));
+        }
+        return static_cast<float>(estimate);
+    }
+}
+
+uint64_t sketch_memory_bytes(size_t num_vertices, int precision)
+{
+    return 2 * static_cast<uint64_t>(num_vertices) << precision;
+}
+
+int sketch_precision_for_memory(size_t num_vertices, uint64_t memory_bytes, int max_precision)
+{
+    int precision = std::min(max_precision, MAX_SKETCH_PRECISION);
+    while (precision > MIN_SKETCH_PRECISION && sketch_memory_bytes(num_vertices, precision) > memory_bytes)
+    {
+        --precision;
+    }
+    return std::max(precision, MIN_SKETCH_PRECISION);
+}
+
+std::vector<SketchIterationStats> neighborhood_sizes(const CSRGraph &graph, int max_hops, int precision, std::vector<float> &reach, uint64_t hash_seed)
+{
+    if (precision < MIN_SKETCH_PRECISION || precision > MAX_SKETCH_PRECISION)
+    {
+        throw std::invalid_argument("Sketch precision must be between " + std::to_string(MIN_SKETCH_PRECISION) + " and " + std::to_string(MAX_SKETCH_PRECISION));
+    }
+    const size_t n = num_vertices(graph);
+    const size_t hops_per_vertex = static_cast<size_t>(std::max(0, max_hops));
+    const size_t m = size_t(1) << precision;
+    std::vector<SketchIterationStats> stats;
+    reach.assign(n * hops_per_vertex, 0.0f);
+    if (n == 0 || hops_per_vertex == 0)
+    {
+        return stats;
+    }
+
+    double inverse_powers[66];
+    for (int r = 0; r < 66; ++r)
+    {
+        inverse_powers[r] = std::ldexp(1.0, -r);
+    }
+
+    // Counters hold their own vertex to start with: one register set to the rank of its hash
+    std::vector<uint8_t> registers(n * m, 0);
+    std::vector<uint8_t> merged(n * m);
+#pragma omp parallel for schedule(static)
+    for (size_t v = 0; v < n; ++v)
+    {
+        const uint64_t hash = hash_vertex(v, hash_seed);
+        // Leading zeros after the index bits, the guard bit caps the rank at 64 - precision + 1
+        const uint8_t rank = static_cast<uint8_t>(__builtin_clzll((hash << precision) | (uint64_t(1) << (precision - 1))) + 1);
+        registers[v * m + (hash >> (64 - precision))] = rank;
+    }
+
+    // Every counter grew from empty to its own vertex before the first iteration
+    Bitmap grew(n), growing(n);
+#pragma omp parallel for schedule(static)
+    for (size_t w = 0; w < grew.num_words(); ++w)
+    {
+        grew.set_word(w, ~uint64_t(0));
+    }
+
+    int hops = 1;
+    for (; hops <= max_hops; ++hops)
+    {
+        auto start = chrono::high_resolution_clock::now();
+        growing.reset();
+        size_t changed = 0;
+#pragma omp parallel for schedule(dynamic, MERGE_CHUNK) reduction(+ : changed)
+        for (size_t v = 0; v < n; ++v)
+        {
+            const uint8_t *current = &registers[v * m];
+            uint8_t *next = &merged[v * m];
+            bool touched = false;
+            for (uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e)
+            {
+                const VertexId w = graph.neighbors[e];
+                if (w == v || !grew.test(w))
+                {
+                    continue;
+                }
+                if (!touched)
+                {
+                    std::copy_n(current, m, next);
+                    touched = true;
+                }
+                const uint8_t *other = &registers[static_cast<size_t>(w) * m];
+#pragma omp simd
+                for (size_t j = 0; j < m; ++j)
+                {
+                    next[j] = std::max(next[j], other[j]);
+                }
+            }
+            if (touched)
+            {
+                int differs = 0;
+#pragma omp simd reduction(| : differs)
+                for (size_t j = 0; j < m; ++j)
+                {
+                    differs |= next[j] != current[j];
+                }
+                if (differs)
+                {
+                    growing.set_atomic(v);
+                    ++changed;
+                }
+            }
+        }
+
+        // Publish the grown counters and estimate their new size; the rest keep last iteration's estimate
+        const size_t column = static_cast<size_t>(hops - 1);
+#pragma omp parallel for schedule(dynamic, MERGE_CHUNK)
+        for (size_t v = 0; v < n; ++v)
+        {
+            float *estimates = &reach[v * hops_per_vertex];
+            if (growing.test(v))
+            {
+                std::copy_n(&merged[v * m], m, &registers[v * m]);
+                estimates[column] = estimate_count(&registers[v * m], m, inverse_powers);
+            }
+            else
+            {
+                estimates[column] = column > 0 ? estimates[column - 1] : estimate_count(&registers[v * m], m, inverse_powers);
+            }
+        }
+        grew.swap(growing);
+        chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+        stats.push_back({hops, changed, elapsed.count()});
+        if (changed == 0)
+        {
+            break;
+        }
+    }
+
+    // Balls stop growing once no counter did
+    for (++hops; hops <= max_hops; ++hops)
+    {
+        const size_t column = static_cast<size_t>(hops - 1);
+#pragma omp parallel for schedule(static)
+        for (size_t v = 0; v < n; ++v)
+        {
+            reach[v * hops_per_vertex + column] = reach[v * hops_per_vertex + column - 1];
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,202 @@
+#include "parallel_bfs.hpp"
+#include "bfs_levels.hpp"
+#include <numeric>
+
+using namespace std;
+
+void queue_to_bitmap(const std::vector<VertexId> &queue, Bitmap &bitmap)
+{
+    bitmap.reset();
+#pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < queue.size(); ++i)
+    {
+        bitmap.set_atomic(queue[i]);
+    }
+}
+
+void bitmap_to_queue(const Bitmap &bitmap, std::vector<VertexId> &queue)
+{
+    queue.clear();
+#pragma omp parallel
+    {
+        std::vector<VertexId> local_queue;
+#pragma omp for schedule(static) nowait
+        for (size_t w = 0; w < bitmap.num_words(); ++w)
+        {
+            uint64_t bits = bitmap.word(w);
+            while (bits)
+            {
+                local_queue.push_back(static_cast<VertexId>(w * 64 + __builtin_ctzll(bits)));
+                bits &= bits - 1;
+            }
+        }
+#pragma omp critical
+        {
+            queue.insert(queue.end(), local_queue.begin(), local_queue.end());
+        }
+    }
+}
+
+namespace
+{
+    // Adjacency of bfs_levels over a CSRGraph pair, following only edges of at least min_weight.
+    // Top-down levels share the frontier's edges out with a FrontierScheduler.
+    class CSRAdjacency
+    {
+    public:
+        CSRAdjacency(const CSRGraph &graph, const CSRGraph &reverse_graph, float min_weight)
+            : graph_(graph), reverse_graph_(reverse_graph), min_weight_(min_weight)
+        {
+        }
+
+        size_t vertex_count() const { return num_vertices(graph_); }
+
+        size_t edge_count() const { return num_edges(graph_); }
+
+        uint64_t degree(VertexId v) const { return weighted_end(v, graph_, min_weight_) - graph_.offsets[v]; }
+
+        template <typename Visit>
+        void for_each_in_neighbor(VertexId v, Visit visit) const
+        {
+            const uint64_t in_end = weighted_end(v, reverse_graph_, min_weight_);
+            for (uint64_t e = reverse_graph_.offsets[v]; e < in_end && !visit(reverse_graph_.neighbors[e]); ++e)
+            {
+            }
+        }
+
+        uint64_t plan_top_down(const std::vector<VertexId> &queue)
+        {
+            scheduler_.plan(queue, graph_, [this](VertexId u)
+                            { return weighted_end(u, graph_, min_weight_); });
+            return scheduler_.total_edges();
+        }
+
+        template <typename Visit>
+        void for_each_frontier_edge(const std::vector<VertexId> &, Visit visit)
+        {
+            scheduler_.run([&](VertexId u, uint64_t begin, uint64_t end)
+                           {
+                for (uint64_t e = begin; e < end; ++e)
+                {
+                    visit(u, graph_.neighbors[e]);
+                } });
+        }
+
+        void record_top_down(BFSLevelStats &level) const { record_busy_times(scheduler_, level); }
+
+    private:
+        const CSRGraph &graph_;
+        const CSRGraph &reverse_graph_;
+        float min_weight_;
+        FrontierScheduler scheduler_;
+    };
+}
+
+void record_busy_times(const FrontierScheduler &scheduler, BFSLevelStats &level)
+{
+    const std::vector<double> &busy = scheduler.busy_seconds();
+    if (busy.empty())
+    {
+        return;
+    }
+    level.max_busy_seconds = *std::max_element(busy.begin(), busy.end());
+    level.mean_busy_seconds = std::accumulate(busy.begin(), busy.end(), 0.0) / busy.size();
+    level.steals = scheduler.steals();
+}
+
+std::vector<BFSLevelStats> bfs_direction_optimizing(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &seeds, int max_hops, std::vector<uint8_t> &hops, int alpha, int beta, float min_weight, bool quiet)
+{
+    CSRAdjacency adjacency(graph, reverse_graph, min_weight);
+    return bfs_levels(adjacency, seeds, max_hops, hops, alpha, beta, nullptr, quiet);
+}
+
+std::vector<BFSLevelStats> bfs_with_predecessors(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &seeds, int max_hops, std::vector<uint8_t> &hops, std::vector<VertexId> &parents, int alpha, int beta)
+{
+    parents.assign(num_vertices(graph), NO_PREDECESSOR);
+    CSRAdjacency adjacency(graph, reverse_graph, 0.0f);
+    return bfs_levels(adjacency, seeds, max_hops, hops, alpha, beta, parents.data(), false);
+}
+
+std::vector<VertexId> trace_path(VertexId v, const std::vector<VertexId> &parents)
+{
+    std::vector<VertexId> path;
+    if (v >= parents.size() || parents[v] == NO_PREDECESSOR)
+    {
+        return path;
+    }
+    path.push_back(v);
+    while (parents[v] != v)
+    {
+        v = parents[v];
+        path.push_back(v);
+    }
+    // Seed first, in the direction the funds moved
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+std::vector<std::vector<VertexId>> trace_paths(const std::vector<VertexId> &targets, const std::vector<VertexId> &parents)
+{
+    std::vector<std::vector<VertexId>> paths(targets.size());
+#pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < targets.size(); ++i)
+    {
+        paths[i] = trace_path(targets[i], parents);
+    }
+    return paths;
+}
+
+void bfs_from_kyc_nodes_parallel(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::unordered_set<Vertex> &kyc_nodes, int max_hops, std::unordered_map<string, int> &address_to_hops, const std::unordered_map<Vertex, string> &vertex_to_address)
+{
+    std::cout << "Initializing KYC nodes' distance" << std::endl;
+    std::vector<VertexId> seeds(kyc_nodes.begin(), kyc_nodes.end());
+    std::vector<uint8_t> hops;
+    bfs_direction_optimizing(graph, reverse_graph, seeds, max_hops, hops);
+
+    // Addresses the BFS did not reach within max_hops get a distance of 6
+    for (const auto &vertex_address_pair : vertex_to_address)
+    {
+        const Vertex v = vertex_address_pair.first;
+        address_to_hops[vertex_address_pair.second] = (v < hops.size() && hops[v] != UNVISITED_HOPS) ? hops[v] : 6;
+    }
+}
+
+std::vector<uint8_t> bfs_weight_thresholds(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &seeds, const std::vector<float> &thresholds, int max_hops)
+{
+    const size_t n = num_vertices(graph);
+    const size_t num_thresholds = thresholds.size();
+    std::vector<uint8_t> columns(n * num_thresholds, UNVISITED_HOPS);
+    std::vector<uint8_t> hops;
+    for (size_t t = 0; t < num_thresholds; ++t)
+    {
+        std::cout << "BFS over transfers of at least " << thresholds[t] << " USD" << std::endl;
+        std::ostringstream name;
+        name << "usd_" << thresholds[t];
+        record_bfs_levels(name.str(), bfs_direction_optimizing(graph, reverse_graph, seeds, max_hops, hops, 15, 18, thresholds[t]));
+#pragma omp parallel for schedule(static)
+        for (size_t v = 0; v < n; ++v)
+        {
+            columns[v * num_thresholds + t] = hops[v];
+        }
+    }
+    return columns;
+}
+
+std::vector<uint8_t> bfs_forward_backward(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &seeds, int max_hops)
+{
+    const size_t n = num_vertices(graph);
+    std::vector<uint8_t> columns(n * 2);
+    std::vector<uint8_t> forward_hops, backward_hops;
+    std::cout << "BFS along transfers out of the seeds" << std::endl;
+    record_bfs_levels("forward", bfs_direction_optimizing(graph, reverse_graph, seeds, max_hops, forward_hops));
+    // Swapping the two indexes walks every edge against its direction
+    std::cout << "BFS along transfers into the seeds" << std::endl;
+    record_bfs_levels("backward", bfs_direction_optimizing(reverse_graph, graph, seeds, max_hops, backward_hops));
+#pragma omp parallel for schedule(static)
+    for (size_t v = 0; v < n; ++v)
+    {
+        columns[v * 2] = forward_hops[v];
+        columns[v * 2 + 1] = backward_hops[v];
+    }
+    return columns;
+}
@@ -0,0 +1,134 @@
+#include "query_client.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <functional>
+#include <thread>
+
+using namespace std;
+
+bool QueryClient::connect(const std::string &endpoint_text)
+{
+    disconnect();
+    Endpoint endpoint;
+    if (!parse_endpoint(endpoint_text, endpoint))
+    {
+        return false;
+    }
+    fd_ = open_connection(endpoint);
+    reader_.reset(fd_);
+    return fd_ >= 0;
+}
+
+void QueryClient::disconnect()
+{
+    if (fd_ >= 0)
+    {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool QueryClient::request(const std::string &line, std::vector<std::string> &response, std::string &error)
+{
+    response.clear();
+    error.clear();
+    const std::string message = line + "\n";
+    std::string header;
+    if (fd_ < 0 || !write_all(fd_, message.data(), message.size()) || reader_.read_line(header) <= 0)
+    {
+        error = "connection lost";
+        return false;
+    }
+    if (header.compare(0, 3, "OK ") != 0)
+    {
+        error = header.compare(0, 4, "ERR ") == 0 ? header.substr(4) : "malformed response " + header;
+        return false;
+    }
+    const size_t num_lines = std::stoull(header.substr(3));
+    response.resize(num_lines);
+    for (size_t i = 0; i < num_lines; ++i)
+    {
+        if (reader_.read_line(response[i]) <= 0)
+        {
+            error = "connection lost";
+            return false;
+        }
+    }
+    return true;
+}
+
+namespace
+{
+    // One load generator connection; latencies of the successful requests go to latencies
+    void run_client(const std::string &endpoint, const std::vector<std::string> &requests, size_t first_request, size_t num_requests, std::vector<double> &latencies, size_t &errors)
+    {
+        QueryClient client;
+        if (!client.connect(endpoint))
+        {
+            errors = num_requests;
+            return;
+        }
+        latencies.reserve(num_requests);
+        std::vector<std::string> response;
+        std::string error;
+        for (size_t i = 0; i < num_requests; ++i)
+        {
+            const std::string &request = requests[(first_request + i) % requests.size()];
+            auto sent = chrono::high_resolution_clock::now();
+            const bool ok = client.request(request, response, error);
+            chrono::duration<double, std::milli> latency = chrono::high_resolution_clock::now() - sent;
+            if (ok)
+            {
+                latencies.push_back(latency.count());
+                continue;
+            }
+            ++errors;
+            if (error == "connection lost")
+            {
+                // The rest of this client's requests cannot be sent
+                errors += num_requests - i - 1;
+                return;
+            }
+        }
+    }
+}
+
+LoadReport generate_load(const std::string &endpoint, const std::vector<std::string> &requests, int num_clients, size_t requests_per_client)
+{
+    std::vector<std::vector<double>> latencies(num_clients);
+    std::vector<size_t> errors(num_clients, 0);
+    std::vector<std::thread> clients;
+    auto start = chrono::high_resolution_clock::now();
+    for (int c = 0; c < num_clients && !requests.empty(); ++c)
+    {
+        clients.emplace_back(run_client, std::cref(endpoint), std::cref(requests), static_cast<size_t>(c) * 7919, requests_per_client, std::ref(latencies[c]), std::ref(errors[c]));
+    }
+    for (std::thread &client : clients)
+    {
+        client.join();
+    }
+    chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+
+    std::vector<double> all_latencies;
+    LoadReport report{0, 0, elapsed.count(), 0.0, 0.0, 0.0, 0.0};
+    for (int c = 0; c < num_clients; ++c)
+    {
+        all_latencies.insert(all_latencies.end(), latencies[c].begin(), latencies[c].end());
+        report.errors += errors[c];
+    }
+    report.requests = all_latencies.size();
+    if (!all_latencies.empty())
+    {
+        std::sort(all_latencies.begin(), all_latencies.end());
+        auto percentile = [&all_latencies](double p)
+        {
+            return all_latencies[std::min(all_latencies.size() - 1, static_cast<size_t>(p * all_latencies.size()))];
+        };
+        report.p50_ms = percentile(0.50);
+        report.p99_ms = percentile(0.99);
+        report.max_ms = all_latencies.back();
+    }
+    report.queries_per_second = report.seconds > 0 ? report.requests / report.seconds : 0.0;
+    return report;
+}
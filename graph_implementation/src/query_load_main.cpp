@@ -0,0 +1,53 @@
+#include "query_client.hpp"
+#include "parse_number.hpp"
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+namespace
+{
+    int usage()
+    {
+        cerr << "Usage: query_load <unix:path|tcp:port> <request file> [clients] [requests per client]" << endl;
+        return 1;
+    }
+}
+
+// Load generator for "uni_graph serve": replays the request lines of a file against the server
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        return usage();
+    }
+    const std::string endpoint = argv[1];
+    int num_clients = 4;
+    size_t requests_per_client = 1000;
+    if ((argc > 3 && (!parse_number(argv[3], num_clients) || num_clients < 1)) || (argc > 4 && (!parse_number(argv[4], requests_per_client) || requests_per_client < 1)))
+    {
+        return usage();
+    }
+
+    std::vector<std::string> requests;
+    ifstream request_file(argv[2]);
+    string line;
+    while (getline(request_file, line))
+    {
+        if (!line.empty())
+        {
+            requests.push_back(line);
+        }
+    }
+    if (requests.empty())
+    {
+        cerr << "Error: No requests in " << argv[2] << endl;
+        return 1;
+    }
+
+    LoadReport report = generate_load(endpoint, requests, num_clients, requests_per_client);
+    cout << num_clients << " clients, " << report.requests << " requests, " << report.errors << " errors in " << report.seconds << " seconds" << endl;
+    cout << "Throughput: " << report.queries_per_second << " queries/s" << endl;
+    cout << "Latency: p50 " << report.p50_ms << " ms, p99 " << report.p99_ms << " ms, max " << report.max_ms << " ms" << endl;
+    return report.errors == 0 ? 0 : 1;
+}
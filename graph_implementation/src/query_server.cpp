@@ -0,0 +1,338 @@
+#include "query_server.hpp"
+#include "socket_io.hpp"
+
+using namespace std;
+
+namespace
+{
+    // How often blocked accept and read calls look at the stop flag
+    const int POLL_INTERVAL_MS = 200;
+
+    // Longest accepted max_hops for on-demand BFS; hop counts are stored in one byte
+    const int MAX_QUERY_HOPS = 100;
+
+    std::vector<std::string> split_words(const std::string &line)
+    {
+        std::vector<std::string> words;
+        std::istringstream stream(line);
+        std::string word;
+        while (stream >> word)
+        {
+            words.push_back(word);
+        }
+        return words;
+    }
+
+    std::string error_response(const std::string &message)
+    {
+        return "ERR " + message + "\n";
+    }
+
+    // "OK <n>" header followed by the already formatted lines
+    std::string ok_response(size_t num_lines, const std::string &lines)
+    {
+        return "OK " + std::to_string(num_lines) + "\n" + lines;
+    }
+
+    std::string hops_text(uint8_t hops, uint8_t unreached_hops)
+    {
+        return std::to_string(hops == UNVISITED_HOPS ? unreached_hops : hops);
+    }
+}
+
+QueryEngine::QueryEngine(const CSRGraph &graph, const CSRGraph &reverse_graph, const AddressInterner &interner, const std::vector<VertexId> &seeds, int max_hops)
+    : graph_(graph), reverse_graph_(reverse_graph), interner_(interner), max_hops_(max_hops), num_seeds_(seeds.size())
+{
+    bfs_with_predecessors(graph_, reverse_graph_, seeds, max_hops_, hops_, parents_);
+}
+
+std::string QueryEngine::handle(const std::string &request) const
+{
+    const std::vector<std::string> words = split_words(request);
+    if (words.empty())
+    {
+        return error_response("empty request");
+    }
+    if (words[0] == "HOPS")
+    {
+        return hops_response(words);
+    }
+    if (words[0] == "PATH")
+    {
+        return path_response(words);
+    }
+    if (words[0] == "BFS")
+    {
+        return bfs_response(words);
+    }
+    if (words[0] == "STATS")
+    {
+        return ok_response(1, std::to_string(num_vertices(graph_)) + "," + std::to_string(num_edges(graph_)) + "," + std::to_string(num_seeds_) + "," + std::to_string(max_hops_) + "\n");
+    }
+    return error_response("unknown command " + words[0]);
+}
+
+std::string QueryEngine::hops_response(const std::vector<std::string> &words) const
+{
+    const uint8_t unreached_hops = static_cast<uint8_t>(max_hops_ + 1);
+    std::string lines;
+    lines.reserve((words.size() - 1) * 90);
+    for (size_t i = 1; i < words.size(); ++i)
+    {
+        lines += words[i];
+        VertexId v;
+        if (!interner_.find(words[i], v))
+        {
+            lines += ",,\n";
+            continue;
+        }
+        lines += ',';
+        lines += hops_text(hops_[v], unreached_hops);
+        lines += ',';
+        if (parents_[v] != NO_PREDECESSOR)
+        {
+            // Walk up to the seed, at most max_hops steps
+            while (parents_[v] != v)
+            {
+                v = parents_[v];
+            }
+            lines += interner_.address(v);
+        }
+        lines += '\n';
+    }
+    return ok_response(words.size() - 1, lines);
+}
+
+std::string QueryEngine::path_response(const std::vector<std::string> &words) const
+{
+    const uint8_t unreached_hops = static_cast<uint8_t>(max_hops_ + 1);
+    std::string lines;
+    for (size_t i = 1; i < words.size(); ++i)
+    {
+        lines += words[i];
+        VertexId v;
+        if (!interner_.find(words[i], v))
+        {
+            lines += ",,,\n";
+            continue;
+        }
+        const std::vector<VertexId> path = trace_path(v, parents_);
+        lines += ',';
+        lines += hops_text(hops_[v], unreached_hops);
+        lines += ',';
+        if (!path.empty())
+        {
+            lines += interner_.address(path.front());
+        }
+        lines += ',';
+        for (size_t p = 0; p < path.size(); ++p)
+        {
+            if (p > 0)
+            {
+                lines += '>';
+            }
+            lines += interner_.address(path[p]);
+        }
+        lines += '\n';
+    }
+    return ok_response(words.size() - 1, lines);
+}
+
+std::string QueryEngine::bfs_response(const std::vector<std::string> &words) const
+{
+    if (words.size() < 3 || words[1].find_first_not_of("0123456789") != std::string::npos || words[1].size() > 3)
+    {
+        return error_response("usage: BFS <max_hops> <seed>[,<seed>...] [<address>...]");
+    }
+    const int max_hops = std::stoi(words[1]);
+    if (max_hops > MAX_QUERY_HOPS)
+    {
+        return error_response("max_hops is limited to " + std::to_string(MAX_QUERY_HOPS));
+    }
+    std::vector<VertexId> seeds;
+    std::istringstream seed_list(words[2]);
+    std::string seed_address;
+    while (getline(seed_list, seed_address, ','))
+    {
+        VertexId v;
+        if (interner_.find(seed_address, v))
+        {
+            seeds.push_back(v);
+        }
+    }
+
+    // Every request gets its own BFS buffers, so concurrent BFS requests do not share state.
+    // The level log would interleave across connections, so the BFS runs quiet.
+    std::vector<uint8_t> hops;
+    bfs_direction_optimizing(graph_, reverse_graph_, seeds, max_hops, hops, 15, 18, 0.0f, true);
+    const uint8_t unreached_hops = static_cast<uint8_t>(max_hops + 1);
+    std::string lines;
+    if (words.size() == 3)
+    {
+        std::vector<size_t> level_counts(max_hops + 1, 0);
+        for (const uint8_t h : hops)
+        {
+            if (h != UNVISITED_HOPS)
+            {
+                ++level_counts[h];
+            }
+        }
+        for (int level = 0; level <= max_hops; ++level)
+        {
+            lines += std::to_string(level) + "," + std::to_string(level_counts[level]) + "\n";
+        }
+        return ok_response(level_counts.size(), lines);
+    }
+    for (size_t i = 3; i < words.size(); ++i)
+    {
+        lines += words[i];
+        lines += ',';
+        VertexId v;
+        if (interner_.find(words[i], v))
+        {
+            lines += hops_text(hops[v], unreached_hops);
+        }
+        lines += '\n';
+    }
+    return ok_response(words.size() - 3, lines);
+}
+
+QueryServer::QueryServer(const QueryEngine &engine, int threads_per_request)
+    : engine_(engine), listen_fd_(-1), threads_per_request_(std::max(1, std::min(threads_per_request, omp_get_max_threads()))), stopping_(false)
+{
+}
+
+QueryServer::~QueryServer()
+{
+    stop();
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    for (Connection &connection : connections_)
+    {
+        if (connection.thread.joinable())
+        {
+            connection.thread.join();
+        }
+    }
+    if (listen_fd_ >= 0)
+    {
+        close(listen_fd_);
+    }
+    if (!unix_path_.empty())
+    {
+        unlink(unix_path_.c_str());
+    }
+}
+
+bool QueryServer::listen(const std::string &endpoint_text)
+{
+    Endpoint endpoint;
+    if (!parse_endpoint(endpoint_text, endpoint))
+    {
+        std::cerr << "Error: Invalid endpoint " << endpoint_text << " (expected unix:<path> or tcp:<port>)" << std::endl;
+        return false;
+    }
+    listen_fd_ = open_listener(endpoint);
+    if (listen_fd_ < 0)
+    {
+        std::cerr << "Error: Unable to listen on " << endpoint_text << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (endpoint.is_unix)
+    {
+        unix_path_ = endpoint.path;
+    }
+    std::cout << "Listening on " << endpoint_text << std::endl;
+    return true;
+}
+
+void QueryServer::serve()
+{
+    while (!stopping_.load())
+    {
+        pollfd waiting{listen_fd_, POLLIN, 0};
+        const int ready = poll(&waiting, 1, POLL_INTERVAL_MS);
+        reap_connections();
+        if (ready <= 0)
+        {
+            continue;
+        }
+        int fd = accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0)
+        {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        connections_.emplace_back();
+        Connection &connection = connections_.back();
+        connection.thread = std::thread(&QueryServer::handle_connection, this, fd, &connection.done);
+    }
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    for (Connection &connection : connections_)
+    {
+        connection.thread.join();
+    }
+    connections_.clear();
+}
+
+size_t QueryServer::num_connections()
+{
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    return connections_.size();
+}
+
+void QueryServer::reap_connections()
+{
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    for (auto connection = connections_.begin(); connection != connections_.end();)
+    {
+        if (connection->done.load())
+        {
+            connection->thread.join();
+            connection = connections_.erase(connection);
+        }
+        else
+        {
+            ++connection;
+        }
+    }
+}
+
+void QueryServer::stop()
+{
+    stopping_.store(true);
+}
+
+void QueryServer::handle_connection(int fd, std::atomic<bool> *done)
+{
+    // Applies to the parallel regions this thread starts, so a BFS request cannot take every core
+    omp_set_num_threads(threads_per_request_);
+    SocketLineReader reader(fd);
+    std::string request;
+    while (!stopping_.load())
+    {
+        const int status = reader.read_line(request, POLL_INTERVAL_MS);
+        if (status < 0)
+        {
+            break;
+        }
+        if (status == 0)
+        {
+            continue;
+        }
+        std::string response;
+        try
+        {
+            response = engine_.handle(request);
+        }
+        catch (const std::exception &e)
+        {
+            response = error_response(e.what());
+        }
+        if (!write_all(fd, response.data(), response.size()))
+        {
+            break;
+        }
+    }
+    close(fd);
+    done->store(true);
+}
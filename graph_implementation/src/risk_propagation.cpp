@@ -0,0 +1,126 @@
+#include "risk_propagation.hpp"
+#include <cmath>
+
+using namespace std;
+
+namespace
+{
+    // Pull-based products: a vertex's in-list is short on average but hubs have millions of entries
+    const int PULL_CHUNK = 1024;
+
+    // 1 / total out-weight of every vertex, 0 for vertices without out-transfers
+    std::vector<double> inverse_out_weights(const CSRGraph &graph)
+    {
+        const size_t n = num_vertices(graph);
+        const bool weighted = !graph.weights.empty();
+        std::vector<double> inverse(n);
+#pragma omp parallel for schedule(dynamic, PULL_CHUNK)
+        for (size_t v = 0; v < n; ++v)
+        {
+            double total = 0.0;
+            if (weighted)
+            {
+                const float *weights = graph.weights.data();
+#pragma omp simd reduction(+ : total)
+                for (uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e)
+                {
+                    total += weights[e];
+                }
+            }
+            else
+            {
+                total = static_cast<double>(out_degree(static_cast<VertexId>(v), graph));
+            }
+            inverse[v] = total > 0.0 ? 1.0 / total : 0.0;
+        }
+        return inverse;
+    }
+}
+
+std::vector<PageRankIterationStats> personalized_pagerank(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &seeds, std::vector<double> &scores, double damping, double tolerance, int max_iterations)
+{
+    const size_t n = num_vertices(graph);
+    std::vector<PageRankIterationStats> stats;
+    scores.assign(n, 0.0);
+    std::vector<VertexId> restart_seeds(seeds);
+    std::sort(restart_seeds.begin(), restart_seeds.end());
+    restart_seeds.erase(std::unique(restart_seeds.begin(), restart_seeds.end()), restart_seeds.end());
+    if (restart_seeds.empty())
+    {
+        return stats;
+    }
+    const double seed_share = 1.0 / restart_seeds.size();
+    for (const VertexId seed : restart_seeds)
+    {
+        scores[seed] = seed_share;
+    }
+
+    const std::vector<double> inverse_out_weight = inverse_out_weights(graph);
+    const bool weighted = !reverse_graph.weights.empty();
+    const uint64_t *offsets = reverse_graph.offsets.data();
+    const VertexId *senders = reverse_graph.neighbors.data();
+    const float *weights = reverse_graph.weights.data();
+    // Score each sender passes on per unit of transfer weight
+    std::vector<double> outflow(n);
+    std::vector<double> next(n);
+
+    for (int iteration = 0; iteration < max_iterations; ++iteration)
+    {
+        auto start = chrono::high_resolution_clock::now();
+        double dangling = 0.0;
+        double *flow = outflow.data();
+        const double *current = scores.data();
+        const double *inverse = inverse_out_weight.data();
+#pragma omp parallel for simd schedule(static) reduction(+ : dangling)
+        for (size_t v = 0; v < n; ++v)
+        {
+            flow[v] = current[v] * inverse[v];
+            dangling += inverse[v] == 0.0 ? current[v] : 0.0;
+        }
+
+#pragma omp parallel for schedule(dynamic, PULL_CHUNK)
+        for (size_t v = 0; v < n; ++v)
+        {
+            double sum = 0.0;
+            if (weighted)
+            {
+#pragma omp simd reduction(+ : sum)
+                for (uint64_t e = offsets[v]; e < offsets[v + 1]; ++e)
+                {
+                    sum += flow[senders[e]] * weights[e];
+                }
+            }
+            else
+            {
+#pragma omp simd reduction(+ : sum)
+                for (uint64_t e = offsets[v]; e < offsets[v + 1]; ++e)
+                {
+                    sum += flow[senders[e]];
+                }
+            }
+            next[v] = damping * sum;
+        }
+        // The teleport and the score stuck at vertices without out-transfers restart at the seeds
+        const double restart = ((1.0 - damping) + damping * dangling) * seed_share;
+        for (const VertexId seed : restart_seeds)
+        {
+            next[seed] += restart;
+        }
+
+        double residual = 0.0;
+        const double *updated = next.data();
+#pragma omp parallel for simd schedule(static) reduction(+ : residual)
+        for (size_t v = 0; v < n; ++v)
+        {
+            residual += std::fabs(updated[v] - current[v]);
+        }
+        scores.swap(next);
+        chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+        stats.push_back({iteration, residual, elapsed.count()});
+        if (residual < tolerance)
+        {
+            break;
+        }
+    }
+    return stats;
+}
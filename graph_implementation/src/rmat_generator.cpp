@@ -0,0 +1,157 @@
+#include "rmat_generator.hpp"
+#include <cmath>
+#include <cstdio>
+
+using namespace std;
+
+namespace
+{
+    inline uint64_t splitmix64(uint64_t &state)
+    {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    inline double uniform(uint64_t &state)
+    {
+        return (splitmix64(state) >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // R-MAT concentrates the high degrees on the low ids; an odd multiplier permutes the ids
+    inline uint64_t scramble(uint64_t vertex, uint32_t scale)
+    {
+        return (vertex * 0x9e3779b97f4a7c15ULL + 0x632be59bd9b4e019ULL) & ((uint64_t(1) << scale) - 1);
+    }
+
+    // One edge of the recursive quadrant model, before scrambling
+    inline void rmat_edge(uint64_t &state, const RMATParams &params, uint64_t &src, uint64_t &dst)
+    {
+        src = 0;
+        dst = 0;
+        const double ab = params.a + params.b;
+        const double abc = ab + params.c;
+        for (uint32_t bit = 0; bit < params.scale; ++bit)
+        {
+            const double r = uniform(state);
+            src <<= 1;
+            dst <<= 1;
+            if (r >= ab)
+            {
+                src |= 1;
+            }
+            if ((r >= params.a && r < ab) || r >= abc)
+            {
+                dst |= 1;
+            }
+        }
+    }
+
+    AddressKey rmat_key(uint64_t vertex, uint64_t seed)
+    {
+        uint64_t state = vertex * 0xd1b54a32d192ed03ULL ^ seed;
+        AddressKey key;
+        for (size_t i = 0; i < sizeof(key.bytes); i += 8)
+        {
+            const uint64_t word = splitmix64(state);
+            std::memcpy(key.bytes + i, &word, std::min<size_t>(8, sizeof(key.bytes) - i));
+        }
+        return key;
+    }
+
+    std::string chunk_filename(const std::string &base_filename, size_t index)
+    {
+        char suffix[16];
+        std::snprintf(suffix, sizeof(suffix), "%012zu", index);
+        return base_filename + suffix;
+    }
+}
+
+std::string rmat_address(uint64_t vertex, uint64_t seed)
+{
+    return format_address_key(rmat_key(vertex, seed));
+}
+
+std::vector<std::string> write_rmat_chunks(const std::string &base_filename, const RMATParams &params)
+{
+    if (params.scale == 0 || params.scale > 31)
+    {
+        throw std::runtime_error("R-MAT scale must be between 1 and 31");
+    }
+    const uint64_t num_edges = (uint64_t(1) << params.scale) * params.edge_factor;
+    const size_t num_chunks = static_cast<size_t>((num_edges + params.lines_per_chunk - 1) / params.lines_per_chunk);
+    std::vector<std::string> chunk_files(num_chunks);
+    std::vector<int> failed(num_chunks, 0);
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (size_t chunk = 0; chunk < num_chunks; ++chunk)
+    {
+        chunk_files[chunk] = chunk_filename(base_filename, chunk);
+        // Every chunk has its own random stream, so the files do not depend on the thread count
+        uint64_t state = params.seed * 0x2545f4914f6cdd1dULL + chunk;
+        const uint64_t begin = chunk * params.lines_per_chunk;
+        const uint64_t end = std::min<uint64_t>(num_edges, begin + params.lines_per_chunk);
+        std::string buffer = "address1,address2,total_transfer_usd\n";
+        buffer.reserve((end - begin) * 100);
+        char amount[32];
+        for (uint64_t e = begin; e < end; ++e)
+        {
+            uint64_t src, dst;
+            rmat_edge(state, params, src, dst);
+            src = scramble(src, params.scale);
+            dst = scramble(dst, params.scale);
+            if (params.hot_wallets > 0 && uniform(state) < params.hot_wallet_share)
+            {
+                // Deposits into and withdrawals from an exchange hot wallet
+                const uint64_t hot_wallet = splitmix64(state) % params.hot_wallets;
+                (splitmix64(state) & 1 ? dst : src) = hot_wallet;
+            }
+            char line[85];
+            format_address_key(rmat_key(src, params.seed), line);
+            line[42] = ',';
+            format_address_key(rmat_key(dst, params.seed), line + 43);
+            buffer.append(line, 85);
+            const int length = std::snprintf(amount, sizeof(amount), ",%.2f\n", std::pow(10.0, 5.0 * uniform(state)));
+            buffer.append(amount, length);
+        }
+        FILE *out = std::fopen(chunk_files[chunk].c_str(), "wb");
+        if (!out || std::fwrite(buffer.data(), 1, buffer.size(), out) != buffer.size())
+        {
+            failed[chunk] = 1;
+        }
+        if (out && std::fclose(out) != 0)
+        {
+            failed[chunk] = 1;
+        }
+    }
+    for (size_t chunk = 0; chunk < num_chunks; ++chunk)
+    {
+        if (failed[chunk])
+        {
+            throw std::runtime_error("Failed to write chunk file " + chunk_files[chunk]);
+        }
+    }
+    return chunk_files;
+}
+
+size_t write_rmat_kyc(const std::string &filename, const RMATParams &params, uint64_t stride)
+{
+    ofstream kyc_file(filename);
+    if (!kyc_file)
+    {
+        throw std::runtime_error("Unable to open KYC file " + filename);
+    }
+    kyc_file << "address\n";
+    size_t count = 0;
+    for (uint64_t v = 0; v < params.hot_wallets; ++v, ++count)
+    {
+        kyc_file << rmat_address(v, params.seed) << '\n';
+    }
+    const uint64_t num_vertices = uint64_t(1) << params.scale;
+    for (uint64_t v = params.hot_wallets; v < num_vertices; v += std::max<uint64_t>(1, stride), ++count)
+    {
+        kyc_file << rmat_address(v, params.seed) << '\n';
+    }
+    return count;
+}
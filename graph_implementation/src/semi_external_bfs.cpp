@@ -0,0 +1,384 @@
+#include "semi_external_bfs.hpp"
+#include "bfs_levels.hpp"
+#include <cstdio>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace
+{
+    const char PARTITIONS_MAGIC[8] = {'E', 'A', 'I', 'P', 'A', 'R', 'T', 'S'};
+
+    // Partitions and the dictionary start on page boundaries
+    const uint64_t PARTITION_ALIGNMENT = 4096;
+
+    // Fixed-size header; the chunk list and the partition table follow it (index_bytes in total)
+    struct PartitionsHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t num_vertices;
+        uint64_t num_edges;
+        uint64_t num_partitions;
+        uint64_t index_bytes;
+        uint64_t interner_offset;
+        uint64_t interner_bytes;
+    };
+
+    uint64_t align_up(uint64_t offset)
+    {
+        return (offset + PARTITION_ALIGNMENT - 1) / PARTITION_ALIGNMENT * PARTITION_ALIGNMENT;
+    }
+
+    void pad_to(std::ostream &out, uint64_t offset)
+    {
+        static const char zeros[PARTITION_ALIGNMENT] = {0};
+        const uint64_t position = static_cast<uint64_t>(out.tellp());
+        out.write(zeros, offset - position);
+    }
+
+    // Vertex ranges of about partition_bytes each, in id order
+    std::vector<EdgePartition> cut_partitions(const CSRGraph &graph, uint64_t partition_bytes)
+    {
+        const size_t n = num_vertices(graph);
+        std::vector<EdgePartition> partitions;
+        EdgePartition current{0, 0, 0, 0};
+        for (size_t v = 0; v < n; ++v)
+        {
+            const uint64_t degree = graph.offsets[v + 1] - graph.offsets[v];
+            const uint64_t grown = current.bytes() + sizeof(uint64_t) + degree * sizeof(VertexId);
+            if (current.num_vertices > 0 && grown > partition_bytes)
+            {
+                partitions.push_back(current);
+                current = EdgePartition{v, 0, 0, 0};
+            }
+            ++current.num_vertices;
+            current.num_edges += degree;
+        }
+        if (current.num_vertices > 0)
+        {
+            partitions.push_back(current);
+        }
+        return partitions;
+    }
+
+    // Reads exactly size bytes at offset, retrying short reads
+    bool pread_fully(int fd, void *buffer, uint64_t size, uint64_t offset)
+    {
+        char *out = static_cast<char *>(buffer);
+        while (size > 0)
+        {
+            const ssize_t got = ::pread(fd, out, size, static_cast<off_t>(offset));
+            if (got < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (got <= 0)
+            {
+                return false;
+            }
+            out += got;
+            size -= static_cast<uint64_t>(got);
+            offset += static_cast<uint64_t>(got);
+        }
+        return true;
+    }
+}
+
+void write_edge_partitions(const std::string &filename, const CSRGraph &graph, const AddressInterner &interner, const std::vector<ChunkFingerprint> &chunks, uint64_t partition_bytes)
+{
+    std::vector<EdgePartition> partitions = cut_partitions(graph, partition_bytes);
+    const std::string temporary_filename = filename + ".tmp";
+    {
+        std::ofstream out(temporary_filename, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            throw std::runtime_error("Unable to open partition file " + temporary_filename);
+        }
+
+        // The header is patched with the dictionary's position once it is written
+        PartitionsHeader header{};
+        std::memcpy(header.magic, PARTITIONS_MAGIC, sizeof(header.magic));
+        header.version = EDGE_PARTITIONS_VERSION;
+        header.num_vertices = num_vertices(graph);
+        header.num_edges = num_edges(graph);
+        header.num_partitions = partitions.size();
+        write_pod(out, header);
+
+        write_chunk_list(out, chunks);
+        // The table size is known now, so the partition offsets can be filled in before writing it
+        const uint64_t table_offset = static_cast<uint64_t>(out.tellp());
+        header.index_bytes = table_offset + partitions.size() * sizeof(EdgePartition) - sizeof(PartitionsHeader);
+        uint64_t offset = align_up(table_offset + partitions.size() * sizeof(EdgePartition));
+        for (EdgePartition &partition : partitions)
+        {
+            partition.file_offset = offset;
+            offset = align_up(offset + partition.bytes());
+        }
+        write_array(out, partitions.data(), partitions.size());
+
+        std::vector<uint64_t> local_offsets;
+        for (const EdgePartition &partition : partitions)
+        {
+            pad_to(out, partition.file_offset);
+            // Offsets relative to the partition's first edge, then its neighbors
+            local_offsets.resize(partition.num_vertices + 1);
+            const uint64_t first_edge = graph.offsets[partition.first_vertex];
+            for (uint64_t i = 0; i <= partition.num_vertices; ++i)
+            {
+                local_offsets[i] = graph.offsets[partition.first_vertex + i] - first_edge;
+            }
+            out.write(reinterpret_cast<const char *>(local_offsets.data()), local_offsets.size() * sizeof(uint64_t));
+            out.write(reinterpret_cast<const char *>(graph.neighbors.data() + first_edge), partition.num_edges * sizeof(VertexId));
+        }
+
+        header.interner_offset = align_up(static_cast<uint64_t>(out.tellp()));
+        pad_to(out, header.interner_offset);
+        interner.write_to(out);
+        header.interner_bytes = static_cast<uint64_t>(out.tellp()) - header.interner_offset;
+        out.seekp(0);
+        write_pod(out, header);
+        if (!out)
+        {
+            throw std::runtime_error("Failed to write partition file " + temporary_filename);
+        }
+    }
+    if (std::rename(temporary_filename.c_str(), filename.c_str()) != 0)
+    {
+        throw std::runtime_error("Unable to move partition file into place at " + filename);
+    }
+}
+
+bool PartitionedGraph::open(const std::string &filename, const std::vector<ChunkFingerprint> &expected_chunks, uint64_t memory_budget, AddressInterner &interner)
+{
+    close();
+    fd_ = ::open(filename.c_str(), O_RDONLY);
+    if (fd_ < 0)
+    {
+        std::cout << "No edge partitions at " << filename << std::endl;
+        return false;
+    }
+    PartitionsHeader header;
+    if (!pread_fully(fd_, &header, sizeof(header), 0) || std::memcmp(header.magic, PARTITIONS_MAGIC, sizeof(header.magic)) != 0)
+    {
+        std::cerr << "Error: " << filename << " is not an edge partition file" << std::endl;
+        close();
+        return false;
+    }
+    if (header.version != EDGE_PARTITIONS_VERSION)
+    {
+        std::cout << "Edge partition version " << header.version << " is outdated (expected " << EDGE_PARTITIONS_VERSION << ")" << std::endl;
+        close();
+        return false;
+    }
+
+    // Chunk list and partition table
+    std::vector<uint64_t> index((header.index_bytes + 7) / 8);
+    if (!pread_fully(fd_, index.data(), header.index_bytes, sizeof(header)))
+    {
+        std::cerr << "Error: Edge partitions " << filename << " are truncated" << std::endl;
+        close();
+        return false;
+    }
+    BinaryReader reader(reinterpret_cast<const char *>(index.data()), header.index_bytes);
+    std::vector<ChunkFingerprint> chunks;
+    read_chunk_list(reader, chunks);
+    const EdgePartition *table = reader.read_array<EdgePartition>(header.num_partitions);
+    if (!table)
+    {
+        std::cerr << "Error: Edge partitions " << filename << " have a corrupt index" << std::endl;
+        close();
+        return false;
+    }
+    if (chunks != expected_chunks)
+    {
+        std::cout << "Edge partitions " << filename << " are stale: their source chunks changed" << std::endl;
+        close();
+        return false;
+    }
+    partitions_.assign(table, table + header.num_partitions);
+    uint64_t next_vertex = 0, total_edges = 0;
+    for (const EdgePartition &partition : partitions_)
+    {
+        if (partition.first_vertex != next_vertex || partition.file_offset + partition.bytes() > header.interner_offset)
+        {
+            std::cerr << "Error: Edge partitions " << filename << " have an inconsistent partition table" << std::endl;
+            close();
+            return false;
+        }
+        next_vertex += partition.num_vertices;
+        total_edges += partition.num_edges;
+        max_partition_bytes_ = std::max(max_partition_bytes_, partition.bytes());
+    }
+
+    std::vector<uint64_t> dictionary((header.interner_bytes + 7) / 8);
+    BinaryReader dictionary_reader(reinterpret_cast<const char *>(dictionary.data()), header.interner_bytes);
+    if (next_vertex != header.num_vertices || total_edges != header.num_edges || !pread_fully(fd_, dictionary.data(), header.interner_bytes, header.interner_offset) || !interner.read_from(dictionary_reader) || interner.size() != header.num_vertices)
+    {
+        std::cerr << "Error: Edge partitions " << filename << " have inconsistent sections" << std::endl;
+        interner = AddressInterner();
+        close();
+        return false;
+    }
+    num_vertices_ = header.num_vertices;
+    num_edges_ = header.num_edges;
+
+    // Leading partitions stay in memory while they fit next to the two streaming buffers
+    uint64_t available = memory_budget > 2 * max_partition_bytes_ ? memory_budget - 2 * max_partition_bytes_ : 0;
+    while (num_resident_ < partitions_.size() && partitions_[num_resident_].bytes() <= available)
+    {
+        available -= partitions_[num_resident_].bytes();
+        resident_.emplace_back();
+        read_partition(num_resident_, resident_.back());
+        ++num_resident_;
+    }
+    // Everything resident: the streaming buffers are never needed
+    if (num_resident_ == partitions_.size())
+    {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    return true;
+}
+
+void PartitionedGraph::close()
+{
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+    }
+    fd_ = -1;
+    num_vertices_ = 0;
+    num_edges_ = 0;
+    max_partition_bytes_ = 0;
+    partitions_.clear();
+    resident_.clear();
+    num_resident_ = 0;
+    bytes_read_ = 0;
+}
+
+void PartitionedGraph::read_partition(size_t p, std::vector<uint64_t> &buffer)
+{
+    const EdgePartition &partition = partitions_[p];
+    buffer.resize((partition.bytes() + 7) / 8);
+    if (fd_ < 0 || !pread_fully(fd_, buffer.data(), partition.bytes(), partition.file_offset))
+    {
+        throw std::runtime_error("Failed to read edge partition " + std::to_string(p));
+    }
+    bytes_read_ += partition.bytes();
+}
+
+std::vector<BFSLevelStats> bfs_semi_external(PartitionedGraph &graph, const std::vector<VertexId> &seeds, int max_hops, std::vector<uint8_t> &hops)
+{
+    const size_t n = graph.num_vertices();
+    const std::vector<EdgePartition> &partitions = graph.partitions();
+    hops.assign(n, UNVISITED_HOPS);
+    Bitmap visited(n);
+    std::vector<VertexId> queue;
+    std::vector<BFSLevelStats> stats;
+    for (const VertexId seed : seeds)
+    {
+        if (seed < n && visited.set_atomic(seed))
+        {
+            hops[seed] = 0;
+            queue.push_back(seed);
+        }
+    }
+
+    // Streaming buffers: one being expanded, one being filled
+    std::vector<uint64_t> buffers[2];
+    for (int current_level = 0; current_level < max_hops && !queue.empty(); ++current_level)
+    {
+        auto start = chrono::high_resolution_clock::now();
+        const uint8_t next_hops = static_cast<uint8_t>(current_level + 1);
+        const uint64_t bytes_before = graph.bytes_read();
+
+        // Frontier slice of every touched partition, in file order
+        std::sort(queue.begin(), queue.end());
+        std::vector<std::pair<size_t, size_t>> slices; // (partition, end of its slice in queue)
+        for (size_t i = 0; i < queue.size();)
+        {
+            const size_t p = std::upper_bound(partitions.begin(), partitions.end(), queue[i], [](VertexId v, const EdgePartition &partition)
+                                              { return v < partition.first_vertex; }) -
+                             partitions.begin() - 1;
+            const size_t end = std::lower_bound(queue.begin() + i, queue.end(), partitions[p].first_vertex + partitions[p].num_vertices) - queue.begin();
+            slices.emplace_back(p, end);
+            i = end;
+        }
+
+        // Reads the next streamed partition after slice s into the buffer not in use
+        size_t fill = 0;
+        std::future<void> pending;
+        auto prefetch_after = [&](size_t s)
+        {
+            for (++s; s < slices.size(); ++s)
+            {
+                const size_t p = slices[s].first;
+                if (!graph.resident(p))
+                {
+                    std::vector<uint64_t> &buffer = buffers[fill];
+                    fill ^= 1;
+                    pending = std::async(std::launch::async, [&graph, p, &buffer]()
+                                         { graph.read_partition(p, buffer); });
+                    return;
+                }
+            }
+        };
+        prefetch_after(static_cast<size_t>(-1));
+
+        size_t edges_scanned = 0;
+        size_t discovered = 0;
+        std::vector<VertexId> next_queue;
+        size_t begin = 0;
+        for (size_t s = 0; s < slices.size(); ++s)
+        {
+            const EdgePartition &partition = partitions[slices[s].first];
+            const uint64_t *data = graph.resident(slices[s].first);
+            if (!data)
+            {
+                // The read of this partition is the pending one; its buffer is the one filled last
+                pending.get();
+                data = buffers[fill ^ 1].data();
+                prefetch_after(s);
+            }
+            const uint64_t *offsets = data;
+            const VertexId *neighbors = reinterpret_cast<const VertexId *>(data + partition.num_vertices + 1);
+            const size_t end = slices[s].second;
+#pragma omp parallel reduction(+ : edges_scanned, discovered)
+            {
+                std::vector<VertexId> local_queue;
+#pragma omp for schedule(dynamic, 64) nowait
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const uint64_t local = queue[i] - partition.first_vertex;
+                    EAI_METRIC(edges_scanned += offsets[local + 1] - offsets[local]);
+                    for (uint64_t e = offsets[local]; e < offsets[local + 1]; ++e)
+                    {
+                        const VertexId v = neighbors[e];
+                        if (claim_vertex(v, next_hops, visited, hops))
+                        {
+                            local_queue.push_back(v);
+                            ++discovered;
+                        }
+                    }
+                }
+#pragma omp critical
+                {
+                    next_queue.insert(next_queue.end(), local_queue.begin(), local_queue.end());
+                }
+            }
+            begin = end;
+        }
+
+        chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+        stats.push_back({current_level, false, queue.size(), edges_scanned, discovered, elapsed.count()});
+        std::cout << "Level " << current_level << " (semi-external): frontier " << queue.size() << ", partitions " << slices.size() << "/" << partitions.size()
+                  << ", read " << (graph.bytes_read() - bytes_before) / (1024.0 * 1024.0) << " MB, discovered " << discovered
+                  << ", time " << elapsed.count() << " seconds" << std::endl;
+        queue = std::move(next_queue);
+    }
+    return stats;
+}
@@ -1,183 +1,222 @@
 #include "uni_graph.hpp"
+#include "parallel_bfs.hpp"
+#include "chunk_loader.hpp"
+#include "graph_snapshot.hpp"
+#include "hop_output.hpp"
+#include "multi_source_bfs.hpp"
+#include "query_server.hpp"
+#include "metrics.hpp"
+#include "vertex_order.hpp"
+#include "compressed_graph.hpp"
+#include "semi_external_bfs.hpp"
+#include "incremental_bfs.hpp"
+#include "risk_propagation.hpp"
+#include "neighborhood_sketch.hpp"
+#include <csignal>
+#include <functional>
+#include <sys/stat.h>
 
 using namespace std;
 using namespace boost;
 
-void bfs_from_kyc_nodes_parallel(const Graph &graph, const std::unordered_set<Vertex> &kyc_nodes, int max_hops, std::unordered_map<string, int> &address_to_hops, const std::unordered_map<Vertex, string> &vertex_to_address)
+namespace
 {
+    // Directory holding the transfer chunks, the graph snapshot and the KYC files
+    std::string data_directory(const std::string &home_directory)
+    {
+        return home_directory + "/econ_project/src/proj23_03_tracebility/data/";
+    }
 
-    // Declare a hash set visited to store the nodes that have already been visited during the BFS.
-    std::unordered_set<Vertex> visited;
-    visited.reserve(8000000);
-    // Declare a double-ended queue queue to store pairs of nodes and their associated levels (number of hops from the nearest KYC node).
-    deque<pair<Vertex, int>> queue; // (node, level)
-    // Declare a mutex visited_mutex to handle concurrent access to the visited hash set.
-    std::mutex visited_mutex;
-    std::atomic<int> visited_counter(0);
-    std::cout << "Initializing KYC nodes' distance" << std::endl;
-
-    // Initialize the BFS starting points by marking all KYC nodes as visited, and setting their distance to 0.
-    for (const Vertex &kyc_node : kyc_nodes)
+    std::string output_directory(const std::string &home_directory)
     {
-        // Mark as visited
-        visited.insert(kyc_node);
-        // Prepare for the first level iteration
-        queue.push_back(make_pair(kyc_node, 0));
-        // Set the distance to 0 if this address is in the graph
-        auto it = vertex_to_address.find(kyc_node);
-        if (it != vertex_to_address.end())
+        return home_directory + "/econ_project/src/proj23_03_tracebility/output/";
+    }
+
+    // Runs one subcommand against the data under $HOME as a metrics run named run_name; the body
+    // returns the exit status, and an exception thrown by it is reported as status 1
+    int run_pipeline(const std::string &run_name, const std::function<int(const std::string &)> &body)
+    {
+        const char *home_dir = getenv("HOME");
+        if (!home_dir)
         {
-            address_to_hops[it->second] = 0;
+            cerr << "Error: HOME environment variable not set" << endl;
+            return 1;
+        }
+        try
+        {
+            metrics_begin_run(run_name);
+            return body(home_dir);
+        }
+        catch (std::exception const &e)
+        {
+            cerr << "Exception thrown: " << e.what() << "\n";
+            return 1;
         }
     }
 
-    /* Start iterating */
-    for (int current_level = 0; current_level < max_hops; ++current_level)
+    bool has_suffix(const std::string &text, const std::string &suffix)
     {
-        std::cout << "Handling level " << current_level << std::endl;
-        // Declare a double-ended queue next_level_queue to store nodes and their associated levels for the next BFS level.
-        deque<pair<Vertex, int>> next_level_queue;
-        // Declare a hash set next_level_nodes_set to track unique nodes in the next BFS level.
-        std::unordered_set<Vertex> next_level_nodes_set;
+        return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
 
-#pragma omp parallel
-        {
-            // Declare a double-ended queue local_queue in each parallel thread to store pairs of nodes and their associated levels.
-            deque<pair<Vertex, int>> local_queue;
+    uint64_t file_size(const std::string &filename)
+    {
+        struct stat file_stat;
+        return stat(filename.c_str(), &file_stat) == 0 ? static_cast<uint64_t>(file_stat.st_size) : 0;
+    }
 
-#pragma omp for schedule(static) nowait
-            for (size_t i = 0; i < queue.size(); ++i)
-            {
-                Vertex node;
-                int level;
-                // Get the node and level from the queue
-                tie(node, level) = queue[i];
-
-                // Check all the neighbors of the node
-                graph_traits<Graph>::adjacency_iterator ai, ai_end;
-                for (tie(ai, ai_end) = adjacent_vertices(node, graph); ai != ai_end; ++ai)
-                {
-                    Vertex neighbor = *ai;
-                    // Using a mutex to avoid race condition
-                    {
-                        std::lock_guard<std::mutex> lock(visited_mutex);
-                        /*If this neighbor is not found in visited, update the visited section and local_queue */
-                        if (visited.find(neighbor) == visited.end())
-                        {
-                            visited.insert(neighbor);
-                            local_queue.push_back(make_pair(neighbor, level + 1));
-                            // Increment the visited_counter and print the size of visited if it's a multiple of 10,000
-                            if (++visited_counter % 1000000 == 0)
-                            {
-                                std::cout << "Visited size: " << visited.size() << std::endl;
-                            }
-                        }
-                    }
-                }
-            }
+    // Server stopped by SIGINT or SIGTERM
+    QueryServer *running_server = nullptr;
 
-#pragma omp critical
-            {
-                for (const auto &node_level_pair : local_queue) // Addtional checks for duplicates
-                {
-                    if (next_level_nodes_set.find(node_level_pair.first) == next_level_nodes_set.end())
-                    {
-                        next_level_nodes_set.insert(node_level_pair.first);
-                        next_level_queue.push_back(node_level_pair);
-                    }
-                }
-            }
+    void stop_running_server(int)
+    {
+        if (running_server)
+        {
+            running_server->stop();
         }
+    }
 
-        for (const auto &[node, level] : next_level_queue)
+    // Loads the transfer graph from its snapshot, or from every chunk if the snapshot is stale
+    bool load_transfer_graph(const std::string &home_directory, CSRGraph &graph, CSRGraph &reverse_graph, AddressInterner &interner)
+    {
+        auto start = chrono::high_resolution_clock::now();
+        PhaseTimer phase("ingest");
+        std::string base_filename = data_directory(home_directory) + "uni_transfer_history_";
+        std::vector<std::string> chunk_files = find_chunk_files(base_filename);
+        if (chunk_files.empty())
+        {
+            cerr << "Error: No transfer history chunks found for " << base_filename << endl;
+            return false;
+        }
+        std::cout << "Found " << chunk_files.size() << " transfer history chunks" << std::endl;
+        // Reuse the compiled snapshot unless the chunks changed since it was written
+        const std::string snapshot_filename = base_filename + "graph.snapshot";
+        const bool from_snapshot = load_or_build_graph(chunk_files, snapshot_filename, graph, reverse_graph, interner);
+        if (from_snapshot)
         {
-            auto it = vertex_to_address.find(node);
-            if (it != vertex_to_address.end())
+            phase.add_bytes_read(file_size(snapshot_filename));
+        }
+        else
+        {
+            for (const std::string &chunk_filename : chunk_files)
             {
-                address_to_hops[it->second] = level;
+                phase.add_bytes_read(file_size(chunk_filename));
             }
         }
+        phase.set_counter("chunks", chunk_files.size());
+        phase.set_counter("from_snapshot", from_snapshot);
+        phase.set_counter("vertices", num_vertices(graph));
+        phase.set_counter("edges", num_edges(graph));
+        phase.set_counter("graph_bytes", memory_bytes(graph));
+        phase.set_counter("reverse_graph_bytes", memory_bytes(reverse_graph));
+        phase.set_counter("interner_bytes", interner.memory_bytes());
+        phase.stop();
+
+        auto end = chrono::high_resolution_clock::now();
+
+        // Print relevant information for the graph built
+        chrono::duration<double> elapsed = end - start;
+        std::cout << "Build graph time: " << elapsed.count() << " seconds" << std::endl;
+        std::cout << "Graph has " << num_vertices(graph) << " vertices and " << num_edges(graph) << " edges." << std::endl;
+        std::cout << "Address interner memory: " << interner.memory_bytes() / (1024.0 * 1024.0) << " MB" << std::endl;
+        std::cout << "CSR graph memory: " << memory_bytes(graph) / (1024.0 * 1024.0) << " MB, of which edge weights: " << weight_memory_bytes(graph) / (1024.0 * 1024.0) << " MB" << std::endl;
+        std::cout << "Reverse index memory: " << memory_bytes(reverse_graph) / (1024.0 * 1024.0) << " MB ("
+                  << 100.0 * memory_bytes(reverse_graph) / std::max<size_t>(1, memory_bytes(graph)) << "% of the forward graph)" << std::endl;
+        return true;
+    }
 
-        queue = std::move(next_level_queue);
+    // read_kyc_addr, recorded as the KYC load phase
+    std::vector<VertexId> load_kyc_seeds(const std::string &kyc_address_filename, const AddressInterner &interner)
+    {
+        PhaseTimer phase("kyc_load");
+        phase.add_bytes_read(file_size(kyc_address_filename));
+        std::vector<VertexId> kyc_nodes = read_kyc_addr(kyc_address_filename, interner);
+        phase.set_counter("seeds", kyc_nodes.size());
+        return kyc_nodes;
     }
-    // Iterate through all the vertices in the graph
-    for (const auto &vertex_address_pair : vertex_to_address)
+
+    // Relabels both graphs and the seeds by ordering, recorded as the reorder phase. Returns the
+    // new id of every original vertex, for mapping the results back.
+    std::vector<VertexId> reorder_transfer_graph(VertexOrdering ordering, CSRGraph &graph, CSRGraph &reverse_graph, std::vector<VertexId> &seeds)
+    {
+        auto start = chrono::high_resolution_clock::now();
+        PhaseTimer phase(std::string("reorder_") + vertex_ordering_name(ordering));
+        std::vector<VertexId> new_id = compute_vertex_order(graph, reverse_graph, seeds, ordering);
+        // One graph at a time, so at most one extra copy is alive
+        graph = relabel_csr_graph(graph, new_id);
+        reverse_graph = relabel_csr_graph(reverse_graph, new_id);
+        seeds = relabel_vertices(seeds, new_id);
+        phase.stop();
+        chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+        std::cout << "Relabeled vertices in " << vertex_ordering_name(ordering) << " order in " << elapsed.count() << " seconds" << std::endl;
+        return new_id;
+    }
+
+    // "address,old_hops,new_hops" lines for a seed delta; returns the bytes written
+    size_t write_hop_changes_text(const std::string &filename, const std::vector<HopChange> &changes, const AddressInterner &interner, uint8_t unreached_hops)
     {
-        // If the address is not in the address_to_hops map, set its distance to 6
-        if (address_to_hops.find(vertex_address_pair.second) == address_to_hops.end())
+        std::ofstream out(filename);
+        if (!out)
         {
-            address_to_hops[vertex_address_pair.second] = 6;
+            throw std::runtime_error("Unable to open output file " + filename);
         }
+        out << "address,old_hops,new_hops\n";
+        for (const HopChange &change : changes)
+        {
+            out << interner.address(change.vertex) << ',' << int(std::min(change.old_hops, unreached_hops)) << ',' << int(std::min(change.new_hops, unreached_hops)) << '\n';
+        }
+        if (!out)
+        {
+            throw std::runtime_error("Failed to write output file " + filename);
+        }
+        return static_cast<size_t>(out.tellp());
     }
-}
 
-void build_graph_from_chunks(const std::string &base_filename, int num_chunks, Graph &graph, std::unordered_map<std::string, Vertex> &address_to_vertex)
-{
-    std::ostringstream chunk_filename_stream;
-    std::string line;
-
-    for (int i = 0; i < num_chunks; ++i)
+    // Best of a few BFS runs, to keep the ordering comparison clear of warm-up noise
+    double time_kyc_bfs(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &seeds, int max_hops, std::vector<uint8_t> &hops)
     {
-        chunk_filename_stream.str(""); // Clear the contents
-        chunk_filename_stream.clear(); // Reset error flags
-        chunk_filename_stream << base_filename << std::setw(12) << std::setfill('0') << i;
-        std::string chunk_filename = chunk_filename_stream.str();
-        std::ifstream input_file(chunk_filename);
-        if (!input_file)
+        double best = std::numeric_limits<double>::max();
+        for (int run = 0; run < 3; ++run)
         {
-            std::cerr << "Error: Unable to open file " << chunk_filename << std::endl;
-            continue;
+            auto start = chrono::high_resolution_clock::now();
+            bfs_direction_optimizing(graph, reverse_graph, seeds, max_hops, hops);
+            chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+            best = std::min(best, elapsed.count());
         }
-        std::cout << "Processing file " << chunk_filename << std::endl;
+        return best;
+    }
+}
 
-        // Skip the header line
-        std::getline(input_file, line);
+void bfs_from_kyc_nodes_parallel(const Graph &graph, const std::unordered_set<Vertex> &kyc_nodes, int max_hops, std::unordered_map<string, int> &address_to_hops, const std::unordered_map<Vertex, string> &vertex_to_address)
+{
+    // One conversion, then the lock-free CSR BFS instead of a mutex-guarded visited set
+    const CSRGraph csr_graph = build_csr_graph(graph);
+    bfs_from_kyc_nodes_parallel(csr_graph, transpose_csr_graph(csr_graph), kyc_nodes, max_hops, address_to_hops, vertex_to_address);
+}
 
-        while (std::getline(input_file, line))
-        {
-            try
-            {
-                std::istringstream line_stream(line);
-                std::string address1, address2, total_transfer_usd_str;
-                std::getline(line_stream, address1, ',');
-                std::getline(line_stream, address2, ',');
-                // Total transfer amount is not needed at the moment
-                std::getline(line_stream, total_transfer_usd_str, ',');
-                float total_transfer_usd = std::stof(total_transfer_usd_str);
-
-                Vertex v1, v2;
-                auto it1 = address_to_vertex.find(address1);
-                if (it1 == address_to_vertex.end())
-                {
-                    v1 = add_vertex(graph);
-                    address_to_vertex.try_emplace(address1, v1);
-                }
-                else
-                {
-                    v1 = it1->second;
-                }
+void build_graph_from_chunks(const std::string &base_filename, int num_chunks, Graph &graph, AddressInterner &interner)
+{
+    std::vector<TransferEdge> edges;
+    load_transfer_chunks(numbered_chunk_files(base_filename, num_chunks), interner, edges);
 
-                auto it2 = address_to_vertex.find(address2);
-                if (it2 == address_to_vertex.end())
-                {
-                    v2 = add_vertex(graph);
-                    address_to_vertex.try_emplace(address2, v2);
-                }
-                else
-                {
-                    v2 = it2->second;
-                }
+    // Interner ids are handed out in order of first appearance, matching the vertex ids
+    while (num_vertices(graph) < interner.size())
+    {
+        add_vertex(graph);
+    }
+    for (const TransferEdge &edge : edges)
+    {
+        add_edge(edge.src, edge.dst, graph);
+    }
+}
 
-                if (address1 != address2 && total_transfer_usd >= 10.0)
-                {
-                    add_edge(v1, v2, graph);
-                }
-            }
-            catch (const std::exception &e)
-            {
-                std::cerr << "Error: Failed to parse CSV line in file " << chunk_filename << ": " << e.what() << std::endl;
-            }
-        }
+void build_graph_from_chunks(const std::string &base_filename, int num_chunks, Graph &graph, std::unordered_map<std::string, Vertex> &address_to_vertex)
+{
+    AddressInterner interner;
+    build_graph_from_chunks(base_filename, num_chunks, graph, interner);
+    for (VertexId id = 0; id < interner.size(); ++id)
+    {
+        address_to_vertex.try_emplace(interner.address(id), id);
     }
 }
 
@@ -213,66 +252,77 @@ std::unordered_set<Vertex> read_kyc_addr(const std::string &kyc_address_filename
     return kyc_nodes;
 }
 
-int calculates_eai_dist(const std::string kyc_filename, const std::string output_filename)
+std::vector<VertexId> read_kyc_addr(const std::string &kyc_address_filename, const AddressInterner &interner)
 {
-    // Get the home directory
-    const char *home_dir = getenv("HOME");
-    if (!home_dir)
+    // Read KYC addresses
+    ifstream kyc_address_file(kyc_address_filename);
+    std::vector<VertexId> kyc_nodes;
+    string kyc_address;
+    size_t counter = 0;
+    // Skip 1 line
+    getline(kyc_address_file, kyc_address);
+    // Iterate
+    while (getline(kyc_address_file, kyc_address))
     {
-        cerr << "Error: HOME environment variable not set" << endl;
-        return 1;
+        VertexId id;
+        if (interner.find(kyc_address, id))
+        {
+            kyc_nodes.push_back(id);
+        }
+
+        // Increment counter
+        counter++;
+        // Print progress every 1 million records
+        if (counter % 1000000 == 0)
+        {
+            std::cout << "Processed " << counter << " records." << std::endl;
+        }
     }
-    string home_directory(home_dir);
-    // std::cout << home_directory << std::endl;
-    try
-    {
-        auto start = chrono::high_resolution_clock::now();
+    kyc_address_file.close();
 
+    // Drop duplicate KYC rows
+    std::sort(kyc_nodes.begin(), kyc_nodes.end());
+    kyc_nodes.erase(std::unique(kyc_nodes.begin(), kyc_nodes.end()), kyc_nodes.end());
+    return kyc_nodes;
+}
+
+int calculates_eai_dist(const std::string kyc_filename, const std::string output_filename)
+{
+    return calculates_eai_dist(kyc_filename, output_filename, VertexOrdering::Original, HopOutputOrder::VertexOrder);
+}
+
+int calculates_eai_dist(const std::string kyc_filename, const std::string output_filename, VertexOrdering ordering, HopOutputOrder order)
+{
+    return run_pipeline("calculates_eai_dist", [&](const std::string &home_directory)
+                        {
         // Initializations
-        Graph graph;
-        std::unordered_map<string, Vertex> address_to_vertex;
         // Reserve spaces for 13 million vertices
-        address_to_vertex.reserve(13000000);
-        // Vector to store the hop counts
-        std::unordered_map<string, int> address_to_hops;
-        address_to_hops.reserve(10000000);
-
-// Set different file paths based on the operating system
-#ifdef __APPLE__
-        string kyc_address_filename = home_directory + "/circle_files/econ_project/src/proj23_03_tracebility/data/" + kyc_filename;
-
-#elif __linux__
-        // Set the paths for the Linux operating system
-        string kyc_address_filename = home_directory + "/econ_project/src/proj23_03_tracebility/data/" + kyc_filename;
-#endif
+        AddressInterner interner(13000000);
+        string kyc_address_filename = data_directory(home_directory) + kyc_filename;
+
         /*--------------------------------------------
-        Build graph using 298 chunks of transfer_history files
+        Build graph using every chunk of transfer_history files
         --------------------------------------------*/
-        int num_chunks = 298;
-        std::string base_filename = home_directory + "/econ_project/src/proj23_03_tracebility/data/uni_transfer_history_";
-        build_graph_from_chunks(base_filename, num_chunks, graph, address_to_vertex);
-
-        // Create the reverse vertex_to_address mapping from address_to_vertex
-        std::unordered_map<Vertex, std::string> vertex_to_address;
-        vertex_to_address.reserve(address_to_vertex.size());
-
-        for (const auto &entry : address_to_vertex)
+        CSRGraph csr_graph;
+        // In-neighbor lists for the bottom-up BFS levels
+        CSRGraph reverse_graph;
+        if (!load_transfer_graph(home_directory, csr_graph, reverse_graph, interner))
         {
-            vertex_to_address[entry.second] = entry.first;
+            return 1;
         }
 
-        auto end = chrono::high_resolution_clock::now();
-
-        // Print relevant information for the graph built
-        chrono::duration<double> elapsed = end - start;
-        std::cout << "Build graph time: " << elapsed.count() << " seconds" << std::endl;
-        std::cout << "Graph has " << num_vertices(graph) << " vertices and " << num_edges(graph) << " edges." << std::endl;
-
         /*--------------------------------------------
         Read KYC addresses
         --------------------------------------------*/
         std::cout << "Start reading EAI file" << std::endl;
-        std::unordered_set<Vertex> kyc_nodes = read_kyc_addr(kyc_address_filename, address_to_vertex);
+        std::vector<VertexId> kyc_nodes = load_kyc_seeds(kyc_address_filename, interner);
+
+        // Optional cache-locality relabeling; the interner keeps the original ids
+        std::vector<VertexId> new_id;
+        if (ordering != VertexOrdering::Original)
+        {
+            new_id = reorder_transfer_graph(ordering, csr_graph, reverse_graph, kyc_nodes);
+        }
 
         /*--------------------------------------------
         Run efficient BFS and calculates KYC distance
@@ -280,7 +330,16 @@ int calculates_eai_dist(const std::string kyc_filename, const std::string output
         std::cout << "Start BFS" << std::endl;
         int max_hops = 5;
         auto start_bfs = chrono::high_resolution_clock::now();
-        bfs_from_kyc_nodes_parallel(graph, kyc_nodes, max_hops, address_to_hops, vertex_to_address);
+        // Hop count per vertex id; vertices beyond max_hops keep the UNVISITED_HOPS sentinel
+        std::vector<uint8_t> hops;
+        {
+            PhaseTimer phase("bfs");
+            record_bfs_levels("kyc", bfs_direction_optimizing(csr_graph, reverse_graph, kyc_nodes, max_hops, hops));
+            if (!new_id.empty())
+            {
+                hops = to_original_order(hops, new_id);
+            }
+        }
 
         auto end_bfs = chrono::high_resolution_clock::now();
         chrono::duration<double> elapsed_bfs = end_bfs - start_bfs;
@@ -289,18 +348,832 @@ int calculates_eai_dist(const std::string kyc_filename, const std::string output
         /*--------------------------------------------
         Write results
         --------------------------------------------*/
-        ofstream address_to_hops_file(home_directory + "/econ_project/src/proj23_03_tracebility/output/" + output_filename);
-        for (const auto &entry : address_to_hops)
+        // Unreached addresses are reported as max_hops + 1; a ".bin" output name selects the binary format
+        string output_path = output_directory(home_directory) + output_filename;
+        const uint8_t unreached_hops = static_cast<uint8_t>(max_hops + 1);
+        PhaseTimer output_phase("output");
+        const size_t bytes_written = has_suffix(output_filename, ".bin") ? write_hops_binary(output_path, hops, interner, unreached_hops, order) : write_hops_text(output_path, hops, interner, unreached_hops, order);
+        output_phase.set_counter("bytes_written", bytes_written);
+        output_phase.stop();
+
+        write_metrics_report(output_path + ".metrics.json");
+        return 0; });
+}
+
+int compare_vertex_orders(const std::string kyc_filename)
+{
+    return run_pipeline("compare_vertex_orders", [&](const std::string &home_directory)
+                        {
+        AddressInterner interner(13000000);
+        CSRGraph csr_graph, reverse_graph;
+        if (!load_transfer_graph(home_directory, csr_graph, reverse_graph, interner))
         {
-            address_to_hops_file << entry.first << "," << entry.second << endl;
+            return 1;
         }
-        address_to_hops_file.close();
+        const std::vector<VertexId> kyc_nodes = load_kyc_seeds(data_directory(home_directory) + kyc_filename, interner);
 
-        return 0;
-    }
-    catch (std::exception const &e)
-    {
-        cerr << "Exception thrown: " << e.what() << "\n";
-        return 1;
-    }
+        const int max_hops = 5;
+        std::vector<uint8_t> original_hops, hops;
+        const double original_seconds = time_kyc_bfs(csr_graph, reverse_graph, kyc_nodes, max_hops, original_hops);
+        std::ostringstream report;
+        report << std::fixed << std::setprecision(3) << "original: BFS " << original_seconds << " s" << std::endl;
+        for (const VertexOrdering ordering : {VertexOrdering::Degree, VertexOrdering::BFS, VertexOrdering::RCM})
+        {
+            // Each ordering starts from the ingest order
+            CSRGraph graph = csr_graph, reverse = reverse_graph;
+            std::vector<VertexId> seeds = kyc_nodes;
+            auto start = chrono::high_resolution_clock::now();
+            const std::vector<VertexId> new_id = reorder_transfer_graph(ordering, graph, reverse, seeds);
+            const double reorder_seconds = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+
+            PhaseTimer phase(std::string("bfs_") + vertex_ordering_name(ordering));
+            const double bfs_seconds = time_kyc_bfs(graph, reverse, seeds, max_hops, hops);
+            if (to_original_order(hops, new_id) != original_hops)
+            {
+                std::cerr << "Error: " << vertex_ordering_name(ordering) << " order changed the BFS result" << std::endl;
+                return 1;
+            }
+            const double saved = original_seconds - bfs_seconds;
+            phase.set_counter("reorder_seconds", reorder_seconds);
+            phase.set_counter("bfs_seconds", bfs_seconds);
+            phase.set_counter("speedup", original_seconds / bfs_seconds);
+            report << vertex_ordering_name(ordering) << ": relabel " << reorder_seconds << " s, BFS " << bfs_seconds
+                   << " s, speedup " << original_seconds / bfs_seconds << "x, ";
+            if (saved > 0)
+            {
+                report << "pays off after " << std::ceil(reorder_seconds / saved) << " BFS runs" << std::endl;
+            }
+            else
+            {
+                report << "never pays off" << std::endl;
+            }
+        }
+        std::cout << report.str();
+        write_metrics_report(output_directory(home_directory) + "vertex_orders.metrics.json");
+        return 0; });
+}
+
+int compare_compressed_graph(const std::string kyc_filename)
+{
+    return run_pipeline("compare_compressed_graph", [&](const std::string &home_directory)
+                        {
+        AddressInterner interner(13000000);
+        CSRGraph csr_graph, reverse_graph;
+        if (!load_transfer_graph(home_directory, csr_graph, reverse_graph, interner))
+        {
+            return 1;
+        }
+        const std::vector<VertexId> kyc_nodes = load_kyc_seeds(data_directory(home_directory) + kyc_filename, interner);
+
+        CompressedGraph compressed, compressed_reverse;
+        {
+            PhaseTimer phase("compress");
+            compressed = compress_csr_graph(csr_graph);
+            compressed_reverse = compress_csr_graph(reverse_graph);
+            phase.set_counter("bytes", memory_bytes(compressed) + memory_bytes(compressed_reverse));
+        }
+
+        const int max_hops = 5;
+        std::vector<uint8_t> csr_hops, compressed_hops;
+        const double csr_seconds = time_kyc_bfs(csr_graph, reverse_graph, kyc_nodes, max_hops, csr_hops);
+        PhaseTimer phase("bfs_compressed");
+        double compressed_seconds = std::numeric_limits<double>::max();
+        for (int run = 0; run < 3; ++run)
+        {
+            auto start = chrono::high_resolution_clock::now();
+            bfs_compressed(compressed, compressed_reverse, kyc_nodes, max_hops, compressed_hops);
+            compressed_seconds = std::min(compressed_seconds, chrono::duration<double>(chrono::high_resolution_clock::now() - start).count());
+        }
+        if (compressed_hops != csr_hops)
+        {
+            std::cerr << "Error: the compressed graph changed the BFS result" << std::endl;
+            return 1;
+        }
+
+        // The BFS only reads offsets and neighbors; the weights are listed separately
+        const size_t csr_bytes = memory_bytes(csr_graph) + memory_bytes(reverse_graph);
+        const size_t weight_bytes = weight_memory_bytes(csr_graph) + weight_memory_bytes(reverse_graph);
+        const size_t compressed_bytes = memory_bytes(compressed) + memory_bytes(compressed_reverse);
+        phase.set_counter("csr_topology_bytes", csr_bytes - weight_bytes);
+        phase.set_counter("compressed_bytes", compressed_bytes);
+        phase.set_counter("csr_bfs_seconds", csr_seconds);
+        phase.set_counter("compressed_bfs_seconds", compressed_seconds);
+        phase.stop();
+        std::cout << "CSR graphs: " << csr_bytes / (1024.0 * 1024.0) << " MB (" << (csr_bytes - weight_bytes) / (1024.0 * 1024.0) << " MB without weights), "
+                  << 8.0 * (csr_bytes - weight_bytes) / std::max<size_t>(1, 2 * num_edges(csr_graph)) << " bits per edge" << std::endl;
+        std::cout << "Compressed graphs: " << compressed_bytes / (1024.0 * 1024.0) << " MB, "
+                  << 8.0 * compressed_bytes / std::max<size_t>(1, 2 * num_edges(compressed)) << " bits per edge, "
+                  << 100.0 * (1.0 - static_cast<double>(compressed_bytes) / (csr_bytes - weight_bytes)) << "% smaller" << std::endl;
+        std::cout << "BFS: " << csr_seconds << " s uncompressed, " << compressed_seconds << " s compressed ("
+                  << compressed_seconds / csr_seconds << "x the time)" << std::endl;
+        write_metrics_report(output_directory(home_directory) + "compressed_graph.metrics.json");
+        return 0; });
+}
+
+int compile_graph_snapshot()
+{
+    return run_pipeline("compile_graph_snapshot", [&](const std::string &home_directory)
+                        {
+        auto start = chrono::high_resolution_clock::now();
+        std::string base_filename = data_directory(home_directory) + "uni_transfer_history_";
+        std::vector<std::string> chunk_files = find_chunk_files(base_filename);
+        if (chunk_files.empty())
+        {
+            cerr << "Error: No transfer history chunks found for " << base_filename << endl;
+            return 1;
+        }
+
+        AddressInterner interner(13000000);
+        CSRGraph csr_graph;
+        {
+            PhaseTimer phase("ingest");
+            for (const std::string &chunk_filename : chunk_files)
+            {
+                phase.add_bytes_read(file_size(chunk_filename));
+            }
+            build_graph_from_chunks(chunk_files, csr_graph, interner);
+            phase.set_counter("vertices", num_vertices(csr_graph));
+            phase.set_counter("edges", num_edges(csr_graph));
+        }
+        {
+            PhaseTimer phase("output");
+            write_graph_snapshot(base_filename + "graph.snapshot", csr_graph, interner, fingerprint_chunks(chunk_files));
+            phase.set_counter("bytes_written", file_size(base_filename + "graph.snapshot"));
+        }
+        write_metrics_report(base_filename + "graph.snapshot.metrics.json");
+
+        chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+        std::cout << "Compiled " << chunk_files.size() << " chunks into " << base_filename << "graph.snapshot in " << elapsed.count() << " seconds" << std::endl;
+        return 0; });
+}
+
+int update_eai_dist(const std::string kyc_filename, const std::string output_filename, bool verify)
+{
+    return run_pipeline("update_eai_dist", [&](const std::string &home_directory)
+                        {
+        std::string base_filename = data_directory(home_directory) + "uni_transfer_history_";
+        std::vector<std::string> chunk_files = find_chunk_files(base_filename);
+        if (chunk_files.empty())
+        {
+            cerr << "Error: No transfer history chunks found for " << base_filename << endl;
+            return 1;
+        }
+        const std::vector<ChunkFingerprint> chunks = fingerprint_chunks(chunk_files);
+        // The graph the distances belong to, kept apart from graph.snapshot so that compile and
+        // the other subcommands rewriting that one do not force a full recompute here
+        const std::string snapshot_filename = base_filename + "graph.distances.snapshot";
+        const std::string state_filename = base_filename + "graph.distances";
+        const string kyc_address_filename = data_directory(home_directory) + kyc_filename;
+        const int max_hops = 5;
+
+        AddressInterner interner(13000000);
+        CSRGraph csr_graph;
+        std::vector<uint8_t> hops;
+        std::vector<VertexId> kyc_nodes;
+        DistanceState state;
+        std::vector<std::string> new_chunk_files;
+        // The previous distances are only usable on the exact graph they were computed on; each
+        // check says why it failed (the state and snapshot readers log their own failures)
+        bool incremental = read_distance_state(state_filename, state);
+        if (incremental && state.max_hops != max_hops)
+        {
+            std::cout << "Distance state " << state_filename << " holds distances up to " << state.max_hops << " hops, not " << max_hops << std::endl;
+            incremental = false;
+        }
+        if (incremental && !find_new_chunks(state.chunks, chunks, new_chunk_files))
+        {
+            std::cout << "A chunk of the previous run was changed or removed since " << state_filename << " was written" << std::endl;
+            incremental = false;
+        }
+        incremental = incremental && read_graph_snapshot(snapshot_filename, state.chunks, csr_graph, interner);
+        if (incremental && interner.size() != state.hops.size())
+        {
+            std::cout << "Graph snapshot " << snapshot_filename << " has " << interner.size() << " addresses, the distance state " << state.hops.size() << std::endl;
+            incremental = false;
+        }
+        if (incremental)
+        {
+            auto start = chrono::high_resolution_clock::now();
+            std::vector<TransferEdge> new_edges;
+            {
+                PhaseTimer phase("ingest");
+                phase.add_bytes_read(file_size(snapshot_filename) + file_size(state_filename));
+                for (const std::string &chunk_filename : new_chunk_files)
+                {
+                    phase.add_bytes_read(file_size(chunk_filename));
+                }
+                load_transfer_chunks(new_chunk_files, interner, new_edges);
+                csr_graph = add_edges_to_csr_graph(csr_graph, interner.size(), new_edges);
+                phase.set_counter("new_chunks", new_chunk_files.size());
+                phase.set_counter("new_edges", new_edges.size());
+                phase.set_counter("vertices", num_vertices(csr_graph));
+                phase.set_counter("edges", num_edges(csr_graph));
+            }
+            std::cout << "Added " << new_edges.size() << " transfers from " << new_chunk_files.size() << " new chunks; graph has "
+                      << num_vertices(csr_graph) << " vertices and " << num_edges(csr_graph) << " edges" << std::endl;
+            kyc_nodes = load_kyc_seeds(kyc_address_filename, interner);
+
+            // A seed dropped from the KYC list can raise distances, which only a full run handles
+            hops = std::move(state.hops);
+            for (VertexId v = 0; v < hops.size() && incremental; ++v)
+            {
+                if (hops[v] == 0 && !std::binary_search(kyc_nodes.begin(), kyc_nodes.end(), v))
+                {
+                    std::cout << "KYC address " << interner.address(v) << " was removed since the last run" << std::endl;
+                    incremental = false;
+                }
+            }
+            if (incremental)
+            {
+                PhaseTimer phase("bfs");
+                std::vector<BFSLevelStats> stats = update_distances_after_insertions(csr_graph, kyc_nodes, new_edges, max_hops, hops);
+                size_t lowered = 0;
+                for (const BFSLevelStats &level : stats)
+                {
+                    lowered += level.frontier_size;
+                }
+                phase.set_counter("lowered", lowered);
+                record_bfs_levels("incremental", stats);
+                chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+                std::cout << "Updated " << lowered << " distances in " << elapsed.count() << " seconds" << std::endl;
+            }
+            else
+            {
+                PhaseTimer phase("bfs");
+                record_bfs_levels("kyc", bfs_direction_optimizing(csr_graph, transpose_csr_graph(csr_graph), kyc_nodes, max_hops, hops));
+            }
+        }
+        else
+        {
+            std::cout << "Computing every distance from scratch" << std::endl;
+            interner = AddressInterner(13000000);
+            csr_graph = CSRGraph();
+            CSRGraph reverse_graph;
+            if (!load_transfer_graph(home_directory, csr_graph, reverse_graph, interner))
+            {
+                return 1;
+            }
+            kyc_nodes = load_kyc_seeds(kyc_address_filename, interner);
+            PhaseTimer phase("bfs");
+            record_bfs_levels("kyc", bfs_direction_optimizing(csr_graph, reverse_graph, kyc_nodes, max_hops, hops));
+        }
+
+        string output_path = output_directory(home_directory) + output_filename;
+        const uint8_t unreached_hops = static_cast<uint8_t>(max_hops + 1);
+        {
+            PhaseTimer phase("output");
+            const size_t bytes_written = has_suffix(output_filename, ".bin") ? write_hops_binary(output_path, hops, interner, unreached_hops) : write_hops_text(output_path, hops, interner, unreached_hops);
+            // The graph and its distances are the starting point of the next update; after a
+            // full run the graph may have come from graph.snapshot and is copied over
+            if (!incremental || !new_chunk_files.empty())
+            {
+                write_graph_snapshot(snapshot_filename, csr_graph, interner, chunks);
+            }
+            write_distance_state(state_filename, DistanceState{max_hops, chunks, hops});
+            phase.set_counter("bytes_written", bytes_written);
+        }
+
+        int status = 0;
+        if (verify)
+        {
+            PhaseTimer phase("verify");
+            AddressInterner full_interner(13000000);
+            CSRGraph full_graph, full_reverse;
+            build_graph_from_chunks(chunk_files, full_graph, full_reverse, full_interner);
+            std::vector<uint8_t> full_hops;
+            bfs_direction_optimizing(full_graph, full_reverse, read_kyc_addr(kyc_address_filename, full_interner), max_hops, full_hops);
+            // Compared by address, the new chunks may have numbered their addresses differently
+            size_t mismatches = full_interner.size() == interner.size() ? 0 : 1;
+            for (VertexId id = 0; id < full_interner.size(); ++id)
+            {
+                VertexId updated_id;
+                if (!interner.find(full_interner.address(id), updated_id) || hops[updated_id] != full_hops[id])
+                {
+                    ++mismatches;
+                }
+            }
+            phase.set_counter("mismatches", mismatches);
+            if (mismatches > 0)
+            {
+                cerr << "Error: " << mismatches << " distances differ from a full recompute" << endl;
+                status = 1;
+            }
+            else
+            {
+                std::cout << "All " << full_interner.size() << " distances match a full recompute" << std::endl;
+            }
+        }
+
+        write_metrics_report(output_path + ".metrics.json");
+        return status; });
+}
+
+int calculates_seed_delta(const std::string kyc_filename, const std::string added_filename, const std::string removed_filename, const std::string output_filename)
+{
+    return run_pipeline("calculates_seed_delta", [&](const std::string &home_directory)
+                        {
+        AddressInterner interner(13000000);
+        CSRGraph csr_graph, reverse_graph;
+        if (!load_transfer_graph(home_directory, csr_graph, reverse_graph, interner))
+        {
+            return 1;
+        }
+        const std::vector<VertexId> kyc_nodes = load_kyc_seeds(data_directory(home_directory) + kyc_filename, interner);
+        // Addresses missing from the graph cannot change any distance and are dropped by the lookup
+        const std::vector<VertexId> added = load_kyc_seeds(added_filename, interner);
+        const std::vector<VertexId> removed = load_kyc_seeds(removed_filename, interner);
+
+        const int max_hops = 5;
+        std::vector<uint8_t> hops;
+        double baseline_seconds;
+        {
+            PhaseTimer phase("bfs");
+            auto start = chrono::high_resolution_clock::now();
+            record_bfs_levels("kyc", bfs_direction_optimizing(csr_graph, reverse_graph, kyc_nodes, max_hops, hops));
+            baseline_seconds = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+        }
+        std::vector<HopChange> changes;
+        {
+            PhaseTimer phase("seed_delta");
+            auto start = chrono::high_resolution_clock::now();
+            changes = apply_seed_delta(csr_graph, reverse_graph, added, removed, max_hops, hops);
+            chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+            phase.set_counter("added", added.size());
+            phase.set_counter("removed", removed.size());
+            phase.set_counter("changed", changes.size());
+            std::cout << "Seed delta changed " << changes.size() << " distances in " << elapsed.count() << " seconds ("
+                      << elapsed.count() / baseline_seconds << "x a full BFS)" << std::endl;
+        }
+
+        string output_path = output_directory(home_directory) + output_filename;
+        PhaseTimer output_phase("output");
+        output_phase.set_counter("bytes_written", write_hop_changes_text(output_path, changes, interner, static_cast<uint8_t>(max_hops + 1)));
+        output_phase.stop();
+
+        write_metrics_report(output_path + ".metrics.json");
+        return 0; });
+}
+
+int calculates_hacker_risk(const std::string hackers_filename, const std::string output_filename, double tolerance, int max_iterations)
+{
+    return run_pipeline("calculates_hacker_risk", [&](const std::string &home_directory)
+                        {
+        AddressInterner interner(13000000);
+        CSRGraph csr_graph, reverse_graph;
+        if (!load_transfer_graph(home_directory, csr_graph, reverse_graph, interner))
+        {
+            return 1;
+        }
+        if (csr_graph.weights.empty())
+        {
+            cout << "Warning: the graph has no transfer values, every transfer counts the same" << endl;
+        }
+        const std::vector<VertexId> hackers = load_kyc_seeds(hackers_filename, interner);
+        if (hackers.empty())
+        {
+            cerr << "Error: None of the addresses in " << hackers_filename << " are in the graph" << endl;
+            return 1;
+        }
+
+        std::vector<double> scores;
+        {
+            PhaseTimer phase("pagerank");
+            auto start = chrono::high_resolution_clock::now();
+            std::vector<PageRankIterationStats> iterations = personalized_pagerank(csr_graph, reverse_graph, hackers, scores, 0.85, tolerance, max_iterations);
+            chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+            const double residual = iterations.empty() ? 0.0 : iterations.back().residual;
+            phase.set_counter("iterations", iterations.size());
+            phase.set_counter("residual", residual);
+            cout << "Risk propagation took " << iterations.size() << " iterations in " << elapsed.count() << " seconds, residual " << residual << endl;
+            if (residual >= tolerance)
+            {
+                cout << "Warning: not converged to " << tolerance << " after " << max_iterations << " iterations" << endl;
+            }
+        }
+
+        const std::string output_path = output_directory(home_directory) + output_filename;
+        PhaseTimer output_phase("output");
+        output_phase.set_counter("bytes_written", write_scores_text(output_path, scores, interner));
+        output_phase.stop();
+        write_metrics_report(output_path + ".metrics.json");
+        return 0; });
+}
+
+int calculates_reach_sketches(const std::string output_filename, int precision, uint64_t memory_mb)
+{
+    return run_pipeline("calculates_reach_sketches", [&](const std::string &home_directory)
+                        {
+        AddressInterner interner(13000000);
+        CSRGraph csr_graph, reverse_graph;
+        if (!load_transfer_graph(home_directory, csr_graph, reverse_graph, interner))
+        {
+            return 1;
+        }
+        const size_t n = num_vertices(csr_graph);
+        if (memory_mb > 0)
+        {
+            precision = sketch_precision_for_memory(n, memory_mb << 20, precision);
+        }
+        cout << "Sketching with 2^" << precision << " registers per address (" << sketch_memory_bytes(n, precision) / (1024.0 * 1024.0) << " MB)" << endl;
+
+        /*--------------------------------------------
+        Reach along the transfers, then against them
+        --------------------------------------------*/
+        const int max_hops = 5;
+        std::vector<float> reach, reached_from;
+        const std::pair<const char *, const CSRGraph *> directions[] = {{"reach", &csr_graph}, {"reached_from", &reverse_graph}};
+        for (const auto &direction : directions)
+        {
+            PhaseTimer phase(std::string("sketch_") + direction.first);
+            std::vector<SketchIterationStats> iterations = neighborhood_sizes(*direction.second, max_hops, precision, direction.second == &csr_graph ? reach : reached_from);
+            phase.set_counter("precision", precision);
+            for (const SketchIterationStats &iteration : iterations)
+            {
+                phase.set_counter("changed_" + std::to_string(iteration.hops), iteration.changed);
+                cout << direction.first << " within " << iteration.hops << " hops: " << iteration.changed << " counters grew in " << iteration.seconds << " seconds" << endl;
+            }
+        }
+
+        // One row per address: the reach columns, then the reached-from columns
+        std::string header = "address";
+        for (const char *prefix : {"reach_", "reached_from_"})
+        {
+            for (int k = 1; k <= max_hops; ++k)
+            {
+                header += "," + std::string(prefix) + std::to_string(k);
+            }
+        }
+        std::vector<float> columns(n * 2 * max_hops);
+#pragma omp parallel for schedule(static)
+        for (size_t v = 0; v < n; ++v)
+        {
+            std::copy_n(&reach[v * max_hops], max_hops, &columns[v * 2 * max_hops]);
+            std::copy_n(&reached_from[v * max_hops], max_hops, &columns[v * 2 * max_hops + max_hops]);
+        }
+
+        const std::string output_path = output_directory(home_directory) + output_filename;
+        PhaseTimer output_phase("output");
+        output_phase.set_counter("bytes_written", write_reach_text(output_path, columns, 2 * max_hops, header, interner));
+        output_phase.stop();
+        write_metrics_report(output_path + ".metrics.json");
+        return 0; });
+}
+
+int calculates_windowed_dist(const std::string kyc_filename, const std::vector<std::string> &cutoff_dates, const std::string output_filename)
+{
+    return run_pipeline("calculates_windowed_dist", [&](const std::string &home_directory)
+                        {
+        std::vector<uint32_t> cutoffs;
+        for (const std::string &date : cutoff_dates)
+        {
+            uint32_t days;
+            if (!parse_date(date.data(), date.data() + date.size(), days))
+            {
+                cerr << "Error: " << date << " is not a YYYY-MM-DD date after 1970-01-01" << endl;
+                return 1;
+            }
+            cutoffs.push_back(days);
+        }
+        // One column per distinct date, earliest first
+        std::sort(cutoffs.begin(), cutoffs.end());
+        cutoffs.erase(std::unique(cutoffs.begin(), cutoffs.end()), cutoffs.end());
+
+        std::string base_filename = data_directory(home_directory) + "uni_transfer_history_";
+        std::vector<std::string> chunk_files = find_chunk_files(base_filename);
+        if (chunk_files.empty())
+        {
+            cerr << "Error: No transfer history chunks found for " << base_filename << endl;
+            return 1;
+        }
+        AddressInterner interner(13000000);
+        CSRGraph csr_graph;
+        std::vector<uint32_t> first_seen;
+        {
+            // The snapshot holds no dates, so the date-ordered graph comes from the chunks
+            PhaseTimer phase("ingest");
+            for (const std::string &chunk_filename : chunk_files)
+            {
+                phase.add_bytes_read(file_size(chunk_filename));
+            }
+            build_graph_from_chunks(chunk_files, csr_graph, first_seen, interner);
+            const size_t undated = std::count(first_seen.begin(), first_seen.end(), UNDATED);
+            phase.set_counter("vertices", num_vertices(csr_graph));
+            phase.set_counter("edges", num_edges(csr_graph));
+            phase.set_counter("undated_edges", undated);
+            if (undated > 0)
+            {
+                cout << "Warning: " << undated << " transfers have no first_seen date and count at every cutoff" << endl;
+            }
+        }
+        const std::vector<VertexId> kyc_nodes = load_kyc_seeds(data_directory(home_directory) + kyc_filename, interner);
+
+        const int max_hops = 5;
+        std::vector<uint8_t> hops;
+        {
+            PhaseTimer phase("bfs");
+            auto start = chrono::high_resolution_clock::now();
+            std::vector<std::vector<BFSLevelStats>> levels = bfs_by_cutoff_dates(csr_graph, first_seen, kyc_nodes, cutoffs, max_hops, hops);
+            for (size_t c = 0; c < cutoffs.size(); ++c)
+            {
+                record_bfs_levels(format_date(cutoffs[c]), levels[c]);
+            }
+            chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+            phase.set_counter("cutoffs", cutoffs.size());
+            cout << "Distances at " << cutoffs.size() << " cutoff dates in " << elapsed.count() << " seconds" << endl;
+        }
+
+        std::string header = "address";
+        for (const uint32_t cutoff : cutoffs)
+        {
+            header += "," + format_date(cutoff);
+        }
+        const std::string output_path = output_directory(home_directory) + output_filename;
+        PhaseTimer output_phase("output");
+        output_phase.set_counter("bytes_written", write_hop_columns_text(output_path, hops, cutoffs.size(), header, interner, static_cast<uint8_t>(max_hops + 1)));
+        output_phase.stop();
+        write_metrics_report(output_path + ".metrics.json");
+        return 0; });
+}
+
+int compile_edge_partitions(uint64_t partition_mb)
+{
+    return run_pipeline("compile_edge_partitions", [&](const std::string &home_directory)
+                        {
+        auto start = chrono::high_resolution_clock::now();
+        std::string base_filename = data_directory(home_directory) + "uni_transfer_history_";
+        std::vector<std::string> chunk_files = find_chunk_files(base_filename);
+        if (chunk_files.empty())
+        {
+            cerr << "Error: No transfer history chunks found for " << base_filename << endl;
+            return 1;
+        }
+
+        AddressInterner interner(13000000);
+        CSRGraph csr_graph;
+        {
+            // The partitioning itself needs the graph in memory once, from the snapshot if it is current
+            PhaseTimer phase("ingest");
+            phase.set_counter("from_snapshot", load_or_build_graph(chunk_files, base_filename + "graph.snapshot", csr_graph, interner));
+            phase.set_counter("vertices", num_vertices(csr_graph));
+            phase.set_counter("edges", num_edges(csr_graph));
+        }
+        const std::string partitions_filename = base_filename + "graph.partitions";
+        {
+            PhaseTimer phase("output");
+            write_edge_partitions(partitions_filename, csr_graph, interner, fingerprint_chunks(chunk_files), partition_mb << 20);
+            phase.set_counter("bytes_written", file_size(partitions_filename));
+        }
+        write_metrics_report(partitions_filename + ".metrics.json");
+
+        chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+        std::cout << "Wrote edge partitions " << partitions_filename << " in " << elapsed.count() << " seconds" << std::endl;
+        return 0; });
+}
+
+int calculates_eai_dist_external(const std::string kyc_filename, uint64_t budget_mb, const std::string output_filename)
+{
+    return run_pipeline("calculates_eai_dist_external", [&](const std::string &home_directory)
+                        {
+        std::string base_filename = data_directory(home_directory) + "uni_transfer_history_";
+        const std::string partitions_filename = base_filename + "graph.partitions";
+        AddressInterner interner;
+        PartitionedGraph graph;
+        {
+            PhaseTimer phase("ingest");
+            // The partitions carry the chunk list they were cut from, like the snapshot
+            if (!graph.open(partitions_filename, fingerprint_chunks(find_chunk_files(base_filename)), budget_mb << 20, interner))
+            {
+                cerr << "Error: Run \"uni_graph partition <MB>\" to write current edge partitions first" << endl;
+                return 1;
+            }
+            phase.add_bytes_read(graph.bytes_read());
+            phase.set_counter("vertices", graph.num_vertices());
+            phase.set_counter("edges", graph.num_edges());
+            phase.set_counter("partitions", graph.partitions().size());
+            phase.set_counter("resident_partitions", graph.num_resident());
+            phase.set_counter("interner_bytes", interner.memory_bytes());
+        }
+        std::cout << "Graph has " << graph.num_vertices() << " vertices and " << graph.num_edges() << " edges in " << graph.partitions().size()
+                  << " partitions, " << graph.num_resident() << " kept in memory" << std::endl;
+
+        std::vector<VertexId> kyc_nodes = load_kyc_seeds(data_directory(home_directory) + kyc_filename, interner);
+
+        std::cout << "Start BFS" << std::endl;
+        int max_hops = 5;
+        std::vector<uint8_t> hops;
+        {
+            PhaseTimer phase("bfs");
+            const uint64_t bytes_before = graph.bytes_read();
+            record_bfs_levels("kyc", bfs_semi_external(graph, kyc_nodes, max_hops, hops));
+            phase.add_bytes_read(graph.bytes_read() - bytes_before);
+        }
+
+        // Same output as calculates_eai_dist
+        string output_path = output_directory(home_directory) + output_filename;
+        const uint8_t unreached_hops = static_cast<uint8_t>(max_hops + 1);
+        PhaseTimer output_phase("output");
+        const size_t bytes_written = has_suffix(output_filename, ".bin") ? write_hops_binary(output_path, hops, interner, unreached_hops) : write_hops_text(output_path, hops, interner, unreached_hops);
+        output_phase.set_counter("bytes_written", bytes_written);
+        output_phase.stop();
+
+        write_metrics_report(output_path + ".metrics.json");
+        return 0; });
+}
+
+int calculates_group_dist(const std::vector<std::string> &seed_filenames, const std::string output_filename)
+{
+    return run_pipeline("calculates_group_dist", [&](const std::string &home_directory)
+                        {
+        AddressInterner interner(13000000);
+        CSRGraph csr_graph, reverse_graph;
+        if (!load_transfer_graph(home_directory, csr_graph, reverse_graph, interner))
+        {
+            return 1;
+        }
+
+        /*--------------------------------------------
+        Read the labelled seed groups
+        --------------------------------------------*/
+        std::vector<SeedGroup> groups;
+        for (const std::string &seed_filename : seed_filenames)
+        {
+            // Unlabelled rows are named after their file, e.g. "known_hackers"
+            std::string label = seed_filename.substr(seed_filename.find_last_of('/') + 1);
+            label = label.substr(0, label.find('.'));
+            read_seed_groups(seed_filename, interner, label, groups);
+        }
+        std::string header = "address";
+        for (const SeedGroup &group : groups)
+        {
+            std::cout << "Seed group " << group.label << ": " << group.seeds.size() << " addresses in the graph" << std::endl;
+            header += "," + group.label;
+        }
+
+        /*--------------------------------------------
+        One traversal for every group
+        --------------------------------------------*/
+        int max_hops = 5;
+        auto start_bfs = chrono::high_resolution_clock::now();
+        std::vector<uint8_t> hops;
+        {
+            PhaseTimer phase("bfs");
+            record_bfs_levels("groups", multi_source_bfs(csr_graph, reverse_graph, groups, max_hops, hops));
+            phase.set_counter("groups", groups.size());
+        }
+        chrono::duration<double> elapsed_bfs = chrono::high_resolution_clock::now() - start_bfs;
+        cout << "Iteration time for " << groups.size() << " groups: " << elapsed_bfs.count() << " seconds" << endl;
+
+        const std::string output_path = output_directory(home_directory) + output_filename;
+        PhaseTimer output_phase("output");
+        output_phase.set_counter("bytes_written", write_hop_columns_text(output_path, hops, groups.size(), header, interner, static_cast<uint8_t>(max_hops + 1)));
+        output_phase.stop();
+        write_metrics_report(output_path + ".metrics.json");
+        return 0; });
+}
+
+int calculates_threshold_dist(const std::string kyc_filename, const std::vector<float> &thresholds, const std::string output_filename)
+{
+    return run_pipeline("calculates_threshold_dist", [&](const std::string &home_directory)
+                        {
+        AddressInterner interner(13000000);
+        CSRGraph csr_graph, reverse_graph;
+        if (!load_transfer_graph(home_directory, csr_graph, reverse_graph, interner))
+        {
+            return 1;
+        }
+        std::vector<VertexId> kyc_nodes = load_kyc_seeds(data_directory(home_directory) + kyc_filename, interner);
+
+        /*--------------------------------------------
+        One BFS per dust threshold over the same graph
+        --------------------------------------------*/
+        int max_hops = 5;
+        auto start_bfs = chrono::high_resolution_clock::now();
+        PhaseTimer bfs_phase("bfs");
+        std::vector<uint8_t> hops = bfs_weight_thresholds(csr_graph, reverse_graph, kyc_nodes, thresholds, max_hops);
+        bfs_phase.set_counter("thresholds", thresholds.size());
+        bfs_phase.stop();
+        chrono::duration<double> elapsed_bfs = chrono::high_resolution_clock::now() - start_bfs;
+        cout << "Iteration time for " << thresholds.size() << " thresholds: " << elapsed_bfs.count() << " seconds" << endl;
+
+        std::ostringstream header;
+        header << "address";
+        for (const float threshold : thresholds)
+        {
+            header << ",usd_" << threshold;
+        }
+        const std::string output_path = output_directory(home_directory) + output_filename;
+        PhaseTimer output_phase("output");
+        output_phase.set_counter("bytes_written", write_hop_columns_text(output_path, hops, thresholds.size(), header.str(), interner, static_cast<uint8_t>(max_hops + 1)));
+        output_phase.stop();
+        write_metrics_report(output_path + ".metrics.json");
+        return 0; });
+}
+
+int calculates_bidirectional_dist(const std::string kyc_filename, const std::string output_filename)
+{
+    return run_pipeline("calculates_bidirectional_dist", [&](const std::string &home_directory)
+                        {
+        AddressInterner interner(13000000);
+        CSRGraph csr_graph, reverse_graph;
+        if (!load_transfer_graph(home_directory, csr_graph, reverse_graph, interner))
+        {
+            return 1;
+        }
+        std::vector<VertexId> kyc_nodes = load_kyc_seeds(data_directory(home_directory) + kyc_filename, interner);
+
+        /*--------------------------------------------
+        Distances from and to the KYC addresses
+        --------------------------------------------*/
+        int max_hops = 5;
+        auto start_bfs = chrono::high_resolution_clock::now();
+        PhaseTimer bfs_phase("bfs");
+        std::vector<uint8_t> hops = bfs_forward_backward(csr_graph, reverse_graph, kyc_nodes, max_hops);
+        bfs_phase.stop();
+        chrono::duration<double> elapsed_bfs = chrono::high_resolution_clock::now() - start_bfs;
+        cout << "Iteration time for both directions: " << elapsed_bfs.count() << " seconds" << endl;
+
+        const std::string output_path = output_directory(home_directory) + output_filename;
+        PhaseTimer output_phase("output");
+        output_phase.set_counter("bytes_written", write_hop_columns_text(output_path, hops, 2, "address,hops_from_kyc,hops_to_kyc", interner, static_cast<uint8_t>(max_hops + 1)));
+        output_phase.stop();
+        write_metrics_report(output_path + ".metrics.json");
+        return 0; });
+}
+
+int calculates_eai_paths(const std::string kyc_filename, const std::string addresses_filename, const std::string output_filename)
+{
+    return run_pipeline("calculates_eai_paths", [&](const std::string &home_directory)
+                        {
+        AddressInterner interner(13000000);
+        CSRGraph csr_graph, reverse_graph;
+        if (!load_transfer_graph(home_directory, csr_graph, reverse_graph, interner))
+        {
+            return 1;
+        }
+        std::vector<VertexId> kyc_nodes = load_kyc_seeds(data_directory(home_directory) + kyc_filename, interner);
+
+        /*--------------------------------------------
+        BFS recording one predecessor per address
+        --------------------------------------------*/
+        int max_hops = 5;
+        auto start_bfs = chrono::high_resolution_clock::now();
+        std::vector<uint8_t> hops;
+        std::vector<VertexId> parents;
+        {
+            PhaseTimer phase("bfs");
+            record_bfs_levels("kyc", bfs_with_predecessors(csr_graph, reverse_graph, kyc_nodes, max_hops, hops, parents));
+            phase.set_counter("predecessor_bytes", parents.capacity() * sizeof(VertexId));
+        }
+        chrono::duration<double> elapsed_bfs = chrono::high_resolution_clock::now() - start_bfs;
+        cout << "Iteration time: " << elapsed_bfs.count() << " seconds" << endl;
+        std::cout << "Predecessor array memory: " << parents.capacity() * sizeof(VertexId) / (1024.0 * 1024.0) << " MB" << std::endl;
+
+        /*--------------------------------------------
+        Trace the requested addresses back to their seeds
+        --------------------------------------------*/
+        // Same layout as the KYC files: a header line, then one address per line
+        std::vector<VertexId> targets = read_kyc_addr(addresses_filename, interner);
+        std::cout << targets.size() << " requested addresses are in the graph" << std::endl;
+        auto start_paths = chrono::high_resolution_clock::now();
+        const std::string output_path = output_directory(home_directory) + output_filename;
+        PhaseTimer output_phase("output");
+        output_phase.set_counter("targets", targets.size());
+        output_phase.set_counter("bytes_written", write_paths_text(output_path, targets, hops, parents, interner, static_cast<uint8_t>(max_hops + 1)));
+        output_phase.stop();
+        chrono::duration<double> elapsed_paths = chrono::high_resolution_clock::now() - start_paths;
+        cout << "Path extraction time for " << targets.size() << " addresses: " << elapsed_paths.count() << " seconds" << endl;
+        write_metrics_report(output_path + ".metrics.json");
+        return 0; });
+}
+
+int serve_queries(const std::string kyc_filename, const std::string endpoint)
+{
+    return run_pipeline("serve_queries", [&](const std::string &home_directory)
+                        {
+        AddressInterner interner(13000000);
+        CSRGraph csr_graph, reverse_graph;
+        if (!load_transfer_graph(home_directory, csr_graph, reverse_graph, interner))
+        {
+            return 1;
+        }
+        std::vector<VertexId> kyc_nodes = load_kyc_seeds(data_directory(home_directory) + kyc_filename, interner);
+
+        // The KYC distances and predecessors are computed once, every query after that is a lookup
+        PhaseTimer bfs_phase("bfs");
+        QueryEngine engine(csr_graph, reverse_graph, interner, kyc_nodes, 5);
+        bfs_phase.stop();
+        // Startup phases only; the report is written before the server starts accepting queries
+        write_metrics_report(output_directory(home_directory) + "query_server.metrics.json");
+        QueryServer server(engine);
+        if (!server.listen(endpoint))
+        {
+            return 1;
+        }
+        running_server = &server;
+        std::signal(SIGINT, stop_running_server);
+        std::signal(SIGTERM, stop_running_server);
+        server.serve();
+        running_server = nullptr;
+        std::cout << "Query server stopped" << std::endl;
+        return 0; });
 }
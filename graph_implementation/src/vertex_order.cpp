@@ -0,0 +1,260 @@
+#include "vertex_order.hpp"
+#include <numeric>
+
+using namespace std;
+
+namespace
+{
+    // In plus out degree of every vertex
+    std::vector<uint64_t> total_degrees(const CSRGraph &graph, const CSRGraph &reverse_graph)
+    {
+        const size_t n = num_vertices(graph);
+        std::vector<uint64_t> degrees(n);
+#pragma omp parallel for schedule(static)
+        for (size_t v = 0; v < n; ++v)
+        {
+            degrees[v] = out_degree(static_cast<VertexId>(v), graph) + out_degree(static_cast<VertexId>(v), reverse_graph);
+        }
+        return degrees;
+    }
+
+    // Vertices by descending degree, ties by ascending id. A counting sort: one pass over the
+    // vertices plus one over the degree range.
+    std::vector<VertexId> by_descending_degree(const std::vector<uint64_t> &degrees)
+    {
+        const uint64_t max_degree = degrees.empty() ? 0 : *std::max_element(degrees.begin(), degrees.end());
+        // Start of every degree's bucket, highest degree first
+        std::vector<uint64_t> bucket(max_degree + 2, 0);
+        for (const uint64_t degree : degrees)
+        {
+            ++bucket[max_degree - degree + 1];
+        }
+        for (size_t b = 1; b < bucket.size(); ++b)
+        {
+            bucket[b] += bucket[b - 1];
+        }
+        std::vector<VertexId> order(degrees.size());
+        for (size_t v = 0; v < degrees.size(); ++v)
+        {
+            order[bucket[max_degree - degrees[v]]++] = static_cast<VertexId>(v);
+        }
+        return order;
+    }
+
+    // Calls visit(w) for every in- and out-neighbor of v
+    template <typename Visit>
+    void for_each_undirected_neighbor(VertexId v, const CSRGraph &graph, const CSRGraph &reverse_graph, Visit visit)
+    {
+        for (uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e)
+        {
+            visit(graph.neighbors[e]);
+        }
+        for (uint64_t e = reverse_graph.offsets[v]; e < reverse_graph.offsets[v + 1]; ++e)
+        {
+            visit(reverse_graph.neighbors[e]);
+        }
+    }
+
+    // Undirected BFS discovery order: from the seeds first, then from every vertex left unvisited in id order
+    std::vector<VertexId> bfs_order(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &seeds)
+    {
+        const size_t n = num_vertices(graph);
+        std::vector<uint8_t> visited(n, 0);
+        // The order doubles as the BFS queue
+        std::vector<VertexId> order;
+        order.reserve(n);
+        size_t head = 0;
+        auto expand = [&]()
+        {
+            while (head < order.size())
+            {
+                for_each_undirected_neighbor(order[head++], graph, reverse_graph, [&](VertexId w)
+                                             {
+                    if (!visited[w])
+                    {
+                        visited[w] = 1;
+                        order.push_back(w);
+                    } });
+            }
+        };
+        for (const VertexId seed : seeds)
+        {
+            if (seed < n && !visited[seed])
+            {
+                visited[seed] = 1;
+                order.push_back(seed);
+            }
+        }
+        expand();
+        for (size_t v = 0; v < n; ++v)
+        {
+            if (!visited[v])
+            {
+                visited[v] = 1;
+                order.push_back(static_cast<VertexId>(v));
+                expand();
+            }
+        }
+        return order;
+    }
+
+    /*
+    Reverse Cuthill-McKee: every component is traversed breadth-first from its lowest-degree
+    vertex, appending the unvisited neighbors of each vertex by ascending degree; the final order
+    is reversed.
+    */
+    std::vector<VertexId> rcm_order(const CSRGraph &graph, const CSRGraph &reverse_graph)
+    {
+        const size_t n = num_vertices(graph);
+        const std::vector<uint64_t> degrees = total_degrees(graph, reverse_graph);
+        std::vector<VertexId> starts = by_descending_degree(degrees);
+        std::reverse(starts.begin(), starts.end());
+        std::vector<uint8_t> visited(n, 0);
+        std::vector<VertexId> order;
+        order.reserve(n);
+        std::vector<VertexId> fresh;
+        for (const VertexId start : starts)
+        {
+            if (visited[start])
+            {
+                continue;
+            }
+            visited[start] = 1;
+            order.push_back(start);
+            for (size_t head = order.size() - 1; head < order.size(); ++head)
+            {
+                fresh.clear();
+                for_each_undirected_neighbor(order[head], graph, reverse_graph, [&](VertexId w)
+                                             {
+                    if (!visited[w])
+                    {
+                        visited[w] = 1;
+                        fresh.push_back(w);
+                    } });
+                std::sort(fresh.begin(), fresh.end(), [&degrees](VertexId a, VertexId b)
+                          { return degrees[a] != degrees[b] ? degrees[a] < degrees[b] : a < b; });
+                order.insert(order.end(), fresh.begin(), fresh.end());
+            }
+        }
+        std::reverse(order.begin(), order.end());
+        return order;
+    }
+}
+
+bool parse_vertex_ordering(const std::string &name, VertexOrdering &ordering)
+{
+    for (const VertexOrdering candidate : {VertexOrdering::Original, VertexOrdering::Degree, VertexOrdering::BFS, VertexOrdering::RCM})
+    {
+        if (name == vertex_ordering_name(candidate))
+        {
+            ordering = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *vertex_ordering_name(VertexOrdering ordering)
+{
+    switch (ordering)
+    {
+    case VertexOrdering::Degree:
+        return "degree";
+    case VertexOrdering::BFS:
+        return "bfs";
+    case VertexOrdering::RCM:
+        return "rcm";
+    default:
+        return "original";
+    }
+}
+
+std::vector<VertexId> compute_vertex_order(const CSRGraph &graph, const CSRGraph &reverse_graph, const std::vector<VertexId> &seeds, VertexOrdering ordering)
+{
+    const size_t n = num_vertices(graph);
+    std::vector<VertexId> order;
+    switch (ordering)
+    {
+    case VertexOrdering::Degree:
+        order = by_descending_degree(total_degrees(graph, reverse_graph));
+        break;
+    case VertexOrdering::BFS:
+        order = bfs_order(graph, reverse_graph, seeds);
+        break;
+    case VertexOrdering::RCM:
+        order = rcm_order(graph, reverse_graph);
+        break;
+    default:
+        order.resize(n);
+        std::iota(order.begin(), order.end(), VertexId(0));
+        break;
+    }
+
+    // order lists old ids by new id; invert it
+    std::vector<VertexId> new_id(n);
+#pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < n; ++i)
+    {
+        new_id[order[i]] = static_cast<VertexId>(i);
+    }
+    return new_id;
+}
+
+CSRGraph relabel_csr_graph(const CSRGraph &graph, const std::vector<VertexId> &new_id)
+{
+    const size_t n = num_vertices(graph);
+    const bool weighted = !graph.weights.empty();
+    std::vector<VertexId> old_id(n);
+#pragma omp parallel for schedule(static)
+    for (size_t v = 0; v < n; ++v)
+    {
+        old_id[new_id[v]] = static_cast<VertexId>(v);
+    }
+
+    CSRGraph relabeled;
+    relabeled.offsets.assign(n + 1, 0);
+    for (size_t i = 0; i < n; ++i)
+    {
+        relabeled.offsets[i + 1] = relabeled.offsets[i] + out_degree(old_id[i], graph);
+    }
+    relabeled.neighbors.resize(graph.neighbors.size());
+    relabeled.weights.resize(graph.weights.size());
+#pragma omp parallel for schedule(dynamic, 4096)
+    for (size_t i = 0; i < n; ++i)
+    {
+        const VertexId v = old_id[i];
+        uint64_t pos = relabeled.offsets[i];
+        for (uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e, ++pos)
+        {
+            relabeled.neighbors[pos] = new_id[graph.neighbors[e]];
+            if (weighted)
+            {
+                relabeled.weights[pos] = graph.weights[e];
+            }
+        }
+        if (!weighted)
+        {
+            std::sort(relabeled.neighbors.begin() + relabeled.offsets[i], relabeled.neighbors.begin() + relabeled.offsets[i + 1]);
+        }
+    }
+    // Equal weights are ordered by neighbor id, which just changed
+    if (weighted)
+    {
+        sort_by_descending_weight(relabeled);
+    }
+    return relabeled;
+}
+
+std::vector<VertexId> relabel_vertices(const std::vector<VertexId> &vertices, const std::vector<VertexId> &new_id)
+{
+    std::vector<VertexId> relabeled;
+    relabeled.reserve(vertices.size());
+    for (const VertexId v : vertices)
+    {
+        if (v < new_id.size())
+        {
+            relabeled.push_back(new_id[v]);
+        }
+    }
+    return relabeled;
+}
@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+#include "address_interner.hpp"
+
+class AddressInternerTest : public ::testing::Test {
+protected:
+    Graph graph;
+    AddressInterner interner;
+    std::unordered_map<std::string, Vertex> address_to_vertex;
+    const char *home_dir;
+    std::string home_directory;
+    std::string test_data;
+
+    void SetUp() override {
+        // Initialize home_directory.
+        home_dir = getenv("HOME");
+        home_directory = std::string(home_dir);
+        test_data = home_directory + "/econ_project/src/proj23_03_tracebility/cpp/uni_directional_implementation/test_data/";
+
+        build_graph_from_chunks(test_data + "test_build_graph3_", 1, graph, interner);
+    }
+
+    // Deterministic, well-formed address for index i
+    static std::string make_address(uint32_t i) {
+        std::ostringstream stream;
+        stream << "0x" << std::hex << std::setw(8) << std::setfill('0') << i * 2654435761u << std::setw(32) << i;
+        return stream.str();
+    }
+};
+
+TEST_F(AddressInternerTest, ParseAndFormat) {
+    const std::string address = "0x64a2d48e878e344f948fc76c25368fb9c648a5cc";
+    AddressKey key;
+    ASSERT_TRUE(parse_address_key(address.data(), address.size(), key));
+    EXPECT_EQ(key.bytes[0], 0x64);
+    EXPECT_EQ(key.bytes[19], 0xcc);
+    EXPECT_EQ(format_address_key(key), address);
+
+    // Wrong length, missing prefix, upper case and non-hex text are rejected
+    EXPECT_FALSE(parse_address_key("0x64a2", 6, key));
+    std::string no_prefix = "1x64a2d48e878e344f948fc76c25368fb9c648a5cc";
+    EXPECT_FALSE(parse_address_key(no_prefix.data(), no_prefix.size(), key));
+    std::string upper = "0x64A2d48e878e344f948fc76c25368fb9c648a5cc";
+    EXPECT_FALSE(parse_address_key(upper.data(), upper.size(), key));
+    std::string non_hex = "0x64g2d48e878e344f948fc76c25368fb9c648a5cc";
+    EXPECT_FALSE(parse_address_key(non_hex.data(), non_hex.size(), key));
+}
+
+TEST_F(AddressInternerTest, DenseIdsAndRoundTrip) {
+    AddressInterner table;
+    const uint32_t count = 100000;
+    for (uint32_t i = 0; i < count; ++i) {
+        ASSERT_EQ(table.intern(make_address(i)), i);
+    }
+    // Interning again returns the existing id
+    EXPECT_EQ(table.intern(make_address(12345)), 12345u);
+    EXPECT_EQ(table.size(), count);
+    for (uint32_t i = 0; i < count; i += 997) {
+        VertexId id;
+        ASSERT_TRUE(table.find(make_address(i), id));
+        EXPECT_EQ(id, i);
+        EXPECT_EQ(table.address(i), make_address(i));
+        EXPECT_TRUE(table.has_key(i));
+    }
+    VertexId id;
+    EXPECT_FALSE(table.find(make_address(count + 1), id));
+}
+
+TEST_F(AddressInternerTest, FallbackAddresses) {
+    AddressInterner table;
+    EXPECT_EQ(table.intern("0x64a2d48e878e344f948fc76c25368fb9c648a5cc"), 0u);
+    EXPECT_EQ(table.intern("address1"), 1u);
+    EXPECT_EQ(table.intern("0x64A2D48E878E344F948FC76C25368FB9C648A5CC"), 2u);
+    EXPECT_EQ(table.intern("address1"), 1u);
+    EXPECT_EQ(table.address(1), "address1");
+    EXPECT_EQ(table.address(2), "0x64A2D48E878E344F948FC76C25368FB9C648A5CC");
+    EXPECT_TRUE(table.has_key(0));
+    EXPECT_FALSE(table.has_key(1));
+    VertexId id;
+    EXPECT_FALSE(table.find("address2", id));
+}
+
+TEST_F(AddressInternerTest, BuildGraphMatchesMapVersion) {
+    Graph map_graph;
+    build_graph_from_chunks(test_data + "test_build_graph3_", 1, map_graph, address_to_vertex);
+    ASSERT_EQ(interner.size(), 18);
+    ASSERT_EQ(num_vertices(graph), 18);
+    ASSERT_EQ(num_edges(graph), num_edges(map_graph));
+    for (const auto &entry : address_to_vertex) {
+        VertexId id;
+        ASSERT_TRUE(interner.find(entry.first, id));
+        EXPECT_EQ(id, entry.second);
+    }
+}
+
+TEST_F(AddressInternerTest, ReadKYC) {
+    std::vector<VertexId> kyc_nodes = read_kyc_addr(test_data + "test_kyc.csv", interner);
+    ASSERT_EQ(kyc_nodes.size(), 3);
+    VertexId id;
+    ASSERT_TRUE(interner.find("address5", id));
+    EXPECT_TRUE(std::find(kyc_nodes.begin(), kyc_nodes.end(), id) != kyc_nodes.end());
+    ASSERT_TRUE(interner.find("address1", id));
+    EXPECT_TRUE(std::find(kyc_nodes.begin(), kyc_nodes.end(), id) == kyc_nodes.end());
+}
@@ -0,0 +1,301 @@
+#include "gtest/gtest.h"
+#include "chunk_loader.hpp"
+
+class ChunkLoaderTest : public ::testing::Test {
+protected:
+    const char *home_dir;
+    std::string home_directory;
+    std::string test_data;
+
+    void SetUp() override {
+        // Initialize home_directory.
+        home_dir = getenv("HOME");
+        home_directory = std::string(home_dir);
+        test_data = home_directory + "/econ_project/src/proj23_03_tracebility/cpp/uni_directional_implementation/test_data/";
+    }
+
+    static bool parse(const std::string &line, TransferFields &fields) {
+        return parse_transfer_line(line.data(), line.data() + line.size(), fields);
+    }
+};
+
+TEST_F(ChunkLoaderTest, ParseLine) {
+    TransferFields fields;
+    // The fields point into the line, so it has to outlive them
+    const std::string line = "address1,address2,250.00";
+    ASSERT_TRUE(parse(line, fields));
+    EXPECT_EQ(std::string(fields.address1, fields.address1_length), "address1");
+    EXPECT_EQ(std::string(fields.address2, fields.address2_length), "address2");
+    EXPECT_FLOAT_EQ(fields.total_transfer_usd, 250.0f);
+
+    // Windows line endings and trailing columns are tolerated
+    ASSERT_TRUE(parse("a,b,10\r", fields));
+    EXPECT_FLOAT_EQ(fields.total_transfer_usd, 10.0f);
+    ASSERT_TRUE(parse("a,b,1e3,2024-05-31", fields));
+    EXPECT_FLOAT_EQ(fields.total_transfer_usd, 1000.0f);
+
+    EXPECT_FALSE(parse("address1,address2", fields));
+    EXPECT_FALSE(parse("address1,address2,", fields));
+    EXPECT_FALSE(parse("address1,address2,abc", fields));
+    EXPECT_FALSE(parse("garbage", fields));
+}
+
+TEST_F(ChunkLoaderTest, ParseFirstSeenDate) {
+    TransferFields fields;
+    ASSERT_TRUE(parse("a,b,10,2024-05-31", fields));
+    EXPECT_EQ(fields.first_seen, 19874);
+    ASSERT_TRUE(parse("a,b,10,2024-05-31\r", fields));
+    EXPECT_EQ(fields.first_seen, 19874);
+    // Absent or empty dates leave the transfer undated
+    ASSERT_TRUE(parse("a,b,10", fields));
+    EXPECT_EQ(fields.first_seen, UNDATED);
+    ASSERT_TRUE(parse("a,b,10,", fields));
+    EXPECT_EQ(fields.first_seen, UNDATED);
+    EXPECT_FALSE(parse("a,b,10,2024-02-30", fields));
+    EXPECT_FALSE(parse("a,b,10,31/05/2024", fields));
+    // 1970-01-01 would collide with the UNDATED sentinel
+    EXPECT_FALSE(parse("a,b,10,1970-01-01", fields));
+    EXPECT_FALSE(parse("a,b,10,1969-12-31", fields));
+
+    uint32_t days;
+    const std::string leap_day = "2000-02-29";
+    ASSERT_TRUE(parse_date(leap_day.data(), leap_day.data() + leap_day.size(), days));
+    EXPECT_EQ(days, 11016);
+    EXPECT_EQ(format_date(days), leap_day);
+    const std::string first_day = "1970-01-02";
+    ASSERT_TRUE(parse_date(first_day.data(), first_day.data() + first_day.size(), days));
+    EXPECT_EQ(days, 1);
+    EXPECT_EQ(format_date(days), first_day);
+    EXPECT_EQ(format_date(19874), "2024-05-31");
+}
+
+TEST_F(ChunkLoaderTest, FindChunkFiles) {
+    std::vector<std::string> chunk_files = find_chunk_files(test_data + "test_build_graph2_");
+    ASSERT_EQ(chunk_files.size(), 2);
+    EXPECT_EQ(chunk_files[0], test_data + "test_build_graph2_000000000000");
+    EXPECT_EQ(chunk_files[1], test_data + "test_build_graph2_000000000001");
+    EXPECT_TRUE(find_chunk_files(test_data + "no_such_chunks_").empty());
+    EXPECT_EQ(numbered_chunk_files(test_data + "test_build_graph2_", 2), chunk_files);
+}
+
+TEST_F(ChunkLoaderTest, LoadKeepsSemantics) {
+    AddressInterner interner;
+    std::vector<TransferEdge> edges;
+    auto stats = load_transfer_chunks(find_chunk_files(test_data + "test_build_graph1_"), interner, edges);
+    ASSERT_EQ(stats.size(), 1);
+    EXPECT_EQ(stats[0].lines, 5);
+    EXPECT_EQ(stats[0].malformed_lines, 0);
+    // Self-loop and the 9 USD transfer are dropped, their addresses are kept
+    ASSERT_EQ(interner.size(), 4);
+    ASSERT_EQ(edges.size(), 3);
+    EXPECT_EQ(interner.address(0), "address1");
+    EXPECT_EQ(interner.address(3), "address4");
+    EXPECT_EQ(edges[0].src, 0u);
+    EXPECT_EQ(edges[0].dst, 1u);
+    EXPECT_EQ(edges[2].src, 2u);
+    EXPECT_EQ(edges[2].dst, 0u);
+    EXPECT_FLOAT_EQ(edges[2].total_transfer_usd, 10.0f);
+}
+
+TEST_F(ChunkLoaderTest, DeterministicNumbering) {
+    std::vector<std::string> chunk_files = find_chunk_files(test_data + "test_build_graph2_");
+    chunk_files.push_back(test_data + "test_build_graph3_000000000000");
+    AddressInterner serial_interner, parallel_interner;
+    std::vector<TransferEdge> serial_edges, parallel_edges;
+
+    int threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    load_transfer_chunks(chunk_files, serial_interner, serial_edges);
+    omp_set_num_threads(4);
+    load_transfer_chunks(chunk_files, parallel_interner, parallel_edges);
+    omp_set_num_threads(threads);
+
+    ASSERT_EQ(serial_interner.size(), parallel_interner.size());
+    for (VertexId id = 0; id < serial_interner.size(); ++id) {
+        EXPECT_EQ(serial_interner.address(id), parallel_interner.address(id));
+    }
+    ASSERT_EQ(serial_edges.size(), parallel_edges.size());
+    for (size_t e = 0; e < serial_edges.size(); ++e) {
+        EXPECT_EQ(serial_edges[e].src, parallel_edges[e].src);
+        EXPECT_EQ(serial_edges[e].dst, parallel_edges[e].dst);
+    }
+}
+
+TEST_F(ChunkLoaderTest, MalformedLinesAreSkipped) {
+    std::string base = ::testing::TempDir() + "malformed_chunk_";
+    {
+        std::ofstream chunk(base + "000000000000");
+        chunk << "address1,address2,total_transfer_usd\n"
+              << "a,b,100\n"
+              << "broken line\n"
+              << "\n"
+              << "b,c,not_a_number\n"
+              << "c,a,20\n";
+    }
+    AddressInterner interner;
+    std::vector<TransferEdge> edges;
+    auto stats = load_transfer_chunks(find_chunk_files(base), interner, edges);
+    ASSERT_EQ(stats.size(), 1);
+    EXPECT_EQ(stats[0].malformed_lines, 2);
+    EXPECT_EQ(interner.size(), 3);
+    EXPECT_EQ(edges.size(), 2);
+    std::remove((base + "000000000000").c_str());
+}
+
+TEST_F(ChunkLoaderTest, CSRFromEdges) {
+    AddressInterner interner;
+    CSRGraph graph;
+    build_graph_from_chunks(find_chunk_files(test_data + "test_build_graph3_"), graph, interner);
+    ASSERT_EQ(num_vertices(graph), 18);
+    ASSERT_EQ(num_edges(graph), 16);
+    VertexId v;
+    ASSERT_TRUE(interner.find("address6", v));
+    std::unordered_set<std::string> neighbors;
+    for (uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+        neighbors.insert(interner.address(graph.neighbors[e]));
+    }
+    EXPECT_EQ(neighbors, (std::unordered_set<std::string>{"address7", "address8", "address9"}));
+}
+
+TEST_F(ChunkLoaderTest, NeighborsSortedByDescendingWeight) {
+    std::string base = ::testing::TempDir() + "weighted_chunk_";
+    {
+        std::ofstream chunk(base + "000000000000");
+        chunk << "address1,address2,total_transfer_usd\n"
+              << "s,a,50\n"
+              << "s,b,1000\n"
+              << "s,c,50\n"
+              << "s,d,200\n"
+              << "a,d,30\n";
+    }
+    AddressInterner interner;
+    CSRGraph graph;
+    build_graph_from_chunks(find_chunk_files(base), graph, interner);
+    std::remove((base + "000000000000").c_str());
+    ASSERT_EQ(graph.weights.size(), num_edges(graph));
+    EXPECT_EQ(weight_memory_bytes(graph), graph.weights.capacity() * sizeof(float));
+
+    VertexId s, a, b, c, d;
+    ASSERT_TRUE(interner.find("s", s) && interner.find("a", a) && interner.find("b", b) && interner.find("c", c) && interner.find("d", d));
+    std::vector<VertexId> neighbors(graph.neighbors.begin() + graph.offsets[s], graph.neighbors.begin() + graph.offsets[s + 1]);
+    std::vector<float> weights(graph.weights.begin() + graph.offsets[s], graph.weights.begin() + graph.offsets[s + 1]);
+    // Equal weights fall back to vertex id order
+    EXPECT_EQ(neighbors, (std::vector<VertexId>{b, d, a, c}));
+    EXPECT_EQ(weights, (std::vector<float>{1000, 200, 50, 50}));
+    EXPECT_EQ(weighted_end(s, graph, 100.0f), graph.offsets[s] + 2);
+    EXPECT_EQ(weighted_end(s, graph, 50.0f), graph.offsets[s] + 4);
+    EXPECT_EQ(weighted_end(s, graph, 5000.0f), graph.offsets[s]);
+
+    // The transpose keeps the weights, heaviest in-edge first
+    CSRGraph reverse = transpose_csr_graph(graph);
+    std::vector<VertexId> in_neighbors(reverse.neighbors.begin() + reverse.offsets[d], reverse.neighbors.begin() + reverse.offsets[d + 1]);
+    EXPECT_EQ(in_neighbors, (std::vector<VertexId>{s, a}));
+    EXPECT_EQ(reverse.weights[reverse.offsets[d]], 200.0f);
+    EXPECT_EQ(reverse.weights[reverse.offsets[d] + 1], 30.0f);
+}
+
+TEST_F(ChunkLoaderTest, ReverseGraphFromEdges) {
+    std::vector<std::string> chunk_files = find_chunk_files(test_data + "test_build_graph2_");
+    chunk_files.push_back(test_data + "test_build_graph3_000000000000");
+    AddressInterner interner;
+    CSRGraph graph, reverse;
+    build_graph_from_chunks(chunk_files, graph, reverse, interner);
+    // Built during ingest, it must be exactly the transpose of the forward graph
+    CSRGraph transposed = transpose_csr_graph(graph);
+    EXPECT_EQ(reverse.offsets, transposed.offsets);
+    EXPECT_EQ(reverse.neighbors, transposed.neighbors);
+    EXPECT_EQ(reverse.weights, transposed.weights);
+
+    VertexId v;
+    ASSERT_TRUE(interner.find("address9", v));
+    std::unordered_set<std::string> in_neighbors;
+    for (uint64_t e = reverse.offsets[v]; e < reverse.offsets[v + 1]; ++e) {
+        in_neighbors.insert(interner.address(reverse.neighbors[e]));
+    }
+    EXPECT_EQ(in_neighbors, (std::unordered_set<std::string>{"address4", "address6"}));
+}
+
+TEST_F(ChunkLoaderTest, RepeatedPairsMerged) {
+    std::string base = ::testing::TempDir() + "repeated_chunk_";
+    {
+        std::ofstream chunk(base + "000000000000");
+        chunk << "address1,address2,total_transfer_usd\n"
+              << "s,a,50\n"
+              << "s,b,300\n"
+              << "s,a,100\n";
+    }
+    {
+        std::ofstream chunk(base + "000000000001");
+        chunk << "address1,address2,total_transfer_usd\n"
+              << "s,a,400\n"
+              << "b,a,20\n";
+    }
+    AddressInterner interner;
+    CSRGraph graph, reverse;
+    build_graph_from_chunks(find_chunk_files(base), graph, reverse, interner);
+    std::remove((base + "000000000000").c_str());
+    std::remove((base + "000000000001").c_str());
+
+    // Three s -> a rows become one edge carrying their total
+    ASSERT_EQ(num_edges(graph), 3);
+    VertexId s, a, b;
+    ASSERT_TRUE(interner.find("s", s) && interner.find("a", a) && interner.find("b", b));
+    std::vector<VertexId> neighbors(graph.neighbors.begin() + graph.offsets[s], graph.neighbors.begin() + graph.offsets[s + 1]);
+    std::vector<float> weights(graph.weights.begin() + graph.offsets[s], graph.weights.begin() + graph.offsets[s + 1]);
+    EXPECT_EQ(neighbors, (std::vector<VertexId>{a, b}));
+    EXPECT_EQ(weights, (std::vector<float>{550, 300}));
+    CSRGraph transposed = transpose_csr_graph(graph);
+    EXPECT_EQ(reverse.offsets, transposed.offsets);
+    EXPECT_EQ(reverse.neighbors, transposed.neighbors);
+    EXPECT_EQ(reverse.weights, transposed.weights);
+}
+
+TEST_F(ChunkLoaderTest, DatedGraphListsInDateOrder) {
+    AddressInterner interner;
+    CSRGraph graph;
+    std::vector<uint32_t> first_seen;
+    build_graph_from_chunks(find_chunk_files(test_data + "test_build_graph4_"), graph, first_seen, interner);
+    ASSERT_EQ(first_seen.size(), num_edges(graph));
+    // The two address6 -> address7 rows become one edge dated at the earlier one
+    EXPECT_EQ(num_edges(graph), 17);
+    VertexId v6, v7, v8, v9;
+    ASSERT_TRUE(interner.find("address6", v6) && interner.find("address7", v7) && interner.find("address8", v8) && interner.find("address9", v9));
+    const uint64_t begin = graph.offsets[v6];
+    EXPECT_EQ(std::vector<VertexId>(graph.neighbors.begin() + begin, graph.neighbors.begin() + graph.offsets[v6 + 1]), (std::vector<VertexId>{v8, v7, v9}));
+    EXPECT_EQ(format_date(first_seen[begin + 1]), "2024-01-10");
+    EXPECT_FLOAT_EQ(graph.weights[begin + 1], 370.0f);
+    uint32_t cutoff;
+    const std::string date = "2024-01-15";
+    ASSERT_TRUE(parse_date(date.data(), date.data() + date.size(), cutoff));
+    EXPECT_EQ(dated_end(v6, graph, first_seen, cutoff), begin + 2);
+
+    // The undated row counts from the start
+    VertexId v5;
+    ASSERT_TRUE(interner.find("address5", v5));
+    EXPECT_EQ(first_seen[graph.offsets[v5]], UNDATED);
+}
+
+TEST_F(ChunkLoaderTest, DatedPairStartsWhenItPassesTheDustFilter) {
+    AddressInterner interner;
+    CSRGraph graph;
+    std::vector<uint32_t> first_seen;
+    build_graph_from_chunks(find_chunk_files(test_data + "test_build_graph4_"), graph, first_seen, interner);
+    // address15 -> address16 sends 8 USD on 2024-04-20 and 5 USD on 2024-05-01
+    VertexId v15, v16;
+    ASSERT_TRUE(interner.find("address15", v15) && interner.find("address16", v16));
+    const uint64_t begin = graph.offsets[v15];
+    ASSERT_EQ(graph.offsets[v15 + 1], begin + 1);
+    EXPECT_EQ(graph.neighbors[begin], v16);
+    EXPECT_EQ(format_date(first_seen[begin]), "2024-05-01");
+    EXPECT_FLOAT_EQ(graph.weights[begin], 13.0f);
+    uint32_t cutoff;
+    const std::string date = "2024-04-30";
+    ASSERT_TRUE(parse_date(date.data(), date.data() + date.size(), cutoff));
+    EXPECT_EQ(dated_end(v15, graph, first_seen, cutoff), begin);
+    EXPECT_EQ(dated_end(v15, graph, first_seen, cutoff + 1), begin + 1);
+
+    // A pair whose rows never reach 10 USD is dropped
+    std::vector<uint32_t> dust_first_seen;
+    const CSRGraph dust = build_dated_csr_graph(2, {TransferEdge{0, 1, 4.0f, 19800}, TransferEdge{0, 1, 5.0f, 19810}}, dust_first_seen);
+    EXPECT_EQ(num_edges(dust), 0);
+}
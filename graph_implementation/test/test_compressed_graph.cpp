@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+#include "compressed_graph.hpp"
+#include "chunk_loader.hpp"
+
+class CompressedGraphTest : public ::testing::Test {
+protected:
+    CSRGraph graph, reverse;
+    AddressInterner interner;
+    std::vector<VertexId> seeds;
+    const char *home_dir;
+    std::string home_directory;
+
+    void SetUp() override {
+        home_dir = getenv("HOME");
+        home_directory = std::string(home_dir);
+        std::string test_data = home_directory + "/econ_project/src/proj23_03_tracebility/cpp/uni_directional_implementation/test_data/";
+
+        build_graph_from_chunks(find_chunk_files(test_data + "test_build_graph3_"), graph, reverse, interner);
+        seeds = read_kyc_addr(test_data + "test_kyc.csv", interner);
+    }
+
+    static std::vector<VertexId> decode(const CompressedGraph &compressed, VertexId v) {
+        std::vector<VertexId> list;
+        VertexId w;
+        for (NeighborDecoder it(compressed, v); it.next(w);) {
+            list.push_back(w);
+        }
+        return list;
+    }
+};
+
+TEST_F(CompressedGraphTest, ListsDecodeSorted) {
+    CompressedGraph compressed = compress_csr_graph(graph);
+    ASSERT_EQ(num_vertices(compressed), num_vertices(graph));
+    EXPECT_EQ(num_edges(compressed), num_edges(graph));
+    for (VertexId v = 0; v < num_vertices(graph); ++v) {
+        std::vector<VertexId> expected(graph.neighbors.begin() + graph.offsets[v], graph.neighbors.begin() + graph.offsets[v + 1]);
+        std::sort(expected.begin(), expected.end());
+        EXPECT_EQ(decode(compressed, v), expected);
+        EXPECT_EQ(out_degree(v, compressed), out_degree(v, graph));
+    }
+}
+
+TEST_F(CompressedGraphTest, LargeGapsAndRepeats) {
+    // One list whose gaps need 1 to 5 varint bytes, with a repeat; the encoder never looks up the targets
+    CSRGraph wide;
+    wide.neighbors = {4000000000u, 3, 200, 3, 70000, 2000000};
+    wide.offsets = {0, wide.neighbors.size()};
+    CompressedGraph compressed = compress_csr_graph(wide);
+    EXPECT_EQ(decode(compressed, 0), (std::vector<VertexId>{3, 200, 70000, 2000000, 4000000000u}));
+    EXPECT_EQ(num_edges(compressed), 5);
+}
+
+TEST_F(CompressedGraphTest, WeightThreshold) {
+    // Only address15 -> address16 is under 10 USD, and the loader already dropped it
+    CompressedGraph all = compress_csr_graph(graph);
+    CompressedGraph heavy = compress_csr_graph(graph, 300.0f);
+    EXPECT_EQ(num_edges(heavy), 0);
+    EXPECT_LT(memory_bytes(heavy), memory_bytes(all));
+}
+
+TEST_F(CompressedGraphTest, SameDistancesAsCSR) {
+    CompressedGraph compressed = compress_csr_graph(graph);
+    CompressedGraph compressed_reverse = compress_csr_graph(reverse);
+    for (int alpha : {1, 15, 1 << 30}) {
+        std::vector<uint8_t> expected, hops;
+        bfs_direction_optimizing(graph, reverse, seeds, 5, expected, alpha, 18);
+        std::vector<BFSLevelStats> stats = bfs_compressed(compressed, compressed_reverse, seeds, 5, hops, alpha, 18);
+        EXPECT_EQ(hops, expected) << "alpha " << alpha;
+        EXPECT_FALSE(stats.empty());
+    }
+}
@@ -0,0 +1,74 @@
+#include "gtest/gtest.h"
+#include "parallel_bfs.hpp"
+
+class CSRGraphTest : public ::testing::Test {
+protected:
+    Graph graph1, graph3;
+    CSRGraph csr1, csr3;
+    std::unordered_map<std::string, Vertex> address_to_vertex1, address_to_vertex3;
+    std::unordered_set<Vertex> kyc_nodes;
+    std::unordered_map<Vertex, std::string> vertex_to_address;
+    std::unordered_map<std::string, int> expected_hops, actual_hops;
+    const char *home_dir;
+    std::string home_directory;
+
+    void SetUp() override {
+        // Initialize home_directory.
+        home_dir = getenv("HOME");
+        home_directory = std::string(home_dir);
+        std::string test_data = home_directory + "/econ_project/src/proj23_03_tracebility/cpp/uni_directional_implementation/test_data/";
+
+        build_graph_from_chunks(test_data + "test_build_graph1_", 1, graph1, address_to_vertex1);
+        build_graph_from_chunks(test_data + "test_build_graph3_", 1, graph3, address_to_vertex3);
+        csr1 = build_csr_graph(graph1);
+        csr3 = build_csr_graph(graph3);
+
+        kyc_nodes = read_kyc_addr(test_data + "test_kyc.csv", address_to_vertex3);
+        for (const auto &entry : address_to_vertex3) {
+            vertex_to_address[entry.second] = entry.first;
+        }
+        // Result through the adjacency_list entry point, which converts to CSR itself
+        bfs_from_kyc_nodes_parallel(graph3, kyc_nodes, 5, expected_hops, vertex_to_address);
+        bfs_from_kyc_nodes_parallel(csr3, transpose_csr_graph(csr3), kyc_nodes, 5, actual_hops, vertex_to_address);
+    }
+};
+
+TEST_F(CSRGraphTest, BasicGraphInfo) {
+    EXPECT_EQ(num_vertices(csr1), num_vertices(graph1));
+    EXPECT_EQ(num_edges(csr1), num_edges(graph1));
+    EXPECT_EQ(num_vertices(csr3), num_vertices(graph3));
+    EXPECT_EQ(num_edges(csr3), num_edges(graph3));
+    EXPECT_EQ(csr3.offsets.size(), num_vertices(graph3) + 1);
+}
+
+TEST_F(CSRGraphTest, SameAdjacency) {
+    for (size_t v = 0; v < num_vertices(graph3); ++v) {
+        std::vector<VertexId> expected;
+        graph_traits<Graph>::adjacency_iterator ai, ai_end;
+        for (tie(ai, ai_end) = adjacent_vertices(v, graph3); ai != ai_end; ++ai) {
+            expected.push_back(static_cast<VertexId>(*ai));
+        }
+        std::vector<VertexId> actual(csr3.neighbors.begin() + csr3.offsets[v], csr3.neighbors.begin() + csr3.offsets[v + 1]);
+        ASSERT_EQ(actual, expected) << "Adjacency mismatch for vertex " << v;
+    }
+}
+
+TEST_F(CSRGraphTest, BFSMatchesAdjacencyList) {
+    ASSERT_EQ(actual_hops.size(), 18);
+    ASSERT_EQ(actual_hops, expected_hops);
+    ASSERT_EQ(actual_hops["address6"], 0);
+    ASSERT_EQ(actual_hops["address15"], 5);
+    ASSERT_EQ(actual_hops["address16"], 6);
+}
+
+TEST_F(CSRGraphTest, Transpose) {
+    CSRGraph reverse1 = transpose_csr_graph(csr1);
+    ASSERT_EQ(num_vertices(reverse1), num_vertices(csr1));
+    ASSERT_EQ(num_edges(reverse1), num_edges(csr1));
+    // address1 receives from address2 and address3
+    VertexId v = address_to_vertex1["address1"];
+    std::vector<VertexId> in_neighbors(reverse1.neighbors.begin() + reverse1.offsets[v], reverse1.neighbors.begin() + reverse1.offsets[v + 1]);
+    std::vector<VertexId> expected = {static_cast<VertexId>(address_to_vertex1["address2"]), static_cast<VertexId>(address_to_vertex1["address3"])};
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(in_neighbors, expected);
+}
@@ -0,0 +1,96 @@
+#include "gtest/gtest.h"
+#include "frontier_scheduler.hpp"
+#include "parallel_bfs.hpp"
+
+// Vertex 0 is a hub with 10000 out-edges to 1..10000, vertices 1..10000 have one edge back to 0,
+// and vertex 10001 has no edges
+class FrontierSchedulerTest : public ::testing::Test {
+protected:
+    CSRGraph graph;
+
+    void SetUp() override {
+        const size_t hub_degree = 10000;
+        graph.offsets.push_back(0);
+        graph.offsets.push_back(hub_degree);
+        for (size_t v = 1; v <= hub_degree; ++v) {
+            graph.neighbors.push_back(static_cast<VertexId>(v));
+        }
+        for (size_t v = 1; v <= hub_degree; ++v) {
+            graph.neighbors.push_back(0);
+            graph.offsets.push_back(graph.neighbors.size());
+        }
+        graph.offsets.push_back(graph.neighbors.size());
+    }
+
+    // How often every edge of the graph was handed out by one parallel run
+    std::vector<int> visit_counts(FrontierScheduler &scheduler, const std::vector<VertexId> &queue) {
+        std::vector<int> counts(num_edges(graph), 0);
+        scheduler.plan(queue, graph, [this](VertexId u) { return graph.offsets[u + 1]; });
+#pragma omp parallel num_threads(4)
+        {
+            scheduler.run([&](VertexId u, uint64_t begin, uint64_t end) {
+                EXPECT_GE(begin, graph.offsets[u]);
+                EXPECT_LE(end, graph.offsets[u + 1]);
+                for (uint64_t e = begin; e < end; ++e) {
+                    __atomic_fetch_add(&counts[e], 1, __ATOMIC_RELAXED);
+                }
+            });
+        }
+        return counts;
+    }
+};
+
+TEST_F(FrontierSchedulerTest, HubSplitAcrossChunks) {
+    FrontierScheduler scheduler(64);
+    std::vector<VertexId> queue = {0, 10001, 5, 7};
+    std::vector<int> counts = visit_counts(scheduler, queue);
+    EXPECT_EQ(scheduler.total_edges(), 10002);
+    EXPECT_EQ(scheduler.num_chunks(), (10002 + 63) / 64);
+    // The hub's list and the two small lists are each covered exactly once
+    for (uint64_t e = 0; e < num_edges(graph); ++e) {
+        const bool in_queue = e < 10000 || e == graph.offsets[5] || e == graph.offsets[7];
+        EXPECT_EQ(counts[e], in_queue ? 1 : 0) << "edge " << e;
+    }
+    EXPECT_EQ(scheduler.busy_seconds().size(), 4);
+}
+
+TEST_F(FrontierSchedulerTest, EmptyFrontier) {
+    FrontierScheduler scheduler;
+    std::vector<VertexId> queue = {10001};
+    std::vector<int> counts = visit_counts(scheduler, queue);
+    EXPECT_EQ(scheduler.total_edges(), 0);
+    EXPECT_EQ(scheduler.num_chunks(), 0);
+    EXPECT_EQ(std::count(counts.begin(), counts.end(), 0), static_cast<long>(counts.size()));
+}
+
+TEST_F(FrontierSchedulerTest, WeightPrefixOnly) {
+    FrontierScheduler scheduler(100);
+    std::vector<VertexId> queue = {0};
+    // Only the first 250 edges of the hub pass the (pretend) threshold
+    scheduler.plan(queue, graph, [this](VertexId u) { return graph.offsets[u] + 250; });
+    std::atomic<uint64_t> visited(0);
+#pragma omp parallel num_threads(3)
+    {
+        scheduler.run([&](VertexId, uint64_t begin, uint64_t end) { visited += end - begin; });
+    }
+    EXPECT_EQ(scheduler.num_chunks(), 3);
+    EXPECT_EQ(visited.load(), 250);
+}
+
+TEST_F(FrontierSchedulerTest, BFSThroughHub) {
+    CSRGraph reverse = transpose_csr_graph(graph);
+    std::vector<uint8_t> hops;
+    // alpha = 1 keeps every level top-down
+    std::vector<BFSLevelStats> stats = bfs_direction_optimizing(graph, reverse, {1}, 5, hops, 1, 18);
+    EXPECT_EQ(hops[1], 0);
+    EXPECT_EQ(hops[0], 1);
+    EXPECT_EQ(hops[2], 2);
+    EXPECT_EQ(hops[10000], 2);
+    EXPECT_EQ(hops[10001], UNVISITED_HOPS);
+    ASSERT_GE(stats.size(), 2);
+    EXPECT_FALSE(stats[1].bottom_up);
+    EXPECT_EQ(stats[1].edges_scanned, 10000);
+    EXPECT_EQ(stats[1].discovered, 9999);
+    EXPECT_GT(stats[1].max_busy_seconds, 0.0);
+    EXPECT_LE(stats[1].mean_busy_seconds, stats[1].max_busy_seconds);
+}
@@ -0,0 +1,122 @@
+#include "gtest/gtest.h"
+#include "graph_snapshot.hpp"
+#include "chunk_loader.hpp"
+
+class GraphSnapshotTest : public ::testing::Test {
+protected:
+    CSRGraph graph;
+    AddressInterner interner;
+    std::vector<std::string> chunk_files;
+    std::string snapshot_filename;
+    const char *home_dir;
+    std::string home_directory;
+
+    void SetUp() override {
+        // Initialize home_directory.
+        home_dir = getenv("HOME");
+        home_directory = std::string(home_dir);
+        std::string test_data = home_directory + "/econ_project/src/proj23_03_tracebility/cpp/uni_directional_implementation/test_data/";
+
+        chunk_files = find_chunk_files(test_data + "test_build_graph2_");
+        chunk_files.push_back(test_data + "test_build_graph3_000000000000");
+        build_graph_from_chunks(chunk_files, graph, interner);
+        snapshot_filename = ::testing::TempDir() + "test_graph.snapshot";
+        write_graph_snapshot(snapshot_filename, graph, interner, fingerprint_chunks(chunk_files));
+    }
+
+    void TearDown() override {
+        std::remove(snapshot_filename.c_str());
+    }
+};
+
+TEST_F(GraphSnapshotTest, RoundTrip) {
+    CSRGraph loaded_graph;
+    AddressInterner loaded_interner;
+    ASSERT_TRUE(read_graph_snapshot(snapshot_filename, fingerprint_chunks(chunk_files), loaded_graph, loaded_interner));
+    EXPECT_EQ(loaded_graph.offsets, graph.offsets);
+    EXPECT_EQ(loaded_graph.neighbors, graph.neighbors);
+    EXPECT_EQ(loaded_graph.weights, graph.weights);
+    ASSERT_EQ(loaded_interner.size(), interner.size());
+    for (VertexId id = 0; id < interner.size(); ++id) {
+        EXPECT_EQ(loaded_interner.address(id), interner.address(id));
+        VertexId found;
+        ASSERT_TRUE(loaded_interner.find(interner.address(id), found));
+        EXPECT_EQ(found, id);
+    }
+}
+
+TEST_F(GraphSnapshotTest, HexAddressesRoundTrip) {
+    AddressInterner hex_interner;
+    hex_interner.intern("0x64a2d48e878e344f948fc76c25368fb9c648a5cc");
+    hex_interner.intern("address1");
+    hex_interner.intern("0x22940b6b11430508809f5fa668c02dff724023e4");
+    CSRGraph hex_graph = build_csr_graph(3, {TransferEdge{0, 2, 100.0f}, TransferEdge{1, 0, 50.0f}});
+    write_graph_snapshot(snapshot_filename, hex_graph, hex_interner, {});
+
+    CSRGraph loaded_graph;
+    AddressInterner loaded_interner;
+    ASSERT_TRUE(read_graph_snapshot(snapshot_filename, {}, loaded_graph, loaded_interner));
+    EXPECT_EQ(loaded_graph.neighbors, hex_graph.neighbors);
+    VertexId id;
+    ASSERT_TRUE(loaded_interner.find("0x22940b6b11430508809f5fa668c02dff724023e4", id));
+    EXPECT_EQ(id, 2u);
+    EXPECT_EQ(loaded_interner.address(1), "address1");
+    // New addresses keep extending the same id sequence
+    EXPECT_EQ(loaded_interner.intern("0x0000000000000000000000000000000000000001"), 3u);
+}
+
+TEST_F(GraphSnapshotTest, StaleChunkListIsRejected) {
+    CSRGraph loaded_graph;
+    AddressInterner loaded_interner;
+    std::vector<ChunkFingerprint> changed = fingerprint_chunks(chunk_files);
+    changed[0].modified_time += 1;
+    EXPECT_FALSE(read_graph_snapshot(snapshot_filename, changed, loaded_graph, loaded_interner));
+    changed.pop_back();
+    EXPECT_FALSE(read_graph_snapshot(snapshot_filename, changed, loaded_graph, loaded_interner));
+}
+
+TEST_F(GraphSnapshotTest, CorruptionIsDetected) {
+    {
+        std::fstream file(snapshot_filename, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-3, std::ios::end);
+        file.put('\x7f');
+    }
+    CSRGraph loaded_graph;
+    AddressInterner loaded_interner;
+    EXPECT_FALSE(read_graph_snapshot(snapshot_filename, fingerprint_chunks(chunk_files), loaded_graph, loaded_interner));
+    EXPECT_FALSE(read_graph_snapshot(snapshot_filename + ".missing", fingerprint_chunks(chunk_files), loaded_graph, loaded_interner));
+}
+
+TEST_F(GraphSnapshotTest, LoadOrBuildRebuildsStaleSnapshot) {
+    // A snapshot for a different chunk list is replaced by one for the current list
+    std::vector<std::string> fewer_chunks(chunk_files.begin(), chunk_files.begin() + 2);
+    CSRGraph rebuilt;
+    AddressInterner rebuilt_interner;
+    load_or_build_graph(fewer_chunks, snapshot_filename, rebuilt, rebuilt_interner);
+    EXPECT_EQ(num_vertices(rebuilt), 5);
+
+    CSRGraph loaded_graph;
+    AddressInterner loaded_interner;
+    ASSERT_TRUE(read_graph_snapshot(snapshot_filename, fingerprint_chunks(fewer_chunks), loaded_graph, loaded_interner));
+    EXPECT_EQ(loaded_graph.neighbors, rebuilt.neighbors);
+}
+
+TEST_F(GraphSnapshotTest, ReverseIndexOnHitAndRebuild) {
+    // Hit: the reverse index is the transpose of the loaded lists
+    CSRGraph loaded_graph, loaded_reverse;
+    AddressInterner loaded_interner;
+    load_or_build_graph(chunk_files, snapshot_filename, loaded_graph, loaded_reverse, loaded_interner);
+    CSRGraph expected = transpose_csr_graph(graph);
+    EXPECT_EQ(loaded_reverse.offsets, expected.offsets);
+    EXPECT_EQ(loaded_reverse.neighbors, expected.neighbors);
+    EXPECT_EQ(loaded_reverse.weights, expected.weights);
+
+    // Rebuild: the reverse index comes from the parsed edges
+    std::remove(snapshot_filename.c_str());
+    CSRGraph rebuilt_graph, rebuilt_reverse;
+    AddressInterner rebuilt_interner;
+    load_or_build_graph(chunk_files, snapshot_filename, rebuilt_graph, rebuilt_reverse, rebuilt_interner);
+    EXPECT_EQ(rebuilt_reverse.offsets, expected.offsets);
+    EXPECT_EQ(rebuilt_reverse.neighbors, expected.neighbors);
+    EXPECT_EQ(rebuilt_reverse.weights, expected.weights);
+}
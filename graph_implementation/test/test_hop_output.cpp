@@ -0,0 +1,198 @@
+#include "gtest/gtest.h"
+#include "hop_output.hpp"
+#include "chunk_loader.hpp"
+
+class HopOutputTest : public ::testing::Test {
+protected:
+    CSRGraph graph, reverse;
+    AddressInterner interner;
+    std::vector<uint8_t> hops;
+    std::unordered_map<std::string, int> expected_hops;
+    std::string output_filename;
+    const char *home_dir;
+    std::string home_directory;
+
+    void SetUp() override {
+        // Initialize home_directory.
+        home_dir = getenv("HOME");
+        home_directory = std::string(home_dir);
+        std::string test_data = home_directory + "/econ_project/src/proj23_03_tracebility/cpp/uni_directional_implementation/test_data/";
+
+        build_graph_from_chunks(find_chunk_files(test_data + "test_build_graph3_"), graph, interner);
+        reverse = transpose_csr_graph(graph);
+        bfs_direction_optimizing(graph, reverse, read_kyc_addr(test_data + "test_kyc.csv", interner), 5, hops);
+
+        // Reference result from the adjacency_list pipeline
+        Graph boost_graph;
+        std::unordered_map<std::string, Vertex> address_to_vertex;
+        std::unordered_map<Vertex, std::string> vertex_to_address;
+        build_graph_from_chunks(test_data + "test_build_graph3_", 1, boost_graph, address_to_vertex);
+        for (const auto &entry : address_to_vertex) {
+            vertex_to_address[entry.second] = entry.first;
+        }
+        bfs_from_kyc_nodes_parallel(boost_graph, read_kyc_addr(test_data + "test_kyc.csv", address_to_vertex), 5, expected_hops, vertex_to_address);
+
+        output_filename = ::testing::TempDir() + "test_hops_output";
+    }
+
+    void TearDown() override {
+        std::remove(output_filename.c_str());
+    }
+
+    std::vector<std::string> read_lines() {
+        std::ifstream input(output_filename);
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(input, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+};
+
+TEST_F(HopOutputTest, SentinelArray) {
+    ASSERT_EQ(hops.size(), 18);
+    VertexId v;
+    ASSERT_TRUE(interner.find("address15", v));
+    EXPECT_EQ(hops[v], 5);
+    ASSERT_TRUE(interner.find("address16", v));
+    EXPECT_EQ(hops[v], UNVISITED_HOPS);
+}
+
+TEST_F(HopOutputTest, TextMatchesAddressToHops) {
+    write_hops_text(output_filename, hops, interner, 6);
+    std::vector<std::string> lines = read_lines();
+    ASSERT_EQ(lines.size(), expected_hops.size());
+    std::unordered_map<std::string, int> written;
+    for (const std::string &line : lines) {
+        size_t comma = line.find(',');
+        ASSERT_NE(comma, std::string::npos);
+        written[line.substr(0, comma)] = std::stoi(line.substr(comma + 1));
+    }
+    EXPECT_EQ(written, expected_hops);
+    // Vertex order is the order of first appearance
+    EXPECT_EQ(lines[0], "address1,6");
+}
+
+TEST_F(HopOutputTest, SortedText) {
+    write_hops_text(output_filename, hops, interner, 6, HopOutputOrder::Sorted);
+    std::vector<std::string> lines = read_lines();
+    ASSERT_EQ(lines.size(), 18);
+    EXPECT_TRUE(std::is_sorted(lines.begin(), lines.end()));
+    EXPECT_EQ(lines[0], "address1,6");
+    EXPECT_EQ(lines[1], "address10,1");
+}
+
+TEST_F(HopOutputTest, LargeHexOutput) {
+    // Enough vertices for several blocks per thread, in both orders
+    AddressInterner hex_interner;
+    std::vector<uint8_t> hex_hops;
+    for (uint32_t i = 0; i < 300000; ++i) {
+        AddressKey key{};
+        uint32_t scrambled = i * 2654435761u;
+        std::memcpy(key.bytes, &scrambled, sizeof(scrambled));
+        std::memcpy(key.bytes + 16, &i, sizeof(i));
+        hex_interner.intern_key(key);
+        hex_hops.push_back(i % 7 == 0 ? UNVISITED_HOPS : static_cast<uint8_t>(i % 6));
+    }
+    size_t bytes = write_hops_text(output_filename, hex_hops, hex_interner, 6, HopOutputOrder::Sorted);
+    EXPECT_EQ(bytes, 300000 * 45);
+    std::vector<std::string> lines = read_lines();
+    ASSERT_EQ(lines.size(), 300000);
+    EXPECT_TRUE(std::is_sorted(lines.begin(), lines.end()));
+
+    write_hops_text(output_filename, hex_hops, hex_interner, 6);
+    lines = read_lines();
+    ASSERT_EQ(lines.size(), 300000);
+    EXPECT_EQ(lines[7], hex_interner.address(7) + ",6");
+    EXPECT_EQ(lines[299998], hex_interner.address(299998) + "," + std::to_string(299998 % 6));
+}
+
+TEST_F(HopOutputTest, BinaryRoundTrip) {
+    AddressInterner mixed;
+    mixed.intern("0x64a2d48e878e344f948fc76c25368fb9c648a5cc");
+    mixed.intern("address1");
+    mixed.intern("0x22940b6b11430508809f5fa668c02dff724023e4");
+    std::vector<uint8_t> mixed_hops = {2, 0, UNVISITED_HOPS};
+    size_t bytes = write_hops_binary(output_filename, mixed_hops, mixed, 6, HopOutputOrder::Sorted);
+    // Header, two padded 21-byte records, one fallback entry
+    EXPECT_EQ(bytes, 32 + 48 + 4 + 8 + 1);
+
+    AddressInterner loaded;
+    std::vector<uint8_t> loaded_hops;
+    ASSERT_TRUE(read_hops_binary(output_filename, loaded, loaded_hops));
+    ASSERT_EQ(loaded.size(), 3);
+    ASSERT_EQ(loaded_hops.size(), 3);
+    VertexId v;
+    ASSERT_TRUE(loaded.find("0x64a2d48e878e344f948fc76c25368fb9c648a5cc", v));
+    EXPECT_EQ(loaded_hops[v], 2);
+    ASSERT_TRUE(loaded.find("0x22940b6b11430508809f5fa668c02dff724023e4", v));
+    EXPECT_EQ(loaded_hops[v], UNVISITED_HOPS);
+    ASSERT_TRUE(loaded.find("address1", v));
+    EXPECT_EQ(loaded_hops[v], 0);
+}
+
+TEST_F(HopOutputTest, BinaryRejectsWrappingRecordCount) {
+    AddressInterner written;
+    written.intern("0x64a2d48e878e344f948fc76c25368fb9c648a5cc");
+    written.intern("0x22940b6b11430508809f5fa668c02dff724023e4");
+    write_hops_binary(output_filename, {1, 2}, written, 6);
+
+    // 21 times this count wraps around to 24 bytes, which the file does hold
+    std::fstream file(output_filename, std::ios::in | std::ios::out | std::ios::binary);
+    const uint64_t record_count = 0x6db6db6db6db6db8;
+    file.seekp(8);
+    file.write(reinterpret_cast<const char *>(&record_count), sizeof(record_count));
+    file.close();
+
+    AddressInterner loaded;
+    std::vector<uint8_t> loaded_hops;
+    EXPECT_FALSE(read_hops_binary(output_filename, loaded, loaded_hops));
+}
+
+TEST_F(HopOutputTest, PathsText) {
+    std::vector<uint8_t> path_hops;
+    std::vector<VertexId> parents;
+    bfs_with_predecessors(graph, reverse, read_kyc_addr(home_directory + "/econ_project/src/proj23_03_tracebility/cpp/uni_directional_implementation/test_data/test_kyc.csv", interner), 5, path_hops, parents);
+    std::vector<VertexId> targets;
+    for (const std::string address : {"address15", "address6", "address16"}) {
+        VertexId v;
+        ASSERT_TRUE(interner.find(address, v));
+        targets.push_back(v);
+    }
+    write_paths_text(output_filename, targets, path_hops, parents, interner, 6);
+    std::vector<std::string> lines = read_lines();
+    ASSERT_EQ(lines.size(), 4);
+    EXPECT_EQ(lines[0], "address,hops,seed,path");
+    EXPECT_EQ(lines[1], "address15,5,address5,address5>address10>address11>address13>address14>address15");
+    EXPECT_EQ(lines[2], "address6,0,address6,address6");
+    EXPECT_EQ(lines[3], "address16,6,,");
+}
+
+TEST_F(HopOutputTest, ScoresText) {
+    std::vector<double> scores(interner.size(), 0.0);
+    VertexId v;
+    ASSERT_TRUE(interner.find("address15", v));
+    scores[v] = 0.1;
+    write_scores_text(output_filename, scores, interner, HopOutputOrder::Sorted);
+    std::vector<std::string> lines = read_lines();
+    ASSERT_EQ(lines.size(), interner.size() + 1);
+    EXPECT_EQ(lines[0], "address,score");
+    for (size_t i = 1; i < lines.size(); ++i) {
+        const size_t comma = lines[i].find(',');
+        const double score = std::stod(lines[i].substr(comma + 1));
+        EXPECT_EQ(score, lines[i].substr(0, comma) == "address15" ? 0.1 : 0.0) << lines[i];
+    }
+}
+
+TEST_F(HopOutputTest, ReachText) {
+    std::vector<float> reach(interner.size() * 2, 1.0f);
+    VertexId v;
+    ASSERT_TRUE(interner.find("address15", v));
+    reach[v * 2 + 1] = 41.6f;
+    write_reach_text(output_filename, reach, 2, "address,reach_1,reach_2", interner);
+    std::vector<std::string> lines = read_lines();
+    ASSERT_EQ(lines.size(), interner.size() + 1);
+    EXPECT_EQ(lines[0], "address,reach_1,reach_2");
+    EXPECT_EQ(lines[v + 1], "address15,1,42");
+}
@@ -0,0 +1,214 @@
+#include "gtest/gtest.h"
+#include "incremental_bfs.hpp"
+
+class IncrementalBFSTest : public ::testing::Test {
+protected:
+    AddressInterner interner;
+    std::vector<TransferEdge> edges;
+    std::vector<VertexId> seeds;
+    const char *home_dir;
+    std::string home_directory;
+    std::string test_data;
+
+    void SetUp() override {
+        home_dir = getenv("HOME");
+        home_directory = std::string(home_dir);
+        test_data = home_directory + "/econ_project/src/proj23_03_tracebility/cpp/uni_directional_implementation/test_data/";
+
+        load_transfer_chunks({test_data + "test_build_graph3_000000000000"}, interner, edges);
+        seeds = read_kyc_addr(test_data + "test_kyc.csv", interner);
+    }
+
+    // Vertices touched by the first count edges; ids are handed out in order of first appearance
+    size_t vertices_of_prefix(size_t count) const {
+        size_t n = 0;
+        for (size_t e = 0; e < count; ++e) {
+            n = std::max<size_t>(n, std::max(edges[e].src, edges[e].dst) + 1);
+        }
+        return n;
+    }
+
+    static std::vector<uint8_t> full_distances(const CSRGraph &graph, const std::vector<VertexId> &seeds) {
+        std::vector<uint8_t> hops;
+        bfs_direction_optimizing(graph, transpose_csr_graph(graph), seeds, 5, hops);
+        return hops;
+    }
+};
+
+TEST_F(IncrementalBFSTest, AddEdgesMatchesFullBuild) {
+    const CSRGraph full = build_csr_graph(interner.size(), edges);
+    for (size_t split = 0; split <= edges.size(); ++split) {
+        std::vector<TransferEdge> old_edges(edges.begin(), edges.begin() + split);
+        std::vector<TransferEdge> new_edges(edges.begin() + split, edges.end());
+        CSRGraph grown = add_edges_to_csr_graph(build_csr_graph(vertices_of_prefix(split), old_edges), interner.size(), new_edges);
+        EXPECT_EQ(grown.offsets, full.offsets) << "split " << split;
+        EXPECT_EQ(grown.neighbors, full.neighbors) << "split " << split;
+        EXPECT_EQ(grown.weights, full.weights) << "split " << split;
+    }
+}
+
+TEST_F(IncrementalBFSTest, RepeatedPairsAreSummed) {
+    CSRGraph graph = build_csr_graph(2, {{0, 1, 100.0f}});
+    CSRGraph grown = add_edges_to_csr_graph(graph, 3, {{0, 1, 50.0f}, {0, 2, 120.0f}});
+    EXPECT_EQ(grown.offsets, (std::vector<uint64_t>{0, 2, 2, 2}));
+    EXPECT_EQ(grown.neighbors, (std::vector<VertexId>{1, 2}));
+    EXPECT_EQ(grown.weights, (std::vector<float>{150.0f, 120.0f}));
+}
+
+TEST_F(IncrementalBFSTest, UpdateMatchesFullRecompute) {
+    const CSRGraph full = build_csr_graph(interner.size(), edges);
+    const std::vector<uint8_t> expected = full_distances(full, seeds);
+    for (size_t split = 0; split <= edges.size(); ++split) {
+        const size_t old_vertices = vertices_of_prefix(split);
+        CSRGraph old_graph = build_csr_graph(old_vertices, std::vector<TransferEdge>(edges.begin(), edges.begin() + split));
+        // The previous run only knew the seeds that were already in its graph
+        std::vector<VertexId> old_seeds;
+        for (const VertexId seed : seeds) {
+            if (seed < old_vertices) {
+                old_seeds.push_back(seed);
+            }
+        }
+        std::vector<uint8_t> hops = full_distances(old_graph, old_seeds);
+        std::vector<TransferEdge> new_edges(edges.begin() + split, edges.end());
+        update_distances_after_insertions(full, seeds, new_edges, 5, hops);
+        EXPECT_EQ(hops, expected) << "split " << split;
+    }
+}
+
+TEST_F(IncrementalBFSTest, UnaffectedVerticesAreNotVisited) {
+    const CSRGraph full = build_csr_graph(interner.size(), edges);
+    std::vector<uint8_t> hops = full_distances(full, seeds);
+    // Re-adding an existing transfer shortens nothing
+    std::vector<BFSLevelStats> stats = update_distances_after_insertions(full, seeds, {edges.front()}, 5, hops);
+    EXPECT_TRUE(stats.empty());
+    EXPECT_EQ(hops, full_distances(full, seeds));
+}
+
+TEST_F(IncrementalBFSTest, DistanceStateRoundTrip) {
+    const std::string filename = ::testing::TempDir() + "test_graph.distances";
+    const std::vector<std::string> chunk_files = {test_data + "test_build_graph3_000000000000"};
+    DistanceState state{5, fingerprint_chunks(chunk_files), full_distances(build_csr_graph(interner.size(), edges), seeds)};
+    write_distance_state(filename, state);
+    DistanceState loaded;
+    ASSERT_TRUE(read_distance_state(filename, loaded));
+    EXPECT_EQ(loaded.max_hops, 5);
+    EXPECT_EQ(loaded.chunks, state.chunks);
+    EXPECT_EQ(loaded.hops, state.hops);
+
+    // Flip one distance behind the checksum
+    {
+        std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-1, std::ios::end);
+        file.put('\x7f');
+    }
+    EXPECT_FALSE(read_distance_state(filename, loaded));
+    std::remove(filename.c_str());
+}
+
+TEST_F(IncrementalBFSTest, FindNewChunks) {
+    const std::vector<ChunkFingerprint> current = fingerprint_chunks(find_chunk_files(test_data + "test_build_graph2_"));
+    ASSERT_EQ(current.size(), 2);
+    std::vector<std::string> new_chunk_files;
+    ASSERT_TRUE(find_new_chunks({current[0]}, current, new_chunk_files));
+    EXPECT_EQ(new_chunk_files, std::vector<std::string>{current[1].filename});
+
+    // A rewritten chunk needs a full run
+    ChunkFingerprint changed = current[0];
+    changed.size += 1;
+    EXPECT_FALSE(find_new_chunks({changed}, current, new_chunk_files));
+}
+
+TEST_F(IncrementalBFSTest, SeedDeltaMatchesFullRecompute) {
+    const CSRGraph full = build_csr_graph(interner.size(), edges);
+    const CSRGraph reverse = transpose_csr_graph(full);
+    const std::vector<uint8_t> baseline = full_distances(full, seeds);
+    const VertexId n = static_cast<VertexId>(interner.size());
+    // Every single removal, every single addition, and removing all seeds while adding two others
+    std::vector<std::pair<std::vector<VertexId>, std::vector<VertexId>>> deltas;
+    for (const VertexId seed : seeds) {
+        deltas.push_back({{}, {seed}});
+    }
+    for (VertexId v = 0; v < n; ++v) {
+        deltas.push_back({{v}, {}});
+    }
+    deltas.push_back({{0, n - 1}, seeds});
+
+    for (const auto &delta : deltas) {
+        std::vector<VertexId> new_seeds;
+        for (const VertexId seed : seeds) {
+            if (std::find(delta.second.begin(), delta.second.end(), seed) == delta.second.end()) {
+                new_seeds.push_back(seed);
+            }
+        }
+        new_seeds.insert(new_seeds.end(), delta.first.begin(), delta.first.end());
+        const std::vector<uint8_t> expected = full_distances(full, new_seeds);
+
+        std::vector<HopChange> expected_changes;
+        for (VertexId v = 0; v < n; ++v) {
+            if (baseline[v] != expected[v]) {
+                expected_changes.push_back({v, baseline[v], expected[v]});
+            }
+        }
+
+        // alpha 1 repairs in place, a huge alpha always falls back to the full BFS
+        for (int alpha : {1, 1 << 30}) {
+            std::vector<uint8_t> hops = baseline;
+            std::vector<HopChange> changes = apply_seed_delta(full, reverse, delta.first, delta.second, 5, hops, alpha);
+            EXPECT_EQ(hops, expected) << "alpha " << alpha;
+            ASSERT_EQ(changes.size(), expected_changes.size()) << "alpha " << alpha;
+            for (size_t i = 0; i < changes.size(); ++i) {
+                EXPECT_EQ(changes[i].vertex, expected_changes[i].vertex);
+                EXPECT_EQ(changes[i].old_hops, expected_changes[i].old_hops);
+                EXPECT_EQ(changes[i].new_hops, expected_changes[i].new_hops);
+            }
+        }
+    }
+}
+
+TEST_F(IncrementalBFSTest, RemovedAndReaddedSeedChangesNothing) {
+    const CSRGraph full = build_csr_graph(interner.size(), edges);
+    std::vector<uint8_t> hops = full_distances(full, seeds);
+    const std::vector<uint8_t> baseline = hops;
+    EXPECT_TRUE(apply_seed_delta(full, transpose_csr_graph(full), {seeds.front()}, {seeds.front()}, 5, hops, 1).empty());
+    EXPECT_EQ(hops, baseline);
+}
+
+TEST_F(IncrementalBFSTest, CutoffDatesMatchFullBFSPerWindow) {
+    AddressInterner dated_interner;
+    std::vector<TransferEdge> dated_edges;
+    const std::string test_data = home_directory + "/econ_project/src/proj23_03_tracebility/cpp/uni_directional_implementation/test_data/";
+    load_transfer_chunks({test_data + "test_build_graph4_000000000000"}, dated_interner, dated_edges);
+    const std::vector<VertexId> dated_seeds = read_kyc_addr(test_data + "test_kyc.csv", dated_interner);
+    std::vector<uint32_t> first_seen;
+    const CSRGraph graph = build_dated_csr_graph(dated_interner.size(), dated_edges, first_seen);
+
+    // Before any dated transfer, every date in the file, a day in between and after the last one
+    std::vector<uint32_t> cutoffs = {19000};
+    for (const TransferEdge &edge : dated_edges) {
+        cutoffs.push_back(edge.first_seen);
+    }
+    cutoffs.push_back(19745);
+    cutoffs.push_back(20000);
+    std::sort(cutoffs.begin(), cutoffs.end());
+    cutoffs.erase(std::unique(cutoffs.begin(), cutoffs.end()), cutoffs.end());
+
+    std::vector<uint8_t> hops;
+    std::vector<std::vector<BFSLevelStats>> stats = bfs_by_cutoff_dates(graph, first_seen, dated_seeds, cutoffs, 5, hops);
+    ASSERT_EQ(stats.size(), cutoffs.size());
+    ASSERT_EQ(hops.size(), dated_interner.size() * cutoffs.size());
+    for (size_t c = 0; c < cutoffs.size(); ++c) {
+        std::vector<TransferEdge> window;
+        for (const TransferEdge &edge : dated_edges) {
+            if (edge.first_seen <= cutoffs[c]) {
+                window.push_back(edge);
+            }
+        }
+        const std::vector<uint8_t> expected = full_distances(build_csr_graph(dated_interner.size(), window), dated_seeds);
+        for (VertexId v = 0; v < dated_interner.size(); ++v) {
+            EXPECT_EQ(hops[v * cutoffs.size() + c], expected[v]) << format_date(cutoffs[c]) << " " << dated_interner.address(v);
+        }
+    }
+
+    std::reverse(cutoffs.begin(), cutoffs.end());
+    EXPECT_THROW(bfs_by_cutoff_dates(graph, first_seen, dated_seeds, cutoffs, 5, hops), std::invalid_argument);
+}
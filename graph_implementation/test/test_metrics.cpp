@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+#include "metrics.hpp"
+#include "chunk_loader.hpp"
+
+#ifdef EAI_METRICS
+
+class MetricsTest : public ::testing::Test {
+protected:
+    Graph graph;
+    CSRGraph csr, reverse;
+    std::unordered_map<std::string, Vertex> address_to_vertex;
+    std::vector<VertexId> seeds;
+    const char *home_dir;
+    std::string home_directory;
+
+    void SetUp() override {
+        home_dir = getenv("HOME");
+        home_directory = std::string(home_dir);
+        std::string test_data = home_directory + "/econ_project/src/proj23_03_tracebility/cpp/uni_directional_implementation/test_data/";
+
+        build_graph_from_chunks(test_data + "test_build_graph3_", 1, graph, address_to_vertex);
+        csr = build_csr_graph(graph);
+        reverse = transpose_csr_graph(csr);
+        for (Vertex v : read_kyc_addr(test_data + "test_kyc.csv", address_to_vertex)) {
+            seeds.push_back(static_cast<VertexId>(v));
+        }
+        metrics_begin_run("test_run");
+    }
+};
+
+TEST_F(MetricsTest, PhasesAndCountersInReport) {
+    {
+        PhaseTimer phase("ingest");
+        phase.add_bytes_read(1234);
+        phase.set_counter("edges", static_cast<double>(num_edges(csr)));
+        phase.set_counter("edges", 7);
+    }
+    PhaseTimer output("output");
+    output.stop();
+    output.stop();
+
+    const std::string json = metrics_json();
+    EXPECT_NE(json.find("\"run\": \"test_run\""), std::string::npos);
+    EXPECT_NE(json.find("{\"name\": \"ingest\""), std::string::npos);
+    EXPECT_NE(json.find("\"bytes_read\": 1234"), std::string::npos);
+    // A repeated counter keeps its last value
+    EXPECT_NE(json.find("\"counters\": {\"edges\": 7}"), std::string::npos);
+    // Stopping twice records the phase once
+    const size_t first_output = json.find("{\"name\": \"output\"");
+    ASSERT_NE(first_output, std::string::npos);
+    EXPECT_EQ(json.find("{\"name\": \"output\"", first_output + 1), std::string::npos);
+}
+
+TEST_F(MetricsTest, BFSLevelsAndTEPS) {
+    std::vector<uint8_t> hops;
+    std::vector<BFSLevelStats> stats = bfs_direction_optimizing(csr, reverse, seeds, 5, hops);
+    size_t edges_scanned = 0;
+    for (const BFSLevelStats &level : stats) {
+        edges_scanned += level.edges_scanned;
+    }
+    EXPECT_GT(edges_scanned, 0);
+    record_bfs_levels("kyc", stats);
+
+    const std::string json = metrics_json();
+    EXPECT_NE(json.find("{\"name\": \"kyc\", \"levels\": ["), std::string::npos);
+    // The fixture is small enough that the BFS starts bottom-up
+    EXPECT_NE(json.find("{\"level\": 0, \"direction\": \"bottom-up\""), std::string::npos);
+    EXPECT_NE(json.find("\"edges_scanned\": " + std::to_string(edges_scanned) + ", \"seconds\""), std::string::npos);
+    EXPECT_NE(json.find("\"teps\": "), std::string::npos);
+}
+
+TEST_F(MetricsTest, BeginRunClearsReport) {
+    record_bfs_levels("old", {});
+    metrics_begin_run("second_run");
+    const std::string json = metrics_json();
+    EXPECT_EQ(json.find("\"old\""), std::string::npos);
+    EXPECT_NE(json.find("\"phases\": []"), std::string::npos);
+}
+
+TEST_F(MetricsTest, WritesReportFile) {
+    std::string filename = ::testing::TempDir() + "metrics_report.json";
+    {
+        PhaseTimer phase("bfs");
+    }
+    ASSERT_TRUE(write_metrics_report(filename));
+    std::ifstream input(filename);
+    std::stringstream content;
+    content << input.rdbuf();
+    EXPECT_EQ(content.str().find("{\n  \"run\": \"test_run\""), 0);
+    EXPECT_NE(content.str().find("{\"name\": \"bfs\""), std::string::npos);
+    std::remove(filename.c_str());
+}
+
+#endif // EAI_METRICS
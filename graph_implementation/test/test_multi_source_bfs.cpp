@@ -0,0 +1,121 @@
+#include "gtest/gtest.h"
+#include "multi_source_bfs.hpp"
+#include "chunk_loader.hpp"
+
+class MultiSourceBFSTest : public ::testing::Test {
+protected:
+    CSRGraph graph, reverse;
+    AddressInterner interner;
+    std::vector<SeedGroup> groups;
+    std::string seed_filename;
+    const char *home_dir;
+    std::string home_directory;
+
+    void SetUp() override {
+        // Initialize home_directory.
+        home_dir = getenv("HOME");
+        home_directory = std::string(home_dir);
+        std::string test_data = home_directory + "/econ_project/src/proj23_03_tracebility/cpp/uni_directional_implementation/test_data/";
+
+        build_graph_from_chunks(find_chunk_files(test_data + "test_build_graph3_"), graph, interner);
+        reverse = transpose_csr_graph(graph);
+
+        groups.push_back(SeedGroup{"kyc", read_kyc_addr(test_data + "test_kyc.csv", interner)});
+        groups.push_back(SeedGroup{"a1", {id_of("address1")}});
+        groups.push_back(SeedGroup{"a13", {id_of("address13")}});
+        // Overlaps with the other groups
+        groups.push_back(SeedGroup{"mixed", {id_of("address1"), id_of("address10")}});
+        groups.push_back(SeedGroup{"empty", {}});
+
+        seed_filename = ::testing::TempDir() + "test_seed_groups.csv";
+    }
+
+    void TearDown() override {
+        std::remove(seed_filename.c_str());
+    }
+
+    VertexId id_of(const std::string &address) {
+        VertexId id = 0;
+        EXPECT_TRUE(interner.find(address, id)) << address;
+        return id;
+    }
+
+    // Every column must match an independent single-source-set BFS
+    void expect_matches_single_group_bfs(const std::vector<uint8_t> &hops) {
+        const size_t n = num_vertices(graph);
+        ASSERT_EQ(hops.size(), n * groups.size());
+        for (size_t g = 0; g < groups.size(); ++g) {
+            std::vector<uint8_t> expected;
+            bfs_direction_optimizing(graph, reverse, groups[g].seeds, 5, expected);
+            for (size_t v = 0; v < n; ++v) {
+                EXPECT_EQ(hops[v * groups.size() + g], expected[v]) << "group " << groups[g].label << ", " << interner.address(v);
+            }
+        }
+    }
+};
+
+TEST_F(MultiSourceBFSTest, PushOnly) {
+    std::vector<uint8_t> hops;
+    // alpha = 1 never switches to pulling on this graph
+    auto stats = multi_source_bfs(graph, reverse, groups, 5, hops, 1);
+    for (const auto &level : stats) {
+        EXPECT_FALSE(level.bottom_up);
+    }
+    expect_matches_single_group_bfs(hops);
+}
+
+TEST_F(MultiSourceBFSTest, PullOnly) {
+    std::vector<uint8_t> hops;
+    auto stats = multi_source_bfs(graph, reverse, groups, 5, hops, 1 << 30);
+    for (const auto &level : stats) {
+        EXPECT_TRUE(level.bottom_up);
+    }
+    expect_matches_single_group_bfs(hops);
+}
+
+TEST_F(MultiSourceBFSTest, DefaultSwitching) {
+    std::vector<uint8_t> hops;
+    multi_source_bfs(graph, reverse, groups, 5, hops);
+    expect_matches_single_group_bfs(hops);
+    EXPECT_EQ(hops[id_of("address15") * groups.size() + 2], 2);
+    EXPECT_EQ(hops[id_of("address2") * groups.size() + 1], 1);
+}
+
+TEST_F(MultiSourceBFSTest, SixtyFourGroups) {
+    groups.clear();
+    for (VertexId v = 0; v < 64; ++v) {
+        groups.push_back(SeedGroup{std::to_string(v), {static_cast<VertexId>(v % num_vertices(graph))}});
+    }
+    std::vector<uint8_t> hops;
+    multi_source_bfs(graph, reverse, groups, 5, hops);
+    expect_matches_single_group_bfs(hops);
+
+    groups.push_back(SeedGroup{"64", {}});
+    EXPECT_THROW(multi_source_bfs(graph, reverse, groups, 5, hops), std::runtime_error);
+}
+
+TEST_F(MultiSourceBFSTest, ReadSeedGroups) {
+    std::ofstream seed_file(seed_filename);
+    seed_file << "address,label\n"
+              << "address1,hacker\n"
+              << "address13,exchange\r\n"
+              << "address_not_in_graph,exchange\n"
+              << "address2\n"
+              << "address15,hacker\n";
+    seed_file.close();
+
+    std::vector<SeedGroup> read_groups;
+    read_seed_groups(seed_filename, interner, "unlabelled", read_groups);
+    ASSERT_EQ(read_groups.size(), 3);
+    EXPECT_EQ(read_groups[0].label, "hacker");
+    EXPECT_EQ(read_groups[0].seeds, std::vector<VertexId>({id_of("address1"), id_of("address15")}));
+    EXPECT_EQ(read_groups[1].label, "exchange");
+    EXPECT_EQ(read_groups[1].seeds, std::vector<VertexId>({id_of("address13")}));
+    EXPECT_EQ(read_groups[2].label, "unlabelled");
+    EXPECT_EQ(read_groups[2].seeds, std::vector<VertexId>({id_of("address2")}));
+
+    // A second file extends the groups it shares labels with
+    read_seed_groups(seed_filename, interner, "unlabelled", read_groups);
+    EXPECT_EQ(read_groups.size(), 3);
+    EXPECT_EQ(read_groups[0].seeds.size(), 4);
+}
@@ -0,0 +1,120 @@
+#include "gtest/gtest.h"
+#include "neighborhood_sketch.hpp"
+#include "chunk_loader.hpp"
+#include <random>
+
+class NeighborhoodSketchTest : public ::testing::Test {
+protected:
+    CSRGraph graph, reverse;
+    AddressInterner interner;
+    const char *home_dir;
+    std::string home_directory;
+
+    void SetUp() override {
+        home_dir = getenv("HOME");
+        home_directory = std::string(home_dir);
+        std::string test_data = home_directory + "/econ_project/src/proj23_03_tracebility/cpp/uni_directional_implementation/test_data/";
+
+        build_graph_from_chunks(find_chunk_files(test_data + "test_build_graph3_"), graph, reverse, interner);
+    }
+
+    // Exact k-hop ball sizes by one BFS per vertex
+    static std::vector<size_t> exact_ball_sizes(const CSRGraph &graph, int max_hops) {
+        const size_t n = num_vertices(graph);
+        std::vector<size_t> sizes(n * max_hops);
+        for (VertexId source = 0; source < n; ++source) {
+            std::vector<int> hops(n, -1);
+            std::vector<VertexId> frontier = {source};
+            hops[source] = 0;
+            size_t reached = 1;
+            for (int k = 1; k <= max_hops; ++k) {
+                std::vector<VertexId> next;
+                for (const VertexId v : frontier) {
+                    for (uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+                        if (hops[graph.neighbors[e]] < 0) {
+                            hops[graph.neighbors[e]] = k;
+                            next.push_back(graph.neighbors[e]);
+                        }
+                    }
+                }
+                reached += next.size();
+                sizes[source * max_hops + k - 1] = reached;
+                frontier.swap(next);
+            }
+        }
+        return sizes;
+    }
+
+    static CSRGraph random_graph(size_t n, size_t m) {
+        std::mt19937_64 rng(3);
+        std::vector<TransferEdge> edges;
+        for (size_t e = 0; e < m; ++e) {
+            edges.push_back({static_cast<VertexId>(rng() % n), static_cast<VertexId>(rng() % n), 100.0f});
+        }
+        return build_csr_graph(n, edges);
+    }
+};
+
+TEST_F(NeighborhoodSketchTest, SmallBallsAreExact) {
+    // A few addresses per ball against 1024 registers: the linear counting range, almost no collisions
+    for (const CSRGraph *direction : {&graph, &reverse}) {
+        std::vector<float> reach;
+        neighborhood_sizes(*direction, 5, 10, reach);
+        const std::vector<size_t> expected = exact_ball_sizes(*direction, 5);
+        ASSERT_EQ(reach.size(), expected.size());
+        for (size_t i = 0; i < reach.size(); ++i) {
+            EXPECT_NEAR(reach[i], expected[i], 0.5) << "vertex " << i / 5 << " hops " << i % 5 + 1;
+        }
+    }
+}
+
+TEST_F(NeighborhoodSketchTest, RandomGraphWithinStandardError) {
+    // Four transfers per address, so the 5-hop balls reach the HyperLogLog range
+    const CSRGraph random = random_graph(3000, 12000);
+    const std::vector<size_t> expected = exact_ball_sizes(random, 5);
+    // 256 registers: about 6.5% standard error
+    std::vector<float> reach;
+    neighborhood_sizes(random, 5, 8, reach);
+    double total_error = 0.0, worst_large_error = 0.0;
+    for (size_t i = 0; i < reach.size(); ++i) {
+        const double error = std::fabs(reach[i] - expected[i]) / expected[i];
+        total_error += error;
+        // Two addresses sharing a register throw a tiny ball off by one, so the worst case is only checked on large ones
+        if (expected[i] >= 100) {
+            worst_large_error = std::max(worst_large_error, error);
+        }
+    }
+    EXPECT_LT(total_error / reach.size(), 0.06);
+    EXPECT_LT(worst_large_error, 0.3);
+    // Balls only grow with k
+    for (size_t v = 0; v < num_vertices(random); ++v) {
+        for (int k = 1; k < 5; ++k) {
+            EXPECT_LE(reach[v * 5 + k - 1], reach[v * 5 + k]);
+        }
+    }
+}
+
+TEST_F(NeighborhoodSketchTest, StopsOnceNoCounterGrows) {
+    // A path 0 -> 1 -> 2: the counter of 0 still grows in the second iteration, none in the third
+    const CSRGraph path = build_csr_graph(3, {{0, 1, 100.0f}, {1, 2, 100.0f}});
+    std::vector<float> reach;
+    std::vector<SketchIterationStats> stats = neighborhood_sizes(path, 5, 8, reach);
+    ASSERT_EQ(stats.size(), 3);
+    EXPECT_EQ(stats[0].changed, 2);
+    EXPECT_EQ(stats[1].changed, 1);
+    EXPECT_EQ(stats[2].changed, 0);
+    ASSERT_EQ(reach.size(), 15);
+    EXPECT_NEAR(reach[4], 3.0, 0.05);
+    EXPECT_NEAR(reach[5 + 4], 2.0, 0.05);
+    EXPECT_NEAR(reach[10 + 4], 1.0, 0.05);
+}
+
+TEST_F(NeighborhoodSketchTest, PrecisionFitsMemory) {
+    EXPECT_EQ(sketch_memory_bytes(1000, 6), 128000);
+    EXPECT_EQ(sketch_precision_for_memory(1000, 128000, 10), 6);
+    EXPECT_EQ(sketch_precision_for_memory(1000, 127999, 10), 5);
+    EXPECT_EQ(sketch_precision_for_memory(1000, uint64_t(1) << 40, 10), 10);
+    EXPECT_EQ(sketch_precision_for_memory(1000, 0, 10), MIN_SKETCH_PRECISION);
+    std::vector<float> reach;
+    EXPECT_THROW(neighborhood_sizes(graph, 5, MAX_SKETCH_PRECISION + 1, reach), std::invalid_argument);
+}
@@ -0,0 +1,210 @@
+#include "gtest/gtest.h"
+#include "parallel_bfs.hpp"
+#include "chunk_loader.hpp"
+
+class DirectionOptimizingBFSTest : public ::testing::Test {
+protected:
+    Graph graph;
+    CSRGraph csr, reverse;
+    std::unordered_map<std::string, Vertex> address_to_vertex;
+    std::vector<VertexId> seeds;
+    const char *home_dir;
+    std::string home_directory;
+
+    void SetUp() override {
+        // Initialize home_directory.
+        home_dir = getenv("HOME");
+        home_directory = std::string(home_dir);
+        std::string test_data = home_directory + "/econ_project/src/proj23_03_tracebility/cpp/uni_directional_implementation/test_data/";
+
+        build_graph_from_chunks(test_data + "test_build_graph3_", 1, graph, address_to_vertex);
+        csr = build_csr_graph(graph);
+        reverse = transpose_csr_graph(csr);
+        for (Vertex v : read_kyc_addr(test_data + "test_kyc.csv", address_to_vertex)) {
+            seeds.push_back(static_cast<VertexId>(v));
+        }
+    }
+
+    uint8_t hops_of(const std::vector<uint8_t> &hops, const std::string &address) {
+        return hops[address_to_vertex[address]];
+    }
+
+    void expect_fixture_levels(const std::vector<uint8_t> &hops) {
+        EXPECT_EQ(hops_of(hops, "address2"), 0);
+        EXPECT_EQ(hops_of(hops, "address6"), 0);
+        EXPECT_EQ(hops_of(hops, "address9"), 1);
+        EXPECT_EQ(hops_of(hops, "address10"), 1);
+        EXPECT_EQ(hops_of(hops, "address12"), 2);
+        EXPECT_EQ(hops_of(hops, "address13"), 3);
+        EXPECT_EQ(hops_of(hops, "address14"), 4);
+        EXPECT_EQ(hops_of(hops, "address15"), 5);
+        EXPECT_EQ(hops_of(hops, "address1"), UNVISITED_HOPS);
+        EXPECT_EQ(hops_of(hops, "address16"), UNVISITED_HOPS);
+    }
+};
+
+TEST_F(DirectionOptimizingBFSTest, TopDownOnly) {
+    std::vector<uint8_t> hops;
+    // alpha = 1 never switches to bottom-up on this graph
+    auto stats = bfs_direction_optimizing(csr, reverse, seeds, 5, hops, 1, 18);
+    for (const auto &level : stats) {
+        EXPECT_FALSE(level.bottom_up);
+    }
+    expect_fixture_levels(hops);
+}
+
+TEST_F(DirectionOptimizingBFSTest, BottomUpOnly) {
+    std::vector<uint8_t> hops;
+    // A huge alpha switches to bottom-up on the first level, a tiny beta never switches back
+    auto stats = bfs_direction_optimizing(csr, reverse, seeds, 5, hops, 1 << 30, 1 << 30);
+    ASSERT_EQ(stats.size(), 5);
+    for (const auto &level : stats) {
+        EXPECT_TRUE(level.bottom_up);
+    }
+    expect_fixture_levels(hops);
+}
+
+TEST_F(DirectionOptimizingBFSTest, LevelStats) {
+    std::vector<uint8_t> hops;
+    auto stats = bfs_direction_optimizing(csr, reverse, seeds, 5, hops);
+    ASSERT_EQ(stats.size(), 5);
+    EXPECT_EQ(stats[0].frontier_size, 3);
+    EXPECT_EQ(stats[0].discovered, 4);
+    EXPECT_EQ(stats[1].frontier_size, 4);
+    EXPECT_EQ(stats[4].discovered, 1);
+}
+
+TEST_F(DirectionOptimizingBFSTest, ForwardAndBackward) {
+    std::vector<uint8_t> hops = bfs_forward_backward(csr, reverse, seeds, 5);
+    ASSERT_EQ(hops.size(), 2 * num_vertices(csr));
+    std::vector<uint8_t> forward, backward;
+    bfs_direction_optimizing(csr, reverse, seeds, 5, forward);
+    for (size_t v = 0; v < num_vertices(csr); ++v) {
+        EXPECT_EQ(hops[2 * v], forward[v]);
+    }
+    std::vector<uint8_t> backward_hops(num_vertices(csr));
+    for (size_t v = 0; v < num_vertices(csr); ++v) {
+        backward_hops[v] = hops[2 * v + 1];
+    }
+    // address1 sends to the seed address2, address5 sends to the seed address6
+    EXPECT_EQ(hops_of(backward_hops, "address1"), 1);
+    EXPECT_EQ(hops_of(backward_hops, "address5"), 0);
+    EXPECT_EQ(hops_of(backward_hops, "address6"), 0);
+    EXPECT_EQ(hops_of(backward_hops, "address9"), UNVISITED_HOPS);
+    EXPECT_EQ(hops_of(backward_hops, "address15"), UNVISITED_HOPS);
+}
+
+TEST_F(DirectionOptimizingBFSTest, PredecessorsFormShortestPaths) {
+    // Top-down only, bottom-up only and the default switching
+    for (const std::pair<int, int> &alpha_beta : {std::make_pair(1, 18), std::make_pair(1 << 30, 1 << 30), std::make_pair(15, 18)}) {
+        std::vector<uint8_t> hops;
+        std::vector<VertexId> parents;
+        bfs_with_predecessors(csr, reverse, seeds, 5, hops, parents, alpha_beta.first, alpha_beta.second);
+        expect_fixture_levels(hops);
+        ASSERT_EQ(parents.size(), num_vertices(csr));
+        for (VertexId v = 0; v < num_vertices(csr); ++v) {
+            if (hops[v] == UNVISITED_HOPS) {
+                EXPECT_EQ(parents[v], NO_PREDECESSOR);
+                EXPECT_TRUE(trace_path(v, parents).empty());
+                continue;
+            }
+            std::vector<VertexId> path = trace_path(v, parents);
+            ASSERT_EQ(path.size(), hops[v] + 1u);
+            EXPECT_EQ(hops[path.front()], 0);
+            EXPECT_EQ(path.back(), v);
+            // Every step is an edge of the graph
+            for (size_t i = 0; i + 1 < path.size(); ++i) {
+                auto begin = csr.neighbors.begin() + csr.offsets[path[i]];
+                auto end = csr.neighbors.begin() + csr.offsets[path[i] + 1];
+                EXPECT_NE(std::find(begin, end, path[i + 1]), end);
+            }
+        }
+    }
+}
+
+TEST_F(DirectionOptimizingBFSTest, TracePathBatch) {
+    std::vector<uint8_t> hops;
+    std::vector<VertexId> parents;
+    bfs_with_predecessors(csr, reverse, seeds, 5, hops, parents);
+    std::vector<VertexId> targets;
+    for (VertexId v = 0; v < num_vertices(csr); ++v) {
+        targets.push_back(v);
+    }
+    targets.push_back(static_cast<VertexId>(num_vertices(csr) + 10));
+    std::vector<std::vector<VertexId>> paths = trace_paths(targets, parents);
+    ASSERT_EQ(paths.size(), targets.size());
+    for (size_t i = 0; i < targets.size(); ++i) {
+        EXPECT_EQ(paths[i], trace_path(targets[i], parents));
+    }
+    EXPECT_TRUE(paths.back().empty());
+    std::vector<VertexId> path = trace_path(address_to_vertex["address13"], parents);
+    std::vector<VertexId> expected = {static_cast<VertexId>(address_to_vertex["address5"]), static_cast<VertexId>(address_to_vertex["address10"]), static_cast<VertexId>(address_to_vertex["address11"]), static_cast<VertexId>(address_to_vertex["address13"])};
+    EXPECT_EQ(path, expected);
+}
+
+class WeightThresholdBFSTest : public ::testing::Test {
+protected:
+    CSRGraph graph, reverse;
+    AddressInterner interner;
+    std::vector<VertexId> seeds;
+
+    void SetUp() override {
+        std::string base = ::testing::TempDir() + "threshold_chunk_";
+        {
+            std::ofstream chunk(base + "000000000000");
+            chunk << "address1,address2,total_transfer_usd\n"
+                  << "s,a,1000\n"
+                  << "a,b,50\n"
+                  << "s,c,20\n"
+                  << "c,b,500\n"
+                  << "b,d,150\n";
+        }
+        build_graph_from_chunks(find_chunk_files(base), graph, interner);
+        std::remove((base + "000000000000").c_str());
+        reverse = transpose_csr_graph(graph);
+        seeds.push_back(id_of("s"));
+    }
+
+    VertexId id_of(const std::string &address) {
+        VertexId id = 0;
+        EXPECT_TRUE(interner.find(address, id)) << address;
+        return id;
+    }
+};
+
+TEST_F(WeightThresholdBFSTest, ThresholdIsPrefix) {
+    for (const int alpha : {1, 1 << 30}) {
+        std::vector<uint8_t> hops;
+        bfs_direction_optimizing(graph, reverse, seeds, 5, hops, alpha, 18, 30.0f);
+        EXPECT_EQ(hops[id_of("a")], 1);
+        EXPECT_EQ(hops[id_of("b")], 2);
+        EXPECT_EQ(hops[id_of("c")], UNVISITED_HOPS);
+        EXPECT_EQ(hops[id_of("d")], 3);
+
+        bfs_direction_optimizing(graph, reverse, seeds, 5, hops, alpha, 18, 100.0f);
+        EXPECT_EQ(hops[id_of("a")], 1);
+        EXPECT_EQ(hops[id_of("b")], UNVISITED_HOPS);
+        EXPECT_EQ(hops[id_of("d")], UNVISITED_HOPS);
+    }
+}
+
+TEST_F(WeightThresholdBFSTest, MultipleThresholds) {
+    const std::vector<float> thresholds = {10.0f, 30.0f, 100.0f, 5000.0f};
+    std::vector<uint8_t> columns = bfs_weight_thresholds(graph, reverse, seeds, thresholds, 5);
+    ASSERT_EQ(columns.size(), num_vertices(graph) * thresholds.size());
+    for (size_t t = 0; t < thresholds.size(); ++t) {
+        std::vector<uint8_t> hops;
+        bfs_direction_optimizing(graph, reverse, seeds, 5, hops, 15, 18, thresholds[t]);
+        for (size_t v = 0; v < num_vertices(graph); ++v) {
+            EXPECT_EQ(columns[v * thresholds.size() + t], hops[v]);
+        }
+    }
+    // The load filter is 10 USD, so the lowest threshold is today's result
+    std::vector<uint8_t> unfiltered;
+    bfs_direction_optimizing(graph, reverse, seeds, 5, unfiltered);
+    for (size_t v = 0; v < num_vertices(graph); ++v) {
+        EXPECT_EQ(columns[v * thresholds.size()], unfiltered[v]);
+    }
+    EXPECT_EQ(columns[id_of("b") * thresholds.size()], 2);
+    EXPECT_EQ(columns[id_of("a") * thresholds.size() + 3], UNVISITED_HOPS);
+}
@@ -0,0 +1,108 @@
+#include "gtest/gtest.h"
+#include "query_server.hpp"
+#include "query_client.hpp"
+#include "chunk_loader.hpp"
+
+class QueryServerTest : public ::testing::Test {
+protected:
+    CSRGraph graph, reverse;
+    AddressInterner interner;
+    std::unique_ptr<QueryEngine> engine;
+    const char *home_dir;
+    std::string home_directory;
+
+    void SetUp() override {
+        // Initialize home_directory.
+        home_dir = getenv("HOME");
+        home_directory = std::string(home_dir);
+        std::string test_data = home_directory + "/econ_project/src/proj23_03_tracebility/cpp/uni_directional_implementation/test_data/";
+
+        build_graph_from_chunks(find_chunk_files(test_data + "test_build_graph3_"), graph, reverse, interner);
+        engine.reset(new QueryEngine(graph, reverse, interner, read_kyc_addr(test_data + "test_kyc.csv", interner), 5));
+    }
+};
+
+TEST_F(QueryServerTest, HopsLookup) {
+    EXPECT_EQ(engine->handle("HOPS address15 address6 address16 no_such_address"),
+              "OK 4\n"
+              "address15,5,address5\n"
+              "address6,0,address6\n"
+              "address16,6,\n"
+              "no_such_address,,\n");
+    EXPECT_EQ(engine->handle("HOPS"), "OK 0\n");
+}
+
+TEST_F(QueryServerTest, PathLookup) {
+    EXPECT_EQ(engine->handle("PATH address12 address1"),
+              "OK 2\n"
+              "address12,2,address5,address5>address10>address12\n"
+              "address1,6,,\n");
+}
+
+TEST_F(QueryServerTest, CustomBFS) {
+    EXPECT_EQ(engine->handle("BFS 2 address1 address2 address9 address6"),
+              "OK 3\n"
+              "address2,1\n"
+              "address9,2\n"
+              "address6,3\n");
+    // Level sizes without target addresses: address1 reaches address2, 3, 4 and then address9
+    EXPECT_EQ(engine->handle("BFS 3 address1,unknown"),
+              "OK 4\n"
+              "0,1\n"
+              "1,3\n"
+              "2,1\n"
+              "3,0\n");
+    EXPECT_EQ(engine->handle("BFS x address1").compare(0, 4, "ERR "), 0);
+    EXPECT_EQ(engine->handle("BFS 500 address1").compare(0, 4, "ERR "), 0);
+    EXPECT_EQ(engine->handle("DROP TABLE").compare(0, 4, "ERR "), 0);
+    EXPECT_EQ(engine->handle("STATS"), "OK 1\n18,16,3,5\n");
+}
+
+TEST_F(QueryServerTest, EndpointParsing) {
+    Endpoint endpoint;
+    ASSERT_TRUE(parse_endpoint("unix:/tmp/eai.sock", endpoint));
+    EXPECT_TRUE(endpoint.is_unix);
+    EXPECT_EQ(endpoint.path, "/tmp/eai.sock");
+    ASSERT_TRUE(parse_endpoint("tcp:7070", endpoint));
+    EXPECT_FALSE(endpoint.is_unix);
+    EXPECT_EQ(endpoint.port, 7070);
+    EXPECT_FALSE(parse_endpoint("tcp:70000", endpoint));
+    EXPECT_FALSE(parse_endpoint("tcp:", endpoint));
+    EXPECT_FALSE(parse_endpoint("http://localhost", endpoint));
+}
+
+TEST_F(QueryServerTest, ConcurrentClientsOverUnixSocket) {
+    const std::string endpoint = "unix:" + ::testing::TempDir() + "test_query_server.sock";
+    QueryServer server(*engine);
+    ASSERT_TRUE(server.listen(endpoint));
+    std::thread serving(&QueryServer::serve, &server);
+
+    QueryClient client;
+    ASSERT_TRUE(client.connect(endpoint));
+    std::vector<std::string> response;
+    std::string error;
+    ASSERT_TRUE(client.request("HOPS address13 address9", response, error));
+    EXPECT_EQ(response, (std::vector<std::string>{"address13,3,address5", "address9,1,address6"}));
+    EXPECT_FALSE(client.request("NOPE", response, error));
+    EXPECT_EQ(error, "unknown command NOPE");
+    // The connection stays usable after an error
+    ASSERT_TRUE(client.request("STATS", response, error));
+    EXPECT_EQ(response.size(), 1);
+
+    LoadReport report = generate_load(endpoint, {"HOPS address15 address12", "PATH address14", "BFS 3 address1 address9"}, 4, 50);
+    EXPECT_EQ(report.requests, 200);
+    EXPECT_EQ(report.errors, 0);
+    EXPECT_GT(report.queries_per_second, 0.0);
+    EXPECT_LE(report.p50_ms, report.p99_ms);
+    EXPECT_LE(report.p99_ms, report.max_ms);
+
+    // The load clients have hung up; their threads are joined within a few accept polls, leaving only client's
+    for (int poll = 0; poll < 50 && server.num_connections() > 1; ++poll) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    EXPECT_EQ(server.num_connections(), 1);
+
+    client.disconnect();
+    server.stop();
+    serving.join();
+}
@@ -0,0 +1,105 @@
+#include "gtest/gtest.h"
+#include "risk_propagation.hpp"
+#include "chunk_loader.hpp"
+
+class RiskPropagationTest : public ::testing::Test {
+protected:
+    AddressInterner interner;
+    std::vector<TransferEdge> edges;
+    std::vector<VertexId> seeds;
+    const char *home_dir;
+    std::string home_directory;
+
+    void SetUp() override {
+        home_dir = getenv("HOME");
+        home_directory = std::string(home_dir);
+        std::string test_data = home_directory + "/econ_project/src/proj23_03_tracebility/cpp/uni_directional_implementation/test_data/";
+
+        load_transfer_chunks({test_data + "test_build_graph3_000000000000"}, interner, edges);
+        seeds = read_kyc_addr(test_data + "test_kyc.csv", interner);
+    }
+
+    // Straightforward power iteration pushing along the raw transfer list, repeated pairs and all
+    static std::vector<double> reference_pagerank(size_t n, const std::vector<TransferEdge> &edges, const std::vector<VertexId> &seeds, double damping, int iterations) {
+        std::vector<double> out_weight(n, 0.0);
+        for (const TransferEdge &edge : edges) {
+            out_weight[edge.src] += edge.total_transfer_usd;
+        }
+        std::vector<double> scores(n, 0.0);
+        for (const VertexId seed : seeds) {
+            scores[seed] = 1.0 / seeds.size();
+        }
+        for (int iteration = 0; iteration < iterations; ++iteration) {
+            std::vector<double> next(n, 0.0);
+            double dangling = 0.0;
+            for (size_t v = 0; v < n; ++v) {
+                if (out_weight[v] == 0.0) {
+                    dangling += scores[v];
+                }
+            }
+            for (const TransferEdge &edge : edges) {
+                next[edge.dst] += damping * scores[edge.src] * edge.total_transfer_usd / out_weight[edge.src];
+            }
+            for (const VertexId seed : seeds) {
+                next[seed] += ((1.0 - damping) + damping * dangling) / seeds.size();
+            }
+            scores.swap(next);
+        }
+        return scores;
+    }
+};
+
+TEST_F(RiskPropagationTest, MatchesReferenceImplementation) {
+    const CSRGraph graph = build_csr_graph(interner.size(), edges);
+    std::vector<double> scores;
+    std::vector<PageRankIterationStats> stats = personalized_pagerank(graph, transpose_csr_graph(graph), seeds, scores, 0.85, 1e-15, 1000);
+    ASSERT_FALSE(stats.empty());
+    EXPECT_LT(stats.back().residual, 1e-15);
+
+    std::vector<VertexId> unique_seeds(seeds);
+    std::sort(unique_seeds.begin(), unique_seeds.end());
+    unique_seeds.erase(std::unique(unique_seeds.begin(), unique_seeds.end()), unique_seeds.end());
+    const std::vector<double> expected = reference_pagerank(interner.size(), edges, unique_seeds, 0.85, 1000);
+    ASSERT_EQ(scores.size(), expected.size());
+    double total = 0.0;
+    for (size_t v = 0; v < scores.size(); ++v) {
+        EXPECT_NEAR(scores[v], expected[v], 1e-12) << "vertex " << v;
+        total += scores[v];
+    }
+    EXPECT_NEAR(total, 1.0, 1e-12);
+}
+
+TEST_F(RiskPropagationTest, HandComputedScores) {
+    // The seed sends 3 to vertex 1 and 1 to vertex 2, neither sends anything on
+    const CSRGraph graph = build_csr_graph(3, {{0, 1, 3.0f}, {0, 2, 1.0f}});
+    std::vector<double> scores;
+    personalized_pagerank(graph, transpose_csr_graph(graph), {0}, scores, 0.5, 1e-15, 1000);
+    ASSERT_EQ(scores.size(), 3);
+    EXPECT_NEAR(scores[0], 2.0 / 3.0, 1e-12);
+    EXPECT_NEAR(scores[1], 1.0 / 4.0, 1e-12);
+    EXPECT_NEAR(scores[2], 1.0 / 12.0, 1e-12);
+}
+
+TEST_F(RiskPropagationTest, UnweightedGraphCountsEveryTransferOnce) {
+    CSRGraph graph = build_csr_graph(interner.size(), edges);
+    CSRGraph unweighted = graph;
+    unweighted.weights.clear();
+    std::fill(graph.weights.begin(), graph.weights.end(), 1.0f);
+    std::vector<double> expected, scores;
+    personalized_pagerank(graph, transpose_csr_graph(graph), seeds, expected, 0.85, 1e-15, 1000);
+    personalized_pagerank(unweighted, transpose_csr_graph(unweighted), seeds, scores, 0.85, 1e-15, 1000);
+    ASSERT_EQ(scores.size(), expected.size());
+    for (size_t v = 0; v < scores.size(); ++v) {
+        EXPECT_NEAR(scores[v], expected[v], 1e-12) << "vertex " << v;
+    }
+}
+
+TEST_F(RiskPropagationTest, StopsAtMaxIterationsOrWithoutSeeds) {
+    const CSRGraph graph = build_csr_graph(interner.size(), edges);
+    const CSRGraph reverse = transpose_csr_graph(graph);
+    std::vector<double> scores;
+    EXPECT_EQ(personalized_pagerank(graph, reverse, seeds, scores, 0.85, 0.0, 3).size(), 3);
+
+    EXPECT_TRUE(personalized_pagerank(graph, reverse, {}, scores, 0.85, 1e-9, 100).empty());
+    EXPECT_EQ(scores, std::vector<double>(interner.size(), 0.0));
+}
@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+#include "rmat_generator.hpp"
+#include "chunk_loader.hpp"
+
+class RMATGeneratorTest : public ::testing::Test {
+protected:
+    RMATParams params;
+    std::string base;
+    std::vector<std::string> chunk_files;
+
+    void SetUp() override {
+        params.scale = 10;
+        params.edge_factor = 8;
+        params.hot_wallets = 4;
+        params.hot_wallet_share = 0.1;
+        params.lines_per_chunk = 3000;
+        base = ::testing::TempDir() + "rmat_chunk_";
+    }
+
+    void TearDown() override {
+        for (const std::string &chunk_file : chunk_files) {
+            std::remove(chunk_file.c_str());
+        }
+        std::remove((base + "kyc.csv").c_str());
+    }
+
+    std::string read_file(const std::string &filename) {
+        std::ifstream input(filename);
+        std::stringstream content;
+        content << input.rdbuf();
+        return content.str();
+    }
+};
+
+TEST_F(RMATGeneratorTest, ChunksInTransferFormat) {
+    chunk_files = write_rmat_chunks(base, params);
+    // 8192 transfers in chunks of 3000
+    ASSERT_EQ(chunk_files.size(), 3);
+    EXPECT_EQ(find_chunk_files(base), chunk_files);
+
+    std::ifstream chunk(chunk_files[0]);
+    std::string line;
+    std::getline(chunk, line);
+    EXPECT_EQ(line, "address1,address2,total_transfer_usd");
+    size_t lines = 0;
+    size_t dust = 0;
+    while (std::getline(chunk, line)) {
+        TransferFields fields;
+        ASSERT_TRUE(parse_transfer_line(line.data(), line.data() + line.size(), fields)) << line;
+        AddressKey key;
+        EXPECT_TRUE(parse_address_key(fields.address1, fields.address1_length, key));
+        EXPECT_TRUE(parse_address_key(fields.address2, fields.address2_length, key));
+        EXPECT_GE(fields.total_transfer_usd, 1.0f);
+        EXPECT_LE(fields.total_transfer_usd, 100000.0f);
+        dust += fields.total_transfer_usd < 10.0f;
+        ++lines;
+    }
+    EXPECT_EQ(lines, 3000);
+    // log-uniform amounts: a fifth of them are under the dust filter
+    EXPECT_NEAR(static_cast<double>(dust) / lines, 0.2, 0.05);
+}
+
+TEST_F(RMATGeneratorTest, Deterministic) {
+    chunk_files = write_rmat_chunks(base, params);
+    const std::string first = read_file(chunk_files[1]);
+    write_rmat_chunks(base, params);
+    EXPECT_EQ(read_file(chunk_files[1]), first);
+    params.seed = 2;
+    write_rmat_chunks(base, params);
+    EXPECT_NE(read_file(chunk_files[1]), first);
+    EXPECT_EQ(rmat_address(5, 1), rmat_address(5, 1));
+    EXPECT_NE(rmat_address(5, 1), rmat_address(6, 1));
+}
+
+TEST_F(RMATGeneratorTest, SkewedDegrees) {
+    chunk_files = write_rmat_chunks(base, params);
+    AddressInterner interner;
+    CSRGraph graph, reverse;
+    build_graph_from_chunks(chunk_files, graph, reverse, interner);
+    EXPECT_LE(num_vertices(graph), size_t(1) << params.scale);
+
+    // Every hot wallet takes part in about hot_wallet_share / hot_wallets of the transfers
+    VertexId hot_wallet;
+    ASSERT_TRUE(interner.find(rmat_address(0, params.seed), hot_wallet));
+    const uint64_t hot_degree = out_degree(hot_wallet, graph) + out_degree(hot_wallet, reverse);
+    const double average_degree = 2.0 * num_edges(graph) / num_vertices(graph);
+    // Degrees count distinct counterparts; at this scale many hot wallet transfers repeat a pair
+    EXPECT_GT(hot_degree, 5 * average_degree);
+
+    EXPECT_EQ(write_rmat_kyc(base + "kyc.csv", params, 64), 4 + (1024 - 4 + 63) / 64);
+    std::vector<VertexId> seeds = read_kyc_addr(base + "kyc.csv", interner);
+    EXPECT_GT(seeds.size(), 4);
+}
@@ -0,0 +1,100 @@
+#include "gtest/gtest.h"
+#include "semi_external_bfs.hpp"
+#include "chunk_loader.hpp"
+
+class SemiExternalBFSTest : public ::testing::Test {
+protected:
+    CSRGraph graph, reverse;
+    AddressInterner interner;
+    std::vector<std::string> chunk_files;
+    std::vector<VertexId> seeds;
+    std::string partitions_filename;
+    const char *home_dir;
+    std::string home_directory;
+
+    void SetUp() override {
+        home_dir = getenv("HOME");
+        home_directory = std::string(home_dir);
+        std::string test_data = home_directory + "/econ_project/src/proj23_03_tracebility/cpp/uni_directional_implementation/test_data/";
+
+        chunk_files = find_chunk_files(test_data + "test_build_graph3_");
+        build_graph_from_chunks(chunk_files, graph, reverse, interner);
+        seeds = read_kyc_addr(test_data + "test_kyc.csv", interner);
+        partitions_filename = ::testing::TempDir() + "test_graph.partitions";
+        // A few vertices per partition, so every level touches several of them
+        write_edge_partitions(partitions_filename, graph, interner, fingerprint_chunks(chunk_files), 64);
+    }
+
+    void TearDown() override {
+        std::remove(partitions_filename.c_str());
+    }
+};
+
+TEST_F(SemiExternalBFSTest, PartitionsCoverTheGraph) {
+    PartitionedGraph partitioned;
+    AddressInterner loaded_interner;
+    ASSERT_TRUE(partitioned.open(partitions_filename, fingerprint_chunks(chunk_files), 0, loaded_interner));
+    EXPECT_EQ(partitioned.num_vertices(), num_vertices(graph));
+    EXPECT_EQ(partitioned.num_edges(), num_edges(graph));
+    EXPECT_GT(partitioned.partitions().size(), 2);
+    EXPECT_EQ(partitioned.num_resident(), 0);
+
+    std::vector<uint64_t> buffer;
+    for (size_t p = 0; p < partitioned.partitions().size(); ++p) {
+        const EdgePartition &partition = partitioned.partitions()[p];
+        partitioned.read_partition(p, buffer);
+        const VertexId *neighbors = reinterpret_cast<const VertexId *>(buffer.data() + partition.num_vertices + 1);
+        for (uint64_t i = 0; i < partition.num_vertices; ++i) {
+            const VertexId v = static_cast<VertexId>(partition.first_vertex + i);
+            EXPECT_EQ(std::vector<VertexId>(neighbors + buffer[i], neighbors + buffer[i + 1]),
+                      std::vector<VertexId>(graph.neighbors.begin() + graph.offsets[v], graph.neighbors.begin() + graph.offsets[v + 1]));
+        }
+    }
+
+    ASSERT_EQ(loaded_interner.size(), interner.size());
+    for (VertexId id = 0; id < interner.size(); ++id) {
+        EXPECT_EQ(loaded_interner.address(id), interner.address(id));
+    }
+}
+
+TEST_F(SemiExternalBFSTest, SameDistancesForEveryBudget) {
+    std::vector<uint8_t> expected;
+    bfs_direction_optimizing(graph, reverse, seeds, 5, expected);
+    for (uint64_t budget : {uint64_t(0), uint64_t(512), uint64_t(1) << 30}) {
+        PartitionedGraph partitioned;
+        AddressInterner loaded_interner;
+        ASSERT_TRUE(partitioned.open(partitions_filename, fingerprint_chunks(chunk_files), budget, loaded_interner));
+        std::vector<uint8_t> hops;
+        std::vector<BFSLevelStats> stats = bfs_semi_external(partitioned, seeds, 5, hops);
+        EXPECT_EQ(hops, expected) << "budget " << budget;
+        EXPECT_FALSE(stats.empty());
+        if (budget >= num_edges(graph) * 64) {
+            EXPECT_EQ(partitioned.num_resident(), partitioned.partitions().size());
+        }
+    }
+}
+
+TEST_F(SemiExternalBFSTest, UntouchedPartitionsAreNotRead) {
+    PartitionedGraph partitioned;
+    AddressInterner loaded_interner;
+    ASSERT_TRUE(partitioned.open(partitions_filename, fingerprint_chunks(chunk_files), 0, loaded_interner));
+    std::vector<uint8_t> hops;
+    // A single level from one seed reads only the seed's partition
+    bfs_semi_external(partitioned, {seeds.front()}, 1, hops);
+    uint64_t seed_partition_bytes = 0;
+    for (const EdgePartition &partition : partitioned.partitions()) {
+        if (seeds.front() >= partition.first_vertex && seeds.front() < partition.first_vertex + partition.num_vertices) {
+            seed_partition_bytes = partition.bytes();
+        }
+    }
+    EXPECT_EQ(partitioned.bytes_read(), seed_partition_bytes);
+}
+
+TEST_F(SemiExternalBFSTest, StaleChunkListIsRejected) {
+    std::vector<ChunkFingerprint> chunks = fingerprint_chunks(chunk_files);
+    chunks[0].size += 1;
+    PartitionedGraph partitioned;
+    AddressInterner loaded_interner;
+    EXPECT_FALSE(partitioned.open(partitions_filename, chunks, 0, loaded_interner));
+    EXPECT_FALSE(partitioned.open(partitions_filename + ".missing", fingerprint_chunks(chunk_files), 0, loaded_interner));
+}
@@ -0,0 +1,108 @@
+#include "gtest/gtest.h"
+#include "vertex_order.hpp"
+#include "parallel_bfs.hpp"
+
+// A weighted path 0 -> 1 -> ... -> 9, a hub 10 with edges to every even vertex, and vertex 11
+// with no edges at all
+class VertexOrderTest : public ::testing::Test {
+protected:
+    CSRGraph graph, reverse;
+
+    void SetUp() override {
+        const size_t n = 12;
+        std::vector<std::vector<std::pair<VertexId, float>>> lists(n);
+        for (VertexId v = 0; v + 1 < 10; ++v) {
+            lists[v].push_back({v + 1, 100.0f + v});
+        }
+        for (VertexId v = 0; v < 10; v += 2) {
+            lists[10].push_back({v, 50.0f});
+        }
+        graph.offsets.push_back(0);
+        for (const auto &list : lists) {
+            for (const auto &edge : list) {
+                graph.neighbors.push_back(edge.first);
+                graph.weights.push_back(edge.second);
+            }
+            graph.offsets.push_back(graph.neighbors.size());
+        }
+        reverse = transpose_csr_graph(graph);
+    }
+
+    void expect_permutation(const std::vector<VertexId> &new_id) {
+        ASSERT_EQ(new_id.size(), num_vertices(graph));
+        std::vector<VertexId> sorted = new_id;
+        std::sort(sorted.begin(), sorted.end());
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            EXPECT_EQ(sorted[i], i);
+        }
+    }
+};
+
+TEST_F(VertexOrderTest, ParseNames) {
+    VertexOrdering ordering;
+    for (const char *name : {"original", "degree", "bfs", "rcm"}) {
+        ASSERT_TRUE(parse_vertex_ordering(name, ordering));
+        EXPECT_STREQ(vertex_ordering_name(ordering), name);
+    }
+    EXPECT_FALSE(parse_vertex_ordering("rabbit", ordering));
+}
+
+TEST_F(VertexOrderTest, EveryOrderingIsAPermutation) {
+    for (VertexOrdering ordering : {VertexOrdering::Original, VertexOrdering::Degree, VertexOrdering::BFS, VertexOrdering::RCM}) {
+        expect_permutation(compute_vertex_order(graph, reverse, {0}, ordering));
+    }
+    std::vector<VertexId> identity = compute_vertex_order(graph, reverse, {0}, VertexOrdering::Original);
+    for (size_t v = 0; v < identity.size(); ++v) {
+        EXPECT_EQ(identity[v], v);
+    }
+}
+
+TEST_F(VertexOrderTest, DegreeOrderPutsHubFirst) {
+    std::vector<VertexId> new_id = compute_vertex_order(graph, reverse, {}, VertexOrdering::Degree);
+    EXPECT_EQ(new_id[10], 0);
+    // The isolated vertex comes last
+    EXPECT_EQ(new_id[11], 11);
+}
+
+TEST_F(VertexOrderTest, BFSOrderStartsAtSeeds) {
+    std::vector<VertexId> new_id = compute_vertex_order(graph, reverse, {5}, VertexOrdering::BFS);
+    EXPECT_EQ(new_id[5], 0);
+    // Neighbors of the seed come right after it
+    EXPECT_LT(new_id[4], 4);
+    EXPECT_LT(new_id[6], 4);
+    EXPECT_EQ(new_id[11], 11);
+}
+
+TEST_F(VertexOrderTest, RelabeledGraphKeepsEdgesAndWeights) {
+    std::vector<VertexId> new_id = compute_vertex_order(graph, reverse, {0}, VertexOrdering::RCM);
+    CSRGraph relabeled = relabel_csr_graph(graph, new_id);
+    ASSERT_EQ(num_edges(relabeled), num_edges(graph));
+    for (VertexId v = 0; v < num_vertices(graph); ++v) {
+        const VertexId nv = new_id[v];
+        ASSERT_EQ(out_degree(nv, relabeled), out_degree(v, graph));
+        for (uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+            const auto begin = relabeled.neighbors.begin() + relabeled.offsets[nv];
+            const auto end = relabeled.neighbors.begin() + relabeled.offsets[nv + 1];
+            auto it = std::find(begin, end, new_id[graph.neighbors[e]]);
+            ASSERT_NE(it, end);
+            EXPECT_EQ(relabeled.weights[it - relabeled.neighbors.begin()], graph.weights[e]);
+        }
+        // Lists stay sorted by descending weight
+        for (uint64_t e = relabeled.offsets[nv] + 1; e < relabeled.offsets[nv + 1]; ++e) {
+            EXPECT_GE(relabeled.weights[e - 1], relabeled.weights[e]);
+        }
+    }
+}
+
+TEST_F(VertexOrderTest, BFSResultUnchangedByOrdering) {
+    std::vector<uint8_t> expected;
+    bfs_direction_optimizing(graph, reverse, {10}, 5, expected);
+    for (VertexOrdering ordering : {VertexOrdering::Degree, VertexOrdering::BFS, VertexOrdering::RCM}) {
+        std::vector<VertexId> new_id = compute_vertex_order(graph, reverse, {10}, ordering);
+        CSRGraph relabeled = relabel_csr_graph(graph, new_id);
+        CSRGraph relabeled_reverse = relabel_csr_graph(reverse, new_id);
+        std::vector<uint8_t> hops;
+        bfs_direction_optimizing(relabeled, relabeled_reverse, relabel_vertices({10}, new_id), 5, hops);
+        EXPECT_EQ(to_original_order(hops, new_id), expected) << vertex_ordering_name(ordering);
+    }
+}